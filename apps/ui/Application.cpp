@@ -425,7 +425,7 @@ void Application::render()
 
         if (renderDone)
         {
-            frameBuffer->map();
+            const auto snapshot = frameBuffer->getSnapshot();
 
             GLenum type = GL_FLOAT;
             const GLvoid* buffer = 0;
@@ -433,20 +433,19 @@ void Application::render()
             {
             case FrameBufferMode::COLOR:
                 type = GL_UNSIGNED_BYTE;
-                buffer = frameBuffer->getColorBuffer();
+                buffer = snapshot->colorBuffer;
                 break;
             case FrameBufferMode::DEPTH:
                 format = GL_LUMINANCE;
-                buffer = frameBuffer->getDepthBuffer();
+                buffer = snapshot->depthBuffer;
                 break;
             default:
                 glClearColor(0.f, 0.f, 0.f, 1.f);
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
             }
 
-            glTexImage2D(GL_TEXTURE_2D, 0, format, frameBuffer->getSize().x,
-                         frameBuffer->getSize().y, 0, format, type, buffer);
-            frameBuffer->unmap();
+            glTexImage2D(GL_TEXTURE_2D, 0, format, snapshot->size.x,
+                         snapshot->size.y, 0, format, type, buffer);
         }
 
         glBegin(GL_QUADS);
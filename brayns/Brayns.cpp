@@ -23,12 +23,14 @@
 #include "EngineFactory.h"
 #include "PluginManager.h"
 
+#include <brayns/common/AdaptiveSubsampling.h>
 #include <brayns/common/PropertyMap.h>
 #include <brayns/common/Timer.h>
 #include <brayns/common/input/KeyboardHandler.h>
 #include <brayns/common/light/Light.h>
 #include <brayns/common/log.h>
 #include <brayns/common/mathTypes.h>
+#include <brayns/common/simulation/AbstractSimulationHandler.h>
 #include <brayns/common/utils/DynamicLib.h>
 #include <brayns/common/utils/stringUtils.h>
 
@@ -62,6 +64,10 @@ namespace
 {
 const float DEFAULT_MOTION_ACCELERATION = 1.5f;
 
+// Frame rate of interactive frames with adaptive subsampling if the max render
+// FPS is unlimited
+constexpr double DEFAULT_INTERACTIVE_FPS = 30.;
+
 const brayns::Vector3f DEFAULT_SUN_DIRECTION = {1.f, -1.f, -1.f};
 const brayns::Vector3f DEFAULT_SUN_COLOR = {0.9f, 0.9f, 0.9f};
 constexpr double DEFAULT_SUN_ANGULAR_DIAMETER = 0.53;
@@ -154,6 +160,7 @@ struct Brayns::Impl : public PluginAPI
         scene.commit();
 
         _engine->getStatistics().setSceneSizeInBytes(scene.getSizeInBytes());
+        _updateSimulationStatistics(scene);
 
         _parametersManager.getAnimationParameters().update();
 
@@ -174,6 +181,10 @@ struct Brayns::Impl : public PluginAPI
 
         _engine->preRender();
 
+        if (rp.getAdaptiveSubsampling())
+            for (auto frameBuffer : _engine->getFrameBuffers())
+                frameBuffer->setSubsampling(_adaptiveSubsampling.getFactor());
+
         camera.commit();
 
         _engine->commit();
@@ -202,6 +213,7 @@ struct Brayns::Impl : public PluginAPI
         _engine->render();
         _renderTimer.stop();
         _lastFPS = _renderTimer.perSecondSmoothed();
+        _updateAdaptiveSubsampling();
 
         const auto& params = _parametersManager.getApplicationParameters();
         const auto fps = params.getMaxRenderFPS();
@@ -216,12 +228,25 @@ struct Brayns::Impl : public PluginAPI
 
     void postRender(RenderOutput* output)
     {
+        // Map the frame buffers once for all the consumers of this frame, i.e.
+        // the render output and the plugins
+        std::vector<FrameBufferSnapshotPtr> snapshots;
+        for (auto frameBuffer : _engine->getFrameBuffers())
+            snapshots.push_back(frameBuffer->getSnapshot());
+
         if (output)
-            _updateRenderOutput(*output);
+            _updateRenderOutput(*output, *snapshots[0]);
 
-        _engine->getStatistics().setFPS(_lastFPS);
+        auto& statistics = _engine->getStatistics();
+        statistics.setFPS(_lastFPS);
+        // The renderer reports an infinite variance until it can be estimated
+        statistics.setVariance(
+            std::min<double>(_engine->getRenderer().getVariance(),
+                             std::numeric_limits<float>::max()));
+        statistics.setConverged(_engine->isConverged());
 
         _pluginManager.postRender();
+        snapshots.clear();
 
         _engine->postRender();
 
@@ -239,30 +264,27 @@ struct Brayns::Impl : public PluginAPI
         return commit();
     }
 
-    void _updateRenderOutput(RenderOutput& renderOutput)
+    void _updateRenderOutput(RenderOutput& renderOutput,
+                             const FrameBufferSnapshot& snapshot)
     {
-        FrameBuffer& frameBuffer = _engine->getFrameBuffer();
-        frameBuffer.map();
-        const Vector2i& frameSize = frameBuffer.getSize();
-        const auto colorBuffer = frameBuffer.getColorBuffer();
+        // The output outlives the frame, so it keeps a copy of the pixels
+        const auto colorBuffer = snapshot.colorBuffer;
         if (colorBuffer)
         {
-            const size_t size =
-                frameSize.x * frameSize.y * frameBuffer.getColorDepth();
-            renderOutput.colorBuffer.assign(colorBuffer, colorBuffer + size);
-            renderOutput.colorBufferFormat = frameBuffer.getFrameBufferFormat();
+            renderOutput.colorBuffer.assign(colorBuffer,
+                                            colorBuffer +
+                                                snapshot.getColorBufferSize());
+            renderOutput.colorBufferFormat = snapshot.format;
         }
 
-        const auto depthBuffer = frameBuffer.getDepthBuffer();
+        const auto depthBuffer = snapshot.depthBuffer;
         if (depthBuffer)
         {
-            const size_t size = frameSize.x * frameSize.y;
+            const size_t size = size_t(snapshot.size.x) * snapshot.size.y;
             renderOutput.depthBuffer.assign(depthBuffer, depthBuffer + size);
         }
 
-        renderOutput.frameSize = frameSize;
-
-        frameBuffer.unmap();
+        renderOutput.frameSize = Vector2i(snapshot.size);
     }
 
     Engine& getEngine() final { return *_engine; }
@@ -289,6 +311,52 @@ struct Brayns::Impl : public PluginAPI
     Scene& getScene() final { return _engine->getScene(); }
 
 private:
+    void _updateAdaptiveSubsampling()
+    {
+        const auto& rp = _parametersManager.getRenderingParameters();
+        if (!rp.getAdaptiveSubsampling())
+            return;
+
+        // Only the frames following a change are subsampled, later ones
+        // refine the image at full resolution
+        const auto& frameBuffer = _engine->getFrameBuffer();
+        if (frameBuffer.numAccumFrames() > 0)
+            return;
+
+        const auto fullSize = frameBuffer.getFrameSize();
+        const auto size = frameBuffer.getSize();
+        if (size.x == 0 || size.y == 0)
+            return;
+
+        const auto fps = _parametersManager.getApplicationParameters()
+                             .getMaxRenderFPS();
+        const double targetFPS =
+            fps == std::numeric_limits<size_t>::max() ? DEFAULT_INTERACTIVE_FPS
+                                                       : fps;
+        _adaptiveSubsampling.setTargetTime(1000. / targetFPS);
+        _adaptiveSubsampling.setMaxFactor(rp.getMaxAdaptiveSubsampling());
+        _adaptiveSubsampling.update(_renderTimer.microseconds() / 1000.,
+                                    double(fullSize.x) * fullSize.y /
+                                        (double(size.x) * size.y));
+    }
+
+    void _updateSimulationStatistics(Scene& scene)
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        scene.visitModels([&hits, &misses](Model& model) {
+            if (const auto handler = model.getSimulationHandler())
+            {
+                hits += handler->getPrefetchHits();
+                misses += handler->getPrefetchMisses();
+            }
+        });
+
+        auto& statistics = _engine->getStatistics();
+        statistics.setSimulationPrefetchHits(hits);
+        statistics.setSimulationPrefetchMisses(misses);
+    }
+
     void _createEngine()
     {
         auto engineName =
@@ -789,6 +857,7 @@ private:
     std::mutex _renderMutex;
 
     Timer _renderTimer;
+    AdaptiveSubsampling _adaptiveSubsampling;
     std::atomic<double> _lastFPS;
 
     std::shared_ptr<ActionInterface> _actionInterface;
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <brayns/common/tasks/Task.h>
 #include <brayns/common/types.h>
 
 #include <functional>
@@ -139,16 +140,61 @@ public:
         _registerRequest(name, [action] { return to_json(action()); });
     }
 
+    /**
+     * Register an asynchronous action with a parameter and a return value. For
+     * each incoming request, a functor derived from TaskFunctor is created from
+     * the parameter and executed in a Task, which reports its progress to the
+     * client and can be cancelled by it.
+     *
+     * @param desc description of the action/RPC
+     * @param input the property map layout of the parameter, for the schema
+     * @param output the property map layout of the result, for the schema
+     * @param createFunctor creates the functor for an incoming request
+     */
+    template <typename Params, typename Functor>
+    void registerTask(const RpcParameterDescription& desc,
+                      const PropertyMap& input, const PropertyMap& output,
+                      const std::function<Functor(Params)>& createFunctor)
+    {
+        _registerTask(desc, input, output,
+                      [createFunctor](const std::string& param) {
+                          Params params;
+                          if (!from_json(params, param))
+                              throw std::runtime_error("from_json failed");
+                          return std::make_shared<Task<std::string>>(
+                              JSONFunctor<Functor>(createFunctor(params)));
+                      });
+    }
+
 protected:
     using RetParamFunc = std::function<std::string(std::string)>;
     using RetFunc = std::function<std::string()>;
     using ParamFunc = std::function<void(std::string)>;
     using VoidFunc = std::function<void()>;
+    using TaskFunc =
+        std::function<std::shared_ptr<Task<std::string>>(std::string)>;
 
 private:
+    /** Task functor which returns the result of Functor as JSON. */
+    template <typename Functor>
+    struct JSONFunctor : public Functor
+    {
+        JSONFunctor(Functor&& functor)
+            : Functor(std::move(functor))
+        {
+        }
+
+        std::string operator()() { return to_json(Functor::operator()()); }
+    };
+
     virtual void _registerRequest(const std::string&, const RetParamFunc&) {}
     virtual void _registerRequest(const std::string&, const RetFunc&) {}
     virtual void _registerNotification(const std::string&, const ParamFunc&) {}
     virtual void _registerNotification(const std::string&, const VoidFunc&) {}
+    virtual void _registerTask(const RpcParameterDescription&,
+                               const PropertyMap&, const PropertyMap&,
+                               const TaskFunc&)
+    {
+    }
 };
 }
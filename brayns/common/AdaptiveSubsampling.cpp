@@ -0,0 +1,72 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "AdaptiveSubsampling.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Weight of the previous estimate when a frame is faster than expected
+constexpr double SMOOTHING = 0.8;
+// Fraction of the target time a lower factor must fit in to be used
+constexpr double HYSTERESIS = 0.75;
+
+size_t factorFor(const double fullFrameTime, const double targetTime)
+{
+    return static_cast<size_t>(
+        std::ceil(std::sqrt(fullFrameTime / targetTime)));
+}
+}
+
+namespace brayns
+{
+void AdaptiveSubsampling::setTargetTime(const double milliseconds)
+{
+    _targetTime = std::max(milliseconds, 1.);
+}
+
+void AdaptiveSubsampling::setMaxFactor(const size_t factor)
+{
+    _maxFactor = std::max(factor, size_t(1));
+    _factor = std::min(_factor, _maxFactor);
+}
+
+void AdaptiveSubsampling::update(const double milliseconds,
+                                 const double pixelRatio)
+{
+    // The rendering time is roughly proportional to the number of pixels
+    const double fullFrameTime = milliseconds * std::max(pixelRatio, 1.);
+    if (fullFrameTime > _fullFrameTime)
+        _fullFrameTime = fullFrameTime;
+    else
+        _fullFrameTime =
+            SMOOTHING * _fullFrameTime + (1. - SMOOTHING) * fullFrameTime;
+
+    // The factor divides both dimensions of the frame
+    const auto factor = factorFor(_fullFrameTime, _targetTime);
+    const auto lowerFactor =
+        factorFor(_fullFrameTime, HYSTERESIS * _targetTime);
+    if (factor > _factor)
+        _factor = factor;
+    else if (lowerFactor < _factor)
+        _factor = lowerFactor;
+    _factor = std::max(std::min(_factor, _maxFactor), size_t(1));
+}
+}
@@ -0,0 +1,60 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace brayns
+{
+/**
+ * Chooses the subsampling factor of interactive frames, i.e. the frames
+ * rendered right after a change of the camera or the scene, so that they are
+ * rendered within a target time. The cost of a frame at full resolution is
+ * estimated from the last interactive frames; it follows slower frames
+ * immediately and faster ones gradually, and the factor is only lowered once
+ * the lower factor is expected to fit well within the target time.
+ */
+class AdaptiveSubsampling
+{
+public:
+    /** Set the time in milliseconds an interactive frame should take. */
+    void setTargetTime(double milliseconds);
+
+    /** Set the highest subsampling factor that may be used. */
+    void setMaxFactor(size_t factor);
+
+    /**
+     * Account for the rendering of an interactive frame.
+     *
+     * @param milliseconds the time spent rendering the frame
+     * @param pixelRatio the number of pixels of the frame at full resolution
+     *                   divided by the number of pixels actually rendered
+     */
+    void update(double milliseconds, double pixelRatio);
+
+    /** @return the subsampling factor for the next interactive frames. */
+    size_t getFactor() const { return _factor; }
+
+private:
+    double _targetTime{1000. / 30.};
+    size_t _maxFactor{1};
+    size_t _factor{1};
+    double _fullFrameTime{0.};
+};
+}
@@ -38,10 +38,45 @@ public:
     {
         _updateValue(_sceneSizeInBytes, sceneSizeInBytes);
     }
+    /** Simulation frames that were prefetched before being requested. */
+    uint64_t getSimulationPrefetchHits() const
+    {
+        return _simulationPrefetchHits;
+    }
+    void setSimulationPrefetchHits(const uint64_t hits)
+    {
+        _updateValue(_simulationPrefetchHits, hits);
+    }
+    /** Simulation frames that had to be loaded when requested. */
+    uint64_t getSimulationPrefetchMisses() const
+    {
+        return _simulationPrefetchMisses;
+    }
+    void setSimulationPrefetchMisses(const uint64_t misses)
+    {
+        _updateValue(_simulationPrefetchMisses, misses);
+    }
+
+    /** Variance of the image from the last frame, i.e. its remaining noise. */
+    double getVariance() const { return _variance; }
+    void setVariance(const double variance)
+    {
+        _updateValue(_variance, variance);
+    }
+    /** If accumulation stopped because the variance threshold was reached. */
+    bool getConverged() const { return _converged; }
+    void setConverged(const bool converged)
+    {
+        _updateValue(_converged, converged);
+    }
 
 private:
     double _fps{0.0};
     size_t _sceneSizeInBytes{0};
+    uint64_t _simulationPrefetchHits{0};
+    uint64_t _simulationPrefetchMisses{0};
+    double _variance{0.0};
+    bool _converged{false};
 
     SERIALIZATION_FRIEND(Statistics)
 };
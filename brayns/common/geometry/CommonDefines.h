@@ -22,9 +22,13 @@
 #include <brayns/common/types.h>
 #define VEC3_TYPE brayns::Vector3f
 #define UINT64_T uint64_t
+#define UINT32_T uint32_t
+#define UINT16_T uint16_t
 #endif
 
 #if ISPC
 #define VEC3_TYPE vec3f
 #define UINT64_T unsigned int64
+#define UINT32_T unsigned int32
+#define UINT16_T unsigned int16
 #endif
@@ -0,0 +1,202 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "CompactGeometry.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace brayns
+{
+namespace
+{
+constexpr float QUANTIZATION_STEPS = 65535.f;
+
+template <typename T>
+CompactGeometries<T> _createCompactGeometries(const Boxd& bounds,
+                                              const size_t size)
+{
+    CompactGeometries<T> compact;
+    compact.bounds = bounds;
+    compact.primitives.reserve(size);
+    if (bounds.isEmpty())
+        return compact;
+
+    compact.origin = Vector3f(bounds.getMin());
+    const auto extent = bounds.getSize();
+    const double maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+    if (maxExtent > 0.)
+        compact.scale = static_cast<float>(maxExtent / QUANTIZATION_STEPS);
+    return compact;
+}
+
+template <typename T>
+void _quantize(const CompactGeometries<T>& compact, const Vector3f& position,
+               uint16_t* quantized)
+{
+    const auto value = (position - compact.origin) / compact.scale;
+    for (size_t i = 0; i < 3; ++i)
+        quantized[i] = static_cast<uint16_t>(
+            std::min(std::max(std::round(value[i]), 0.f), QUANTIZATION_STEPS));
+}
+
+uint16_t _toHalf(const float value)
+{
+    return glm::packHalf1x16(value);
+}
+
+uint32_t _toUserData(const uint64_t userData)
+{
+    if (userData > std::numeric_limits<uint32_t>::max())
+        throw std::runtime_error("User data " + std::to_string(userData) +
+                                 " does not fit in the 32 bits of compact "
+                                 "geometry");
+    return static_cast<uint32_t>(userData);
+}
+} // namespace
+
+Vector3f decodePosition(const Vector3f& origin, const float scale,
+                        const uint16_t* position)
+{
+    return origin + Vector3f(position[0], position[1], position[2]) * scale;
+}
+
+float decodeRadius(const uint16_t radius)
+{
+    return glm::unpackHalf1x16(radius);
+}
+
+CompactSpheres compactSpheres(const Spheres& spheres)
+{
+    Boxd bounds;
+    for (const auto& sphere : spheres)
+    {
+        bounds.merge(sphere.center + sphere.radius);
+        bounds.merge(sphere.center - sphere.radius);
+    }
+
+    auto compact =
+        _createCompactGeometries<CompactSphere>(bounds, spheres.size());
+    for (const auto& sphere : spheres)
+    {
+        CompactSphere compactSphere;
+        compactSphere.userData = _toUserData(sphere.userData);
+        _quantize(compact, sphere.center, compactSphere.center);
+        compactSphere.radius = _toHalf(sphere.radius);
+        compact.primitives.push_back(compactSphere);
+    }
+    return compact;
+}
+
+Spheres expandSpheres(const CompactSpheres& spheres)
+{
+    Spheres expanded;
+    expanded.reserve(spheres.primitives.size());
+    for (const auto& sphere : spheres.primitives)
+    {
+        const auto center =
+            decodePosition(spheres.origin, spheres.scale, sphere.center);
+        expanded.emplace_back(center, decodeRadius(sphere.radius),
+                              sphere.userData);
+    }
+    return expanded;
+}
+
+CompactCylinders compactCylinders(const Cylinders& cylinders)
+{
+    Boxd bounds;
+    for (const auto& cylinder : cylinders)
+    {
+        bounds.merge(cylinder.center);
+        bounds.merge(cylinder.up);
+    }
+
+    auto compact =
+        _createCompactGeometries<CompactCylinder>(bounds, cylinders.size());
+    for (const auto& cylinder : cylinders)
+    {
+        CompactCylinder compactCylinder;
+        compactCylinder.userData = _toUserData(cylinder.userData);
+        _quantize(compact, cylinder.center, compactCylinder.center);
+        _quantize(compact, cylinder.up, compactCylinder.up);
+        compactCylinder.radius = _toHalf(cylinder.radius);
+        compactCylinder.padding = 0;
+        compact.primitives.push_back(compactCylinder);
+    }
+    return compact;
+}
+
+Cylinders expandCylinders(const CompactCylinders& cylinders)
+{
+    Cylinders expanded;
+    expanded.reserve(cylinders.primitives.size());
+    for (const auto& cylinder : cylinders.primitives)
+    {
+        const auto center =
+            decodePosition(cylinders.origin, cylinders.scale, cylinder.center);
+        const auto up =
+            decodePosition(cylinders.origin, cylinders.scale, cylinder.up);
+        expanded.emplace_back(center, up, decodeRadius(cylinder.radius),
+                              cylinder.userData);
+    }
+    return expanded;
+}
+
+CompactCones compactCones(const Cones& cones)
+{
+    Boxd bounds;
+    for (const auto& cone : cones)
+    {
+        bounds.merge(cone.center);
+        bounds.merge(cone.up);
+    }
+
+    auto compact = _createCompactGeometries<CompactCone>(bounds, cones.size());
+    for (const auto& cone : cones)
+    {
+        CompactCone compactCone;
+        compactCone.userData = _toUserData(cone.userData);
+        _quantize(compact, cone.center, compactCone.center);
+        _quantize(compact, cone.up, compactCone.up);
+        compactCone.centerRadius = _toHalf(cone.centerRadius);
+        compactCone.upRadius = _toHalf(cone.upRadius);
+        compact.primitives.push_back(compactCone);
+    }
+    return compact;
+}
+
+Cones expandCones(const CompactCones& cones)
+{
+    Cones expanded;
+    expanded.reserve(cones.primitives.size());
+    for (const auto& cone : cones.primitives)
+    {
+        const auto center =
+            decodePosition(cones.origin, cones.scale, cone.center);
+        const auto up = decodePosition(cones.origin, cones.scale, cone.up);
+        expanded.emplace_back(center, up, decodeRadius(cone.centerRadius),
+                              decodeRadius(cone.upRadius), cone.userData);
+    }
+    return expanded;
+}
+} // namespace brayns
@@ -0,0 +1,98 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include "CommonDefines.h"
+
+#if __cplusplus
+#include "Cone.h"
+#include "Cylinder.h"
+#include "Sphere.h"
+
+namespace brayns
+{
+#endif
+
+/*
+ * Compact counterparts of Sphere, Cylinder and Cone used by
+ * MemoryMode::compact. Positions are quantized to 16 bits relative to the
+ * origin and scale of their CompactGeometries, radii are stored as half
+ * floats and the user data is stored in 32 bits.
+ */
+
+struct CompactSphere
+{
+    UINT32_T userData;
+    UINT16_T center[3];
+    UINT16_T radius;
+};
+
+struct CompactCylinder
+{
+    UINT32_T userData;
+    UINT16_T center[3];
+    UINT16_T up[3];
+    UINT16_T radius;
+    UINT16_T padding;
+};
+
+struct CompactCone
+{
+    UINT32_T userData;
+    UINT16_T center[3];
+    UINT16_T up[3];
+    UINT16_T centerRadius;
+    UINT16_T upRadius;
+};
+
+#if __cplusplus
+/**
+ * The compact primitives of one material. A quantized position q is decoded
+ * as origin + q * scale.
+ */
+template <typename T>
+struct CompactGeometries
+{
+    Vector3f origin;
+    float scale{1.f};
+    /** Bounds of the primitives before quantization */
+    Boxd bounds;
+    std::vector<T> primitives;
+};
+
+/** @return the position of a compact primitive in model space */
+Vector3f decodePosition(const Vector3f& origin, float scale,
+                        const uint16_t* position);
+/** @return the radius of a compact primitive */
+float decodeRadius(uint16_t radius);
+
+/*
+ * Quantize full precision primitives, and restore them. The compact*()
+ * functions throw std::runtime_error if a user data does not fit in 32 bits.
+ */
+CompactSpheres compactSpheres(const Spheres& spheres);
+Spheres expandSpheres(const CompactSpheres& spheres);
+
+CompactCylinders compactCylinders(const Cylinders& cylinders);
+Cylinders expandCylinders(const CompactCylinders& cylinders);
+
+CompactCones compactCones(const Cones& cones);
+Cones expandCones(const CompactCones& cones);
+} // brayns
+#endif
@@ -19,9 +19,33 @@
 
 #include "AbstractSimulationHandler.h"
 
+#include <brayns/common/log.h>
+
 namespace brayns
 {
-AbstractSimulationHandler::~AbstractSimulationHandler() = default;
+namespace
+{
+const uint32_t NO_FRAME = std::numeric_limits<uint32_t>::max();
+
+bool isLoading(const std::future<void>& loading)
+{
+    return loading.valid() &&
+           loading.wait_for(std::chrono::milliseconds(0)) !=
+               std::future_status::ready;
+}
+}
+
+AbstractSimulationHandler::AbstractSimulationHandler(
+    const AbstractSimulationHandler& rhs)
+{
+    *this = rhs;
+}
+
+AbstractSimulationHandler::~AbstractSimulationHandler()
+{
+    // Pending loads write into the prefetch slots
+    _waitPrefetchedFrames();
+}
 
 AbstractSimulationHandler& AbstractSimulationHandler::operator=(
     const AbstractSimulationHandler& rhs)
@@ -35,6 +59,9 @@ AbstractSimulationHandler& AbstractSimulationHandler::operator=(
     _dt = rhs._dt;
     _unit = rhs._unit;
     _frameData = rhs._frameData;
+    _prefetchWindow = rhs._prefetchWindow;
+    _prefetchDelta = rhs._prefetchDelta;
+    _frameLoader = rhs._frameLoader;
 
     return *this;
 }
@@ -43,4 +70,167 @@ uint32_t AbstractSimulationHandler::_getBoundedFrame(const uint32_t frame) const
 {
     return _nbFrames == 0 ? frame : frame % _nbFrames;
 }
+
+void AbstractSimulationHandler::setPrefetchWindow(const uint32_t window,
+                                                  const int32_t delta)
+{
+    _prefetchWindow = window;
+    _prefetchDelta = delta == 0 ? 1 : delta;
+
+    // Slots are only ever added, and loads write into them by reference, so
+    // pending loads must be complete before the ring is reallocated
+    if (_prefetchSlots.size() < window + 1)
+    {
+        _waitPrefetchedFrames();
+        _prefetchSlots.resize(window + 1);
+    }
+}
+
+void AbstractSimulationHandler::waitReady() const
+{
+    for (const auto& slot : _prefetchSlots)
+        if (slot.frame == _lastRequestedFrame && slot.loading.valid())
+            slot.loading.wait();
+}
+
+void* AbstractSimulationHandler::_getPrefetchedFrameData(const uint32_t frame,
+                                                         const bool synchronous)
+{
+    if (frame == _currentFrame)
+        return _frameData.data();
+
+    if (_prefetchSlots.empty())
+        _prefetchSlots.resize(_prefetchWindow + 1);
+
+    auto slot = _findPrefetchSlot(frame);
+    if (frame != _lastRequestedFrame)
+    {
+        _lastRequestedFrame = frame;
+        if (slot && !isLoading(slot->loading))
+            ++_prefetchHits;
+        else
+            ++_prefetchMisses;
+    }
+
+    if (!slot)
+        slot = _loadIntoFreeSlot(frame, frame, true);
+
+    if (synchronous)
+        slot->loading.wait();
+    else if (isLoading(slot->loading))
+    {
+        _prefetch(frame);
+        return nullptr;
+    }
+
+    try
+    {
+        slot->loading.get();
+    }
+    catch (const std::exception& e)
+    {
+        BRAYNS_ERROR << "Error loading simulation frame " << frame << ": "
+                     << e.what() << std::endl;
+        slot->frame = NO_FRAME;
+        return nullptr;
+    }
+
+    // The previous frame buffer goes back to the ring for the next loads
+    std::swap(_frameData, slot->data);
+    slot->frame = NO_FRAME;
+    _currentFrame = frame;
+
+    _prefetch(frame);
+    return _frameData.data();
+}
+
+void AbstractSimulationHandler::_waitPrefetchedFrames() const
+{
+    for (const auto& slot : _prefetchSlots)
+        if (slot.loading.valid())
+            slot.loading.wait();
+}
+
+bool AbstractSimulationHandler::_isInPrefetchWindow(
+    const uint32_t frame, const uint32_t requestedFrame) const
+{
+    if (frame == NO_FRAME)
+        return false;
+
+    for (uint32_t i = 0; i <= _prefetchWindow; ++i)
+    {
+        const int64_t next =
+            int64_t(requestedFrame) + int64_t(i) * _prefetchDelta;
+        if (_nbFrames == 0 ? next == frame
+                           : (next % _nbFrames + _nbFrames) % _nbFrames ==
+                                 frame)
+            return true;
+    }
+    return false;
+}
+
+AbstractSimulationHandler::PrefetchSlot*
+    AbstractSimulationHandler::_findPrefetchSlot(const uint32_t frame)
+{
+    for (auto& slot : _prefetchSlots)
+        if (slot.frame == frame)
+            return &slot;
+    return nullptr;
+}
+
+AbstractSimulationHandler::PrefetchSlot*
+    AbstractSimulationHandler::_loadIntoFreeSlot(const uint32_t frame,
+                                                 const uint32_t requestedFrame,
+                                                 const bool wait)
+{
+    PrefetchSlot* freeSlot = nullptr;
+    for (auto& slot : _prefetchSlots)
+    {
+        if (_isInPrefetchWindow(slot.frame, requestedFrame))
+            continue;
+        if (!isLoading(slot.loading))
+        {
+            freeSlot = &slot;
+            break;
+        }
+        if (wait && !freeSlot)
+            freeSlot = &slot;
+    }
+
+    if (!freeSlot)
+        return nullptr;
+
+    // Results of frames that went out of the window are discarded
+    if (freeSlot->loading.valid())
+        freeSlot->loading.wait();
+
+    if (!_frameLoader)
+        throw std::runtime_error("Frame prefetching is not supported");
+
+    freeSlot->frame = frame;
+    freeSlot->data.resize(_frameSize);
+    freeSlot->loading =
+        std::async(std::launch::async,
+                   [loader = _frameLoader, frame, &data = freeSlot->data] {
+                       loader(frame, data);
+                   });
+    return freeSlot;
+}
+
+void AbstractSimulationHandler::_prefetch(const uint32_t requestedFrame)
+{
+    for (uint32_t i = 1; i <= _prefetchWindow; ++i)
+    {
+        int64_t next = int64_t(requestedFrame) + int64_t(i) * _prefetchDelta;
+        if (_nbFrames != 0)
+            next = (next % _nbFrames + _nbFrames) % _nbFrames;
+        if (next < 0 || next == requestedFrame)
+            break;
+
+        const auto frame = static_cast<uint32_t>(next);
+        if (!_findPrefetchSlot(frame) &&
+            !_loadIntoFreeSlot(frame, requestedFrame, false))
+            break;
+    }
+}
 }
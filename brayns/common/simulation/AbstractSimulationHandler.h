@@ -23,6 +23,9 @@
 #include <brayns/api.h>
 #include <brayns/common/types.h>
 
+#include <functional>
+#include <future>
+
 namespace brayns
 {
 /**
@@ -35,6 +38,9 @@ public:
     /** @return a clone of the concrete simulation handler implementation. */
     virtual AbstractSimulationHandlerPtr clone() const = 0;
 
+    AbstractSimulationHandler() = default;
+    AbstractSimulationHandler(const AbstractSimulationHandler& rhs);
+
     virtual ~AbstractSimulationHandler();
 
     AbstractSimulationHandler& operator=(const AbstractSimulationHandler& rhs);
@@ -81,10 +87,48 @@ public:
      * consume and if it is allowed to advance to the next frame. */
     virtual bool isReady() const { return true; }
     /** Wait until current frame is ready */
-    virtual void waitReady() const {}
+    virtual void waitReady() const;
+    /**
+     * @brief setPrefetchWindow Sets the number of frames, separated by the
+     * given delta, that are loaded in the background ahead of the requested
+     * one. A window of 0 only loads the requested frames.
+     */
+    void setPrefetchWindow(uint32_t window, int32_t delta);
+    /** @return the number of frames loaded ahead of the requested one. */
+    uint32_t getPrefetchWindow() const { return _prefetchWindow; }
+    /** @return the number of requested frames that were already prefetched */
+    uint64_t getPrefetchHits() const { return _prefetchHits; }
+    /** @return the number of requested frames that had to be loaded */
+    uint64_t getPrefetchMisses() const { return _prefetchMisses; }
 protected:
     uint32_t _getBoundedFrame(const uint32_t frame) const;
 
+    /**
+     * Loads the given frame into the given buffer, which is preallocated to
+     * the frame size and must not be reallocated. Called from background
+     * threads, possibly for several frames at once, and possibly while the
+     * handler is destroyed: it must not access the handler, but only what it
+     * captured.
+     */
+    using FrameLoader = std::function<void(uint32_t frame, floats& buffer)>;
+
+    /**
+     * @brief _setFrameLoader Sets the loader used by _getPrefetchedFrameData()
+     * to load frames in the background.
+     */
+    void _setFrameLoader(const FrameLoader& loader) { _frameLoader = loader; }
+
+    /**
+     * @brief _getPrefetchedFrameData returns the data of the given frame from
+     * the prefetch ring, and schedules the loading of the following frames.
+     * Returns nullptr if the frame is not loaded yet, unless synchronous is
+     * set, in which case it waits for it.
+     */
+    void* _getPrefetchedFrameData(uint32_t frame, bool synchronous);
+
+    /** @brief _waitPrefetchedFrames waits for all pending frame loads. */
+    void _waitPrefetchedFrames() const;
+
     uint32_t _currentFrame{std::numeric_limits<uint32_t>::max()};
     uint32_t _nbFrames{0};
     uint64_t _frameSize{0};
@@ -92,6 +136,28 @@ protected:
     std::string _unit;
 
     floats _frameData;
+
+private:
+    struct PrefetchSlot
+    {
+        uint32_t frame{std::numeric_limits<uint32_t>::max()};
+        floats data;
+        std::future<void> loading;
+    };
+
+    bool _isInPrefetchWindow(uint32_t frame, uint32_t requestedFrame) const;
+    PrefetchSlot* _findPrefetchSlot(uint32_t frame);
+    PrefetchSlot* _loadIntoFreeSlot(uint32_t frame, uint32_t requestedFrame,
+                                    bool wait);
+    void _prefetch(uint32_t requestedFrame);
+
+    FrameLoader _frameLoader;
+    std::vector<PrefetchSlot> _prefetchSlots;
+    uint32_t _prefetchWindow{0};
+    int32_t _prefetchDelta{1};
+    uint32_t _lastRequestedFrame{std::numeric_limits<uint32_t>::max()};
+    uint64_t _prefetchHits{0};
+    uint64_t _prefetchMisses{0};
 };
 }
 #endif // ABSTRACTSIMULATIONHANDLER_H
@@ -47,6 +47,18 @@ double _interpolatedOpacity(const brayns::Vector2ds& controlPointsSorted,
     const auto& lastPoint = controlPointsSorted.back();
     return lastPoint.y;
 }
+
+template <typename T>
+T _interpolatedValue(const std::vector<T>& values, const double x)
+{
+    if (values.size() == 1)
+        return values.front();
+
+    const double position = x * (values.size() - 1);
+    const size_t index = std::min(size_t(position), values.size() - 2);
+    const float t = float(position - index);
+    return values[index] * (1.f - t) + values[index + 1] * t;
+}
 }
 
 namespace brayns
@@ -91,4 +103,20 @@ floats TransferFunction::calculateInterpolatedOpacities() const
         opacities.push_back(_interpolatedOpacity(tfPoints, i * dx));
     return opacities;
 }
+
+Vector4fs TransferFunction::calculateLookupTable(const Vector3fs& colors,
+                                                 const floats& opacities,
+                                                 const size_t numSamples)
+{
+    Vector4fs lookupTable;
+    if (colors.empty() || opacities.empty() || numSamples < 2)
+        return lookupTable;
+
+    const double dx = 1. / (numSamples - 1);
+    lookupTable.reserve(numSamples);
+    for (size_t i = 0; i < numSamples; ++i)
+        lookupTable.emplace_back(_interpolatedValue(colors, i * dx),
+                                 _interpolatedValue(opacities, i * dx));
+    return lookupTable;
+}
 }
@@ -66,6 +66,14 @@ public:
 
     floats calculateInterpolatedOpacities() const;
 
+    /**
+     * Bake the given colors and opacities, each spread uniformly over the
+     * value range, into numSamples RGBA entries with linear interpolation.
+     */
+    static Vector4fs calculateLookupTable(const Vector3fs& colors,
+                                          const floats& opacities,
+                                          size_t numSamples);
+
 private:
     ColorMap _colorMap;
     Vector2ds _controlPoints;
@@ -96,6 +96,8 @@ using RendererPtr = std::shared_ptr<Renderer>;
 
 class FrameBuffer;
 using FrameBufferPtr = std::shared_ptr<FrameBuffer>;
+struct FrameBufferSnapshot;
+using FrameBufferSnapshotPtr = std::shared_ptr<const FrameBufferSnapshot>;
 
 class Model;
 using ModelPtr = std::unique_ptr<Model>;
@@ -130,6 +132,18 @@ struct Cone;
 using Cones = std::vector<Cone>;
 using ConesMap = std::map<size_t, Cones>;
 
+struct CompactSphere;
+struct CompactCylinder;
+struct CompactCone;
+template <typename T>
+struct CompactGeometries;
+using CompactSpheres = CompactGeometries<CompactSphere>;
+using CompactSpheresMap = std::map<size_t, CompactSpheres>;
+using CompactCylinders = CompactGeometries<CompactCylinder>;
+using CompactCylindersMap = std::map<size_t, CompactCylinders>;
+using CompactCones = CompactGeometries<CompactCone>;
+using CompactConesMap = std::map<size_t, CompactCones>;
+
 struct TriangleMesh;
 using TriangleMeshMap = std::map<size_t, TriangleMesh>;
 
@@ -242,7 +256,8 @@ enum class TextureType : uint8_t
 enum class MemoryMode
 {
     shared,
-    replicated
+    replicated,
+    compact // shared, with spheres, cylinders and cones quantized to 16 bits
 };
 
 enum class MaterialsColorMap
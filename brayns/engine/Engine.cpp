@@ -49,7 +49,9 @@ void Engine::preRender()
     for (auto frameBuffer : _frameBuffers)
     {
         frameBuffer->setAccumulation(renderParams.getAccumulation());
-        frameBuffer->setSubsampling(renderParams.getSubsampling());
+        // The adaptive factor is applied by Brayns::commit()
+        if (!renderParams.getAdaptiveSubsampling())
+            frameBuffer->setSubsampling(renderParams.getSubsampling());
     }
 }
 
@@ -81,7 +83,23 @@ bool Engine::continueRendering() const
     return _parametersManager.getAnimationParameters().isPlaying() ||
            (frameBuffer->getAccumulation() &&
             (frameBuffer->numAccumFrames() <
-             _parametersManager.getRenderingParameters().getMaxAccumFrames()));
+             _parametersManager.getRenderingParameters().getMaxAccumFrames()) &&
+            !isConverged());
+}
+
+bool Engine::isConverged() const
+{
+    const auto threshold =
+        _parametersManager.getRenderingParameters().getVarianceThreshold();
+    if (threshold <= 0.)
+        return false;
+
+    // The variance is only meaningful once a few frames are accumulated, the
+    // first ones might also be subsampled
+    auto frameBuffer = _frameBuffers[0];
+    return frameBuffer->getAccumulation() &&
+           frameBuffer->numAccumFrames() > 1 &&
+           _renderer->getVariance() <= threshold;
 }
 
 void Engine::addFrameBuffer(FrameBufferPtr frameBuffer)
@@ -111,9 +111,16 @@ public:
      * @return true if render() calls shall be continued, based on current
      *         accumulation settings.
      * @sa RenderingParameters::setMaxAccumFrames
+     * @sa RenderingParameters::setVarianceThreshold
      */
     bool continueRendering() const;
 
+    /**
+     * @return true if the accumulated image reached the variance threshold,
+     *         false if it has not or no threshold is set.
+     */
+    bool isConverged() const;
+
     const auto& getParametersManager() const { return _parametersManager; }
     /**
      * Add the given frame buffer to the list of buffers that shall be filled
@@ -45,20 +45,55 @@ size_t FrameBuffer::getColorDepth() const
     }
 }
 
-freeimage::ImagePtr FrameBuffer::getImage()
+FrameBufferSnapshotPtr FrameBuffer::getSnapshot()
 {
-#ifdef BRAYNS_USE_FREEIMAGE
+    if (auto snapshot = _snapshot.lock())
+        return snapshot;
+
     map();
-    const auto colorBuffer = getColorBuffer();
-    const auto& size = getSize();
+    return _createSnapshot();
+}
+
+FrameBufferSnapshotPtr FrameBuffer::tryGetSnapshot()
+{
+    if (auto snapshot = _snapshot.lock())
+        return snapshot;
+
+    if (!tryMap())
+        return nullptr;
+    return _createSnapshot();
+}
 
-    freeimage::ImagePtr image(
-        FreeImage_ConvertFromRawBits(const_cast<uint8_t*>(colorBuffer), size.x,
-                                     size.y, getColorDepth() * size.x,
-                                     8 * getColorDepth(), 0xFF0000, 0x00FF00,
-                                     0x0000FF, false));
+FrameBufferSnapshotPtr FrameBuffer::_createSnapshot()
+{
+    FrameBufferSnapshot data;
+    data.size = getSize();
+    data.format = getFrameBufferFormat();
+    data.colorDepth = getColorDepth();
+    data.colorBuffer = getColorBuffer();
+    data.depthBuffer = getDepthBuffer();
+
+    // Unmap when the last consumer releases the snapshot
+    FrameBufferSnapshotPtr snapshot(new FrameBufferSnapshot(data),
+                                    [this](const FrameBufferSnapshot* ptr) {
+                                        unmap();
+                                        delete ptr;
+                                    });
+    _snapshot = snapshot;
+    return snapshot;
+}
+
+freeimage::ImagePtr FrameBuffer::getImage()
+{
+#ifdef BRAYNS_USE_FREEIMAGE
+    const auto snapshot = getSnapshot();
+    const auto& size = snapshot->size;
+    const auto colorDepth = snapshot->colorDepth;
 
-    unmap();
+    freeimage::ImagePtr image(FreeImage_ConvertFromRawBits(
+        const_cast<uint8_t*>(snapshot->colorBuffer), size.x, size.y,
+        colorDepth * size.x, 8 * colorDepth, 0xFF0000, 0x00FF00, 0x0000FF,
+        false));
 
 #if FREEIMAGE_COLORORDER == FREEIMAGE_COLORORDER_BGR
     freeimage::SwapRedBlue32(image.get());
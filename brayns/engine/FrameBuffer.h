@@ -27,6 +27,28 @@
 
 namespace brayns
 {
+/**
+ * Read-only view on the mapped buffers of a frame buffer, shared by all the
+ * consumers of a frame. The frame buffer stays mapped for as long as the
+ * snapshot exists, which blocks rendering into it; snapshots must be released
+ * before the next frame and on the thread that requested them. Consumers which
+ * need the pixels longer have to copy them.
+ */
+struct FrameBufferSnapshot
+{
+    Vector2ui size;
+    FrameBufferFormat format{FrameBufferFormat::none};
+    size_t colorDepth{0};
+    const uint8_t* colorBuffer{nullptr};
+    const float* depthBuffer{nullptr};
+
+    /** @return the size in bytes of the color buffer. */
+    size_t getColorBufferSize() const
+    {
+        return size_t(size.x) * size.y * colorDepth;
+    }
+};
+
 class FrameBuffer : public BaseObject
 {
 public:
@@ -36,6 +58,16 @@ public:
     virtual void map() = 0;
     /** Unmap the buffer for reading with get*Buffer(). */
     virtual void unmap() = 0;
+    /**
+     * Map the buffer for reading with get*Buffer() unless that would wait,
+     * e.g. for a frame being rendered into it.
+     * @return true if the buffer was mapped
+     */
+    virtual bool tryMap()
+    {
+        map();
+        return true;
+    }
     /** @return the color buffer, valid only after map(). */
     virtual const uint8_t* getColorBuffer() const = 0;
     /** @return the depth buffer, valid only after map(). */
@@ -80,11 +112,28 @@ public:
     size_t numAccumFrames() const { return _accumFrames; }
     freeimage::ImagePtr getImage();
 
+    /**
+     * @return a snapshot of the mapped buffers. The frame buffer is mapped only
+     *         once for all the snapshots requested while one of them is alive.
+     */
+    FrameBufferSnapshotPtr getSnapshot();
+
+    /**
+     * @return a snapshot of the mapped buffers like getSnapshot(), or nullptr
+     *         if mapping the frame buffer would wait, see tryMap().
+     */
+    FrameBufferSnapshotPtr tryGetSnapshot();
+
 protected:
     const std::string _name;
     Vector2ui _frameSize;
     FrameBufferFormat _frameBufferFormat;
     bool _accumulation{true};
     std::atomic_size_t _accumFrames{0};
+
+private:
+    std::weak_ptr<const FrameBufferSnapshot> _snapshot;
+
+    FrameBufferSnapshotPtr _createSnapshot();
 };
 }
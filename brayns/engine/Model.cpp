@@ -53,6 +53,154 @@ void _unbindMaterials(const AbstractSimulationHandlerPtr& simulationHandler,
     for (const auto& material : materials)
         simulationHandler->unbind(material.second);
 }
+
+template <typename GeometryMap, typename CompactMap, typename CompactFunc>
+const typename CompactMap::mapped_type& _compactMaterial(
+    GeometryMap& geometries, CompactMap& compactGeometries,
+    const size_t materialId, CompactFunc compact)
+{
+    auto& primitives = geometries[materialId];
+    if (primitives.empty())
+        return compactGeometries[materialId];
+
+    // Compact first, the primitives are kept if that fails
+    auto compactPrimitives = compact(primitives);
+    typename GeometryMap::mapped_type().swap(primitives);
+    return compactGeometries[materialId] = std::move(compactPrimitives);
+}
+
+template <typename GeometryMap, typename CompactMap, typename ExpandFunc>
+void _expandMaterial(GeometryMap& geometries, CompactMap& compactGeometries,
+                     const size_t materialId, ExpandFunc expand)
+{
+    const auto it = compactGeometries.find(materialId);
+    if (it == compactGeometries.end())
+        return;
+    geometries[materialId] = expand(it->second);
+    compactGeometries.erase(it);
+}
+
+template <typename GeometryMap, typename CompactMap, typename ExpandFunc>
+void _expandMaterials(GeometryMap& geometries, CompactMap& compactGeometries,
+                      ExpandFunc expand)
+{
+    for (const auto& compact : compactGeometries)
+        geometries[compact.first] = expand(compact.second);
+    compactGeometries.clear();
+}
+
+template <typename T>
+void _copyMappedMaterial(std::map<size_t, std::vector<T>>& geometries,
+                         std::map<size_t, GeometryView<T>>& mappedGeometries,
+                         const size_t materialId)
+{
+    const auto it = mappedGeometries.find(materialId);
+    if (it == mappedGeometries.end())
+        return;
+    geometries[materialId].assign(it->second.begin(), it->second.end());
+    mappedGeometries.erase(it);
+}
+
+template <typename T>
+void _copyMappedMaterials(std::map<size_t, std::vector<T>>& geometries,
+                          std::map<size_t, GeometryView<T>>& mappedGeometries)
+{
+    for (const auto& mapped : mappedGeometries)
+        geometries[mapped.first].assign(mapped.second.begin(),
+                                        mapped.second.end());
+    mappedGeometries.clear();
+}
+
+template <typename T>
+void _setMappedMaterial(std::map<size_t, std::vector<T>>& geometries,
+                        std::map<size_t, GeometryView<T>>& mappedGeometries,
+                        const size_t materialId, GeometryView<T> view)
+{
+    // Keep an empty entry so that the material is known to the engines
+    std::vector<T>().swap(geometries[materialId]);
+    mappedGeometries[materialId] = std::move(view);
+}
+
+template <typename T, typename CompactMap, typename ExpandFunc>
+GeometryView<T> _getView(
+    const std::map<size_t, std::vector<T>>& geometries,
+    const std::map<size_t, GeometryView<T>>& mappedGeometries,
+    const CompactMap& compactGeometries, const size_t materialId,
+    ExpandFunc expand)
+{
+    const auto mapped = mappedGeometries.find(materialId);
+    if (mapped != mappedGeometries.end())
+        return mapped->second;
+
+    const auto compact = compactGeometries.find(materialId);
+    if (compact != compactGeometries.end())
+    {
+        const auto expanded =
+            std::make_shared<std::vector<T>>(expand(compact->second));
+        return {expanded->data(), expanded->size(), expanded};
+    }
+
+    const auto it = geometries.find(materialId);
+    if (it == geometries.end())
+        return {};
+    return {it->second.data(), it->second.size(), nullptr};
+}
+
+template <typename T, typename CompactMap>
+const std::map<size_t, std::vector<T>>& _getFullPrecision(
+    const std::map<size_t, std::vector<T>>& geometries,
+    const std::map<size_t, GeometryView<T>>& mappedGeometries,
+    const CompactMap& compactGeometries, const std::string& name)
+{
+    // Those materials have an empty entry, which must not be mistaken for an
+    // empty material
+    if (!mappedGeometries.empty() || !compactGeometries.empty())
+        throw std::runtime_error("Model has compact or memory mapped " + name +
+                                 ", use the views to read them");
+    return geometries;
+}
+
+template <typename T>
+std::vector<size_t> _getMaterialIds(
+    const std::map<size_t, std::vector<T>>& geometries)
+{
+    std::vector<size_t> materialIds;
+    materialIds.reserve(geometries.size());
+    for (const auto& geometry : geometries)
+        materialIds.push_back(geometry.first);
+    return materialIds;
+}
+
+template <typename T>
+size_t _getMappedSizeInBytes(
+    const std::map<size_t, GeometryView<T>>& mappedGeometries)
+{
+    size_t sizeInBytes = 0;
+    for (const auto& mapped : mappedGeometries)
+        sizeInBytes += mapped.second.size * sizeof(T);
+    return sizeInBytes;
+}
+
+template <typename CompactMap>
+bool _getCompactBounds(const CompactMap& compactGeometries,
+                       const size_t materialId, Boxd& bounds)
+{
+    const auto it = compactGeometries.find(materialId);
+    if (it == compactGeometries.end())
+        return false;
+    bounds = it->second.bounds;
+    return true;
+}
+
+template <typename CompactMap>
+size_t _getCompactSizeInBytes(const CompactMap& compactGeometries)
+{
+    size_t sizeInBytes = 0;
+    for (const auto& compact : compactGeometries)
+        sizeInBytes += compact.second.primitives.size() *
+                       sizeof(decltype(compact.second.primitives.back()));
+    return sizeInBytes;
+}
 }
 ModelParams::ModelParams(const std::string& path)
     : _name(fs::path(path).stem())
@@ -153,6 +301,21 @@ ModelInstance* ModelDescriptor::getInstance(const size_t id)
     return i == _instances.end() ? nullptr : &(*i);
 }
 
+bool ModelDescriptor::areInstancesModified() const
+{
+    return std::any_of(_instances.begin(), _instances.end(),
+                       [](const auto& instance) {
+                           return instance.isModified();
+                       });
+}
+
+void ModelDescriptor::resetInstancesModified()
+{
+    resetModified();
+    for (auto& instance : _instances)
+        instance.resetModified();
+}
+
 void ModelDescriptor::computeBounds()
 {
     _bounds.reset();
@@ -205,25 +368,108 @@ bool Model::empty() const
 
 uint64_t Model::addSphere(const size_t materialId, const Sphere& sphere)
 {
-    _spheresDirty = true;
+    _dirtySphereMaterials.insert(materialId);
+    _expandSpheres(materialId);
     _geometries->_spheres[materialId].push_back(sphere);
     return _geometries->_spheres[materialId].size() - 1;
 }
 
 uint64_t Model::addCylinder(const size_t materialId, const Cylinder& cylinder)
 {
-    _cylindersDirty = true;
+    _dirtyCylinderMaterials.insert(materialId);
+    _expandCylinders(materialId);
     _geometries->_cylinders[materialId].push_back(cylinder);
     return _geometries->_cylinders[materialId].size() - 1;
 }
 
 uint64_t Model::addCone(const size_t materialId, const Cone& cone)
 {
-    _conesDirty = true;
+    _dirtyConeMaterials.insert(materialId);
+    _expandCones(materialId);
     _geometries->_cones[materialId].push_back(cone);
     return _geometries->_cones[materialId].size() - 1;
 }
 
+const SpheresMap& Model::getSpheres() const
+{
+    return _getFullPrecision(_geometries->_spheres,
+                             _geometries->_mappedSpheres,
+                             _geometries->_compactSpheres, "spheres");
+}
+
+std::vector<size_t> Model::getSphereMaterialIds() const
+{
+    return _getMaterialIds(_geometries->_spheres);
+}
+
+const CylindersMap& Model::getCylinders() const
+{
+    return _getFullPrecision(_geometries->_cylinders,
+                             _geometries->_mappedCylinders,
+                             _geometries->_compactCylinders, "cylinders");
+}
+
+std::vector<size_t> Model::getCylinderMaterialIds() const
+{
+    return _getMaterialIds(_geometries->_cylinders);
+}
+
+const ConesMap& Model::getCones() const
+{
+    return _getFullPrecision(_geometries->_cones, _geometries->_mappedCones,
+                             _geometries->_compactCones, "cones");
+}
+
+std::vector<size_t> Model::getConeMaterialIds() const
+{
+    return _getMaterialIds(_geometries->_cones);
+}
+
+GeometryView<Sphere> Model::getSpheresView(const size_t materialId) const
+{
+    return _getView(_geometries->_spheres, _geometries->_mappedSpheres,
+                    _geometries->_compactSpheres, materialId, expandSpheres);
+}
+
+GeometryView<Cylinder> Model::getCylindersView(const size_t materialId) const
+{
+    return _getView(_geometries->_cylinders, _geometries->_mappedCylinders,
+                    _geometries->_compactCylinders, materialId,
+                    expandCylinders);
+}
+
+GeometryView<Cone> Model::getConesView(const size_t materialId) const
+{
+    return _getView(_geometries->_cones, _geometries->_mappedCones,
+                    _geometries->_compactCones, materialId, expandCones);
+}
+
+void Model::setMappedSpheres(const size_t materialId,
+                             GeometryView<Sphere> spheres)
+{
+    _dirtySphereMaterials.insert(materialId);
+    _geometries->_compactSpheres.erase(materialId);
+    _setMappedMaterial(_geometries->_spheres, _geometries->_mappedSpheres,
+                       materialId, std::move(spheres));
+}
+
+void Model::setMappedCylinders(const size_t materialId,
+                               GeometryView<Cylinder> cylinders)
+{
+    _dirtyCylinderMaterials.insert(materialId);
+    _geometries->_compactCylinders.erase(materialId);
+    _setMappedMaterial(_geometries->_cylinders, _geometries->_mappedCylinders,
+                       materialId, std::move(cylinders));
+}
+
+void Model::setMappedCones(const size_t materialId, GeometryView<Cone> cones)
+{
+    _dirtyConeMaterials.insert(materialId);
+    _geometries->_compactCones.erase(materialId);
+    _setMappedMaterial(_geometries->_cones, _geometries->_mappedCones,
+                       materialId, std::move(cones));
+}
+
 void Model::addStreamline(const size_t materialId, const Streamline& streamline)
 {
     if (streamline.position.size() < 2)
@@ -398,6 +644,18 @@ void Model::logInformation()
         nbCylinders += cylinders.second.size();
     for (const auto& cones : _geometries->_cones)
         nbCones += cones.second.size();
+    for (const auto& spheres : _geometries->_compactSpheres)
+        nbSpheres += spheres.second.primitives.size();
+    for (const auto& cylinders : _geometries->_compactCylinders)
+        nbCylinders += cylinders.second.primitives.size();
+    for (const auto& cones : _geometries->_compactCones)
+        nbCones += cones.second.primitives.size();
+    for (const auto& spheres : _geometries->_mappedSpheres)
+        nbSpheres += spheres.second.size;
+    for (const auto& cylinders : _geometries->_mappedCylinders)
+        nbCylinders += cylinders.second.size;
+    for (const auto& cones : _geometries->_mappedCones)
+        nbCones += cones.second.size;
 
     BRAYNS_DEBUG << "Spheres: " << nbSpheres << ", Cylinders: " << nbCylinders
                  << ", Cones: " << nbCones << ", Meshes: " << nbMeshes
@@ -423,7 +681,13 @@ void Model::_updateSizeInBytes()
     for (const auto& cylinders : _geometries->_cylinders)
         _sizeInBytes += cylinders.second.size() * sizeof(Cylinder);
     for (const auto& cones : _geometries->_cones)
-        _sizeInBytes += cones.second.size() * sizeof(Cones);
+        _sizeInBytes += cones.second.size() * sizeof(Cone);
+    _sizeInBytes += _getCompactSizeInBytes(_geometries->_compactSpheres);
+    _sizeInBytes += _getCompactSizeInBytes(_geometries->_compactCylinders);
+    _sizeInBytes += _getCompactSizeInBytes(_geometries->_compactCones);
+    _sizeInBytes += _getMappedSizeInBytes(_geometries->_mappedSpheres);
+    _sizeInBytes += _getMappedSizeInBytes(_geometries->_mappedCylinders);
+    _sizeInBytes += _getMappedSizeInBytes(_geometries->_mappedCones);
     for (const auto& triangleMesh : _geometries->_triangleMeshes)
     {
         const auto& mesh = triangleMesh.second;
@@ -484,41 +748,52 @@ void Model::copyFrom(const Model& rhs)
 void Model::updateBounds()
 {
     if (_spheresDirty)
+        _geometries->_sphereBounds.clear();
+    for (const auto materialId : _getDirtySphereMaterials())
     {
-        _geometries->_sphereBounds.reset();
-        for (const auto& spheres : _geometries->_spheres)
-            if (spheres.first != BOUNDINGBOX_MATERIAL_ID)
-                for (const auto& sphere : spheres.second)
-                {
-                    _geometries->_sphereBounds.merge(sphere.center +
-                                                     sphere.radius);
-                    _geometries->_sphereBounds.merge(sphere.center -
-                                                     sphere.radius);
-                }
+        auto& bounds = _geometries->_sphereBounds[materialId];
+        bounds.reset();
+        if (materialId == BOUNDINGBOX_MATERIAL_ID ||
+            _getCompactBounds(_geometries->_compactSpheres, materialId, bounds))
+            continue;
+        for (const auto& sphere : getSpheresView(materialId))
+        {
+            bounds.merge(sphere.center + sphere.radius);
+            bounds.merge(sphere.center - sphere.radius);
+        }
     }
 
     if (_cylindersDirty)
+        _geometries->_cylindersBounds.clear();
+    for (const auto materialId : _getDirtyCylinderMaterials())
     {
-        _geometries->_cylindersBounds.reset();
-        for (const auto& cylinders : _geometries->_cylinders)
-            if (cylinders.first != BOUNDINGBOX_MATERIAL_ID)
-                for (const auto& cylinder : cylinders.second)
-                {
-                    _geometries->_cylindersBounds.merge(cylinder.center);
-                    _geometries->_cylindersBounds.merge(cylinder.up);
-                }
+        auto& bounds = _geometries->_cylindersBounds[materialId];
+        bounds.reset();
+        if (materialId == BOUNDINGBOX_MATERIAL_ID ||
+            _getCompactBounds(_geometries->_compactCylinders, materialId,
+                              bounds))
+            continue;
+        for (const auto& cylinder : getCylindersView(materialId))
+        {
+            bounds.merge(cylinder.center);
+            bounds.merge(cylinder.up);
+        }
     }
 
     if (_conesDirty)
+        _geometries->_conesBounds.clear();
+    for (const auto materialId : _getDirtyConeMaterials())
     {
-        _geometries->_conesBounds.reset();
-        for (const auto& cones : _geometries->_cones)
-            if (cones.first != BOUNDINGBOX_MATERIAL_ID)
-                for (const auto& cone : cones.second)
-                {
-                    _geometries->_conesBounds.merge(cone.center);
-                    _geometries->_conesBounds.merge(cone.up);
-                }
+        auto& bounds = _geometries->_conesBounds[materialId];
+        bounds.reset();
+        if (materialId == BOUNDINGBOX_MATERIAL_ID ||
+            _getCompactBounds(_geometries->_compactCones, materialId, bounds))
+            continue;
+        for (const auto& cone : getConesView(materialId))
+        {
+            bounds.merge(cone.center);
+            bounds.merge(cone.up);
+        }
     }
 
     if (_triangleMeshesDirty)
@@ -560,9 +835,12 @@ void Model::updateBounds()
     }
 
     _bounds.reset();
-    _bounds.merge(_geometries->_sphereBounds);
-    _bounds.merge(_geometries->_cylindersBounds);
-    _bounds.merge(_geometries->_conesBounds);
+    for (const auto& bounds : _geometries->_sphereBounds)
+        _bounds.merge(bounds.second);
+    for (const auto& bounds : _geometries->_cylindersBounds)
+        _bounds.merge(bounds.second);
+    for (const auto& bounds : _geometries->_conesBounds)
+        _bounds.merge(bounds.second);
     _bounds.merge(_geometries->_triangleMeshesBounds);
     _bounds.merge(_geometries->_streamlinesBounds);
     _bounds.merge(_geometries->_sdfGeometriesBounds);
@@ -578,6 +856,81 @@ void Model::_markGeometriesClean()
     _streamlinesDirty = false;
     _sdfGeometriesDirty = false;
     _volumesDirty = false;
+    _dirtySphereMaterials.clear();
+    _dirtyCylinderMaterials.clear();
+    _dirtyConeMaterials.clear();
+}
+
+const CompactSpheres& Model::_compactSpheres(const size_t materialId)
+{
+    _copyMappedMaterial(_geometries->_spheres, _geometries->_mappedSpheres,
+                        materialId);
+    return _compactMaterial(_geometries->_spheres,
+                            _geometries->_compactSpheres, materialId,
+                            compactSpheres);
+}
+
+const CompactCylinders& Model::_compactCylinders(const size_t materialId)
+{
+    _copyMappedMaterial(_geometries->_cylinders, _geometries->_mappedCylinders,
+                        materialId);
+    return _compactMaterial(_geometries->_cylinders,
+                            _geometries->_compactCylinders, materialId,
+                            compactCylinders);
+}
+
+const CompactCones& Model::_compactCones(const size_t materialId)
+{
+    _copyMappedMaterial(_geometries->_cones, _geometries->_mappedCones,
+                        materialId);
+    return _compactMaterial(_geometries->_cones, _geometries->_compactCones,
+                            materialId, compactCones);
+}
+
+void Model::_expandSpheres()
+{
+    _copyMappedMaterials(_geometries->_spheres, _geometries->_mappedSpheres);
+    _expandMaterials(_geometries->_spheres, _geometries->_compactSpheres,
+                     expandSpheres);
+}
+
+void Model::_expandSpheres(const size_t materialId)
+{
+    _copyMappedMaterial(_geometries->_spheres, _geometries->_mappedSpheres,
+                        materialId);
+    _expandMaterial(_geometries->_spheres, _geometries->_compactSpheres,
+                    materialId, expandSpheres);
+}
+
+void Model::_expandCylinders()
+{
+    _copyMappedMaterials(_geometries->_cylinders,
+                         _geometries->_mappedCylinders);
+    _expandMaterials(_geometries->_cylinders, _geometries->_compactCylinders,
+                     expandCylinders);
+}
+
+void Model::_expandCylinders(const size_t materialId)
+{
+    _copyMappedMaterial(_geometries->_cylinders, _geometries->_mappedCylinders,
+                        materialId);
+    _expandMaterial(_geometries->_cylinders, _geometries->_compactCylinders,
+                    materialId, expandCylinders);
+}
+
+void Model::_expandCones()
+{
+    _copyMappedMaterials(_geometries->_cones, _geometries->_mappedCones);
+    _expandMaterials(_geometries->_cones, _geometries->_compactCones,
+                     expandCones);
+}
+
+void Model::_expandCones(const size_t materialId)
+{
+    _copyMappedMaterial(_geometries->_cones, _geometries->_mappedCones,
+                        materialId);
+    _expandMaterial(_geometries->_cones, _geometries->_compactCones,
+                    materialId, expandCones);
 }
 
 MaterialPtr Model::createMaterial(const size_t materialId,
@@ -614,16 +967,29 @@ AbstractSimulationHandlerPtr Model::getSimulationHandler() const
 
 bool Model::commitTransferFunction()
 {
-    if (!_transferFunction.isModified())
-        return false;
-
-    _commitTransferFunctionImpl(
-        _transferFunction.getColorMap().colors,
-        _transferFunction.calculateInterpolatedOpacities(),
-        _transferFunction.getValuesRange());
+    const bool modified = _transferFunction.isModified();
+    floats opacities;
+    if (modified)
+    {
+        opacities = _transferFunction.calculateInterpolatedOpacities();
+        _commitTransferFunctionImpl(_transferFunction.getColorMap().colors,
+                                    opacities,
+                                    _transferFunction.getValuesRange());
+        _transferFunction.resetModified();
+    }
 
-    _transferFunction.resetModified();
-    return true;
+    // Macrocells for empty space skipping follow both the transfer function
+    // and the voxels
+    for (auto volume : _geometries->_volumes)
+    {
+        if (!modified && !volume->hasNewMacrocellRanges())
+            continue;
+        if (opacities.empty())
+            opacities = _transferFunction.calculateInterpolatedOpacities();
+        volume->updateMacrocellOpacities(opacities,
+                                         _transferFunction.getValuesRange());
+    }
+    return modified;
 }
 
 bool Model::commitSimulationData()
@@ -650,6 +1016,12 @@ bool Model::commitSimulationData()
         return false;
     }
 
+    _simulationHandler->setPrefetchWindow(
+        _animationParameters.isPlaying()
+            ? _animationParameters.getPrefetchFrames()
+            : 0,
+        _animationParameters.getDelta());
+
     auto frameData = _simulationHandler->getFrameData(animationFrame);
 
     if (!frameData)
@@ -24,6 +24,7 @@
 #include <brayns/common/BaseObject.h>
 #include <brayns/common/PropertyMap.h>
 #include <brayns/common/Transformation.h>
+#include <brayns/common/geometry/CompactGeometry.h>
 #include <brayns/common/geometry/Cone.h>
 #include <brayns/common/geometry/Cylinder.h>
 #include <brayns/common/geometry/SDFGeometry.h>
@@ -51,6 +52,23 @@ struct SDFGeometryData
     std::vector<uint64_t> neighboursFlat;
 };
 
+/**
+ * Read-only view on primitives that are not necessarily stored in the vectors
+ * of the Model, e.g. in a memory mapped file. The optional owner keeps the
+ * memory alive for as long as the view exists.
+ */
+template <typename T>
+struct GeometryView
+{
+    const T* data{nullptr};
+    size_t size{0};
+    std::shared_ptr<const void> owner;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
 class ModelInstance : public BaseObject
 {
 public:
@@ -190,6 +208,14 @@ public:
         if (_onRemovedCallback)
             _onRemovedCallback(*this);
     }
+    /**
+     * @internal
+     * @return true if any of the instances has been modified since the last
+     *         resetInstancesModified().
+     */
+    bool areInstancesModified() const;
+    /** @internal Reset the modified state of the descriptor and instances. */
+    void resetInstancesModified();
     /** @internal */
     void markForRemoval() { _markedForRemoval = true; }
     /** @internal */
@@ -274,14 +300,48 @@ public:
     */
     const Boxd& getBounds() const { return _bounds; }
     /**
-        Returns spheres handled by the Model
+        Returns spheres handled by the Model.
+        @throw std::runtime_error if spheres are compacted by the engine or
+               memory mapped, use getSphereMaterialIds() and
+               getSpheresView() to read those
     */
-    const SpheresMap& getSpheres() const { return _geometries->_spheres; }
+    const SpheresMap& getSpheres() const;
     SpheresMap& getSpheres()
     {
         _spheresDirty = true;
+        _expandSpheres();
         return _geometries->_spheres;
     }
+    /**
+        Returns the spheres of the given material, and only marks those as
+        dirty
+    */
+    Spheres& getSpheres(const size_t materialId)
+    {
+        _dirtySphereMaterials.insert(materialId);
+        _expandSpheres(materialId);
+        return _geometries->_spheres[materialId];
+    }
+    /**
+        Returns the spheres of the given material without copying them,
+        wherever they are stored. Compact spheres are expanded into memory
+        owned by the view.
+    */
+    GeometryView<Sphere> getSpheresView(size_t materialId) const;
+    /** Returns the ids of the materials with spheres, wherever they are */
+    std::vector<size_t> getSphereMaterialIds() const;
+    /**
+        Uses spheres stored outside of the model for the given material, e.g.
+        in a memory mapped file. They are copied into the model on first
+        modification.
+    */
+    BRAYNS_API void setMappedSpheres(size_t materialId,
+                                     GeometryView<Sphere> spheres);
+    /** Returns the spheres stored in the compact memory mode */
+    const CompactSpheresMap& getCompactSpheres() const
+    {
+        return _geometries->_compactSpheres;
+    }
     /**
       Adds a sphere to the model
       @param materialId Id of the material for the sphere
@@ -293,13 +353,47 @@ public:
 
     /**
         Returns cylinders handled by the model
+        @throw std::runtime_error if cylinders are compacted by the engine or
+               memory mapped, use getCylinderMaterialIds() and
+               getCylindersView() to read those
       */
-    const CylindersMap& getCylinders() const { return _geometries->_cylinders; }
+    const CylindersMap& getCylinders() const;
     CylindersMap& getCylinders()
     {
         _cylindersDirty = true;
+        _expandCylinders();
         return _geometries->_cylinders;
     }
+    /**
+        Returns the cylinders of the given material, and only marks those as
+        dirty
+    */
+    Cylinders& getCylinders(const size_t materialId)
+    {
+        _dirtyCylinderMaterials.insert(materialId);
+        _expandCylinders(materialId);
+        return _geometries->_cylinders[materialId];
+    }
+    /**
+        Returns the cylinders of the given material without copying them,
+        wherever they are stored. Compact cylinders are expanded into memory
+        owned by the view.
+    */
+    GeometryView<Cylinder> getCylindersView(size_t materialId) const;
+    /** Returns the ids of the materials with cylinders, wherever they are */
+    std::vector<size_t> getCylinderMaterialIds() const;
+    /**
+        Uses cylinders stored outside of the model for the given material, e.g.
+        in a memory mapped file. They are copied into the model on first
+        modification.
+    */
+    BRAYNS_API void setMappedCylinders(size_t materialId,
+                                       GeometryView<Cylinder> cylinders);
+    /** Returns the cylinders stored in the compact memory mode */
+    const CompactCylindersMap& getCompactCylinders() const
+    {
+        return _geometries->_compactCylinders;
+    }
     /**
       Adds a cylinder to the model
       @param materialId Id of the material for the cylinder
@@ -310,13 +404,45 @@ public:
                                     const Cylinder& cylinder);
     /**
         Returns cones handled by the model
+        @throw std::runtime_error if cones are compacted by the engine or
+               memory mapped, use getConeMaterialIds() and getConesView() to
+               read those
     */
-    const ConesMap& getCones() const { return _geometries->_cones; }
+    const ConesMap& getCones() const;
     ConesMap& getCones()
     {
         _conesDirty = true;
+        _expandCones();
         return _geometries->_cones;
     }
+    /**
+        Returns the cones of the given material, and only marks those as dirty
+    */
+    Cones& getCones(const size_t materialId)
+    {
+        _dirtyConeMaterials.insert(materialId);
+        _expandCones(materialId);
+        return _geometries->_cones[materialId];
+    }
+    /**
+        Returns the cones of the given material without copying them,
+        wherever they are stored. Compact cones are expanded into memory owned
+        by the view.
+    */
+    GeometryView<Cone> getConesView(size_t materialId) const;
+    /** Returns the ids of the materials with cones, wherever they are */
+    std::vector<size_t> getConeMaterialIds() const;
+    /**
+        Uses cones stored outside of the model for the given material, e.g. in
+        a memory mapped file. They are copied into the model on first
+        modification.
+    */
+    BRAYNS_API void setMappedCones(size_t materialId, GeometryView<Cone> cones);
+    /** Returns the cones stored in the compact memory mode */
+    const CompactConesMap& getCompactCones() const
+    {
+        return _geometries->_compactCones;
+    }
     /**
       Adds a cone to the model
       @param materialId Id of the material for thecone
@@ -438,6 +564,8 @@ public:
     size_t getSizeInBytes() const;
     void markInstancesDirty() { _instancesDirty = true; }
     void markInstancesClean() { _instancesDirty = false; }
+    /** @return true if instances changed since markInstancesClean(). */
+    bool areInstancesDirty() const { return _instancesDirty; }
     const Volumes& getVolumes() const { return _geometries->_volumes; }
     bool isVolumesDirty() const { return _volumesDirty; }
     void resetVolumesDirty() { _volumesDirty = false; }
@@ -460,6 +588,15 @@ protected:
     /** Mark all geometries as clean. */
     void _markGeometriesClean();
 
+    /**
+     * Quantize the spheres, cylinders or cones of the given material and
+     * release their full precision copy, see MemoryMode::compact.
+     * @return the compact primitives of the material
+     */
+    const CompactSpheres& _compactSpheres(size_t materialId);
+    const CompactCylinders& _compactCylinders(size_t materialId);
+    const CompactCones& _compactCones(size_t materialId);
+
     virtual void _commitTransferFunctionImpl(const Vector3fs& colors,
                                              const floats& opacities,
                                              const Vector2d valueRange) = 0;
@@ -479,14 +616,20 @@ protected:
         SpheresMap _spheres;
         CylindersMap _cylinders;
         ConesMap _cones;
+        CompactSpheresMap _compactSpheres;
+        CompactCylindersMap _compactCylinders;
+        CompactConesMap _compactCones;
+        std::map<size_t, GeometryView<Sphere>> _mappedSpheres;
+        std::map<size_t, GeometryView<Cylinder>> _mappedCylinders;
+        std::map<size_t, GeometryView<Cone>> _mappedCones;
         TriangleMeshMap _triangleMeshes;
         StreamlinesDataMap _streamlines;
         SDFGeometryData _sdf;
         Volumes _volumes;
 
-        Boxd _sphereBounds;
-        Boxd _cylindersBounds;
-        Boxd _conesBounds;
+        std::map<size_t, Boxd> _sphereBounds;
+        std::map<size_t, Boxd> _cylindersBounds;
+        std::map<size_t, Boxd> _conesBounds;
         Boxd _triangleMeshesBounds;
         Boxd _streamlinesBounds;
         Boxd _sdfGeometriesBounds;
@@ -513,10 +656,50 @@ protected:
     bool _sdfGeometriesDirty{false};
     bool _volumesDirty{false};
 
+    // Materials whose spheres, cylinders or cones have been modified. The
+    // flags above mark all materials of a geometry type as dirty.
+    std::set<size_t> _dirtySphereMaterials;
+    std::set<size_t> _dirtyCylinderMaterials;
+    std::set<size_t> _dirtyConeMaterials;
+
     bool _areGeometriesDirty() const
     {
         return _spheresDirty || _cylindersDirty || _conesDirty ||
-               _triangleMeshesDirty || _sdfGeometriesDirty;
+               _triangleMeshesDirty || _sdfGeometriesDirty ||
+               !_dirtySphereMaterials.empty() ||
+               !_dirtyCylinderMaterials.empty() ||
+               !_dirtyConeMaterials.empty();
+    }
+
+    /** @return the IDs of the materials whose spheres need to be committed */
+    size_ts _getDirtySphereMaterials() const
+    {
+        return _getDirtyMaterials(_geometries->_spheres, _spheresDirty,
+                                  _dirtySphereMaterials);
+    }
+    /** @return the IDs of the materials whose cylinders need to be committed */
+    size_ts _getDirtyCylinderMaterials() const
+    {
+        return _getDirtyMaterials(_geometries->_cylinders, _cylindersDirty,
+                                  _dirtyCylinderMaterials);
+    }
+    /** @return the IDs of the materials whose cones need to be committed */
+    size_ts _getDirtyConeMaterials() const
+    {
+        return _getDirtyMaterials(_geometries->_cones, _conesDirty,
+                                  _dirtyConeMaterials);
+    }
+
+    template <typename T>
+    static size_ts _getDirtyMaterials(const std::map<size_t, T>& geometries,
+                                      const bool allDirty,
+                                      const std::set<size_t>& dirtyMaterials)
+    {
+        size_ts materialIds;
+        for (const auto& geometry : geometries)
+            if (allDirty || dirtyMaterials.count(geometry.first))
+                materialIds.push_back(geometry.first);
+        return materialIds;
     }
 
     Boxd _bounds;
@@ -527,6 +710,16 @@ protected:
     // Whether this model has set the AnimationParameters "is ready" callback
     bool _isReadyCallbackSet{false};
 
+private:
+    // Restore the full precision primitives of compacted materials, and copy
+    // the memory mapped ones, before they get modified
+    void _expandSpheres();
+    void _expandSpheres(size_t materialId);
+    void _expandCylinders();
+    void _expandCylinders(size_t materialId);
+    void _expandCones();
+    void _expandCones(size_t materialId);
+
     SERIALIZATION_FRIEND(Model)
 };
 }
@@ -20,6 +20,48 @@
 
 #include "Volume.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// Edge length of a macrocell in voxels
+const uint32_t MACROCELL_SIZE = 16;
+
+const brayns::Vector2f EMPTY_RANGE{std::numeric_limits<float>::max(),
+                                   std::numeric_limits<float>::lowest()};
+
+template <typename T>
+void computeRanges(const T* voxels, const brayns::Vector3ui& position,
+                   const brayns::Vector3ui& size,
+                   const brayns::Vector3ui& firstCell,
+                   const brayns::Vector3ui& nbCells,
+                   std::vector<brayns::Vector2f>& ranges)
+{
+    for (uint32_t z = 0; z < size.z; ++z)
+    {
+        const uint32_t cz = (position.z + z) / MACROCELL_SIZE - firstCell.z;
+        for (uint32_t y = 0; y < size.y; ++y)
+        {
+            const uint32_t cy = (position.y + y) / MACROCELL_SIZE - firstCell.y;
+            const T* row = voxels + (size_t(z) * size.y + y) * size.x;
+            auto* cellRanges =
+                &ranges[(size_t(cz) * nbCells.y + cy) * nbCells.x];
+            for (uint32_t x = 0; x < size.x; ++x)
+            {
+                const uint32_t cx =
+                    (position.x + x) / MACROCELL_SIZE - firstCell.x;
+                const float value = static_cast<float>(row[x]);
+                auto& range = cellRanges[cx];
+                range.x = std::min(range.x, value);
+                range.y = std::max(range.y, value);
+            }
+        }
+    }
+}
+} // namespace
+
 namespace brayns
 {
 Volume::Volume(const Vector3ui& dimensions, const Vector3f& spacing,
@@ -29,4 +71,135 @@ Volume::Volume(const Vector3ui& dimensions, const Vector3f& spacing,
     , _dataType(type)
 {
 }
+
+Vector3ui Volume::getMacrocellDimensions() const
+{
+    return (_dimensions + MACROCELL_SIZE - 1u) / MACROCELL_SIZE;
+}
+
+Vector3f Volume::getMacrocellSize() const
+{
+    return _spacing * float(MACROCELL_SIZE);
+}
+
+void Volume::updateMacrocellOpacities(const floats& opacities,
+                                      const Vector2d& valueRange)
+{
+    std::lock_guard<std::mutex> lock(_macrocellMutex);
+    _macrocellRangesModified = false;
+    if (_macrocellRanges.empty() || opacities.empty())
+        return;
+
+    const double lastIndex = double(opacities.size() - 1);
+    const double scale = valueRange.y > valueRange.x
+                             ? lastIndex / (valueRange.y - valueRange.x)
+                             : 0.0;
+    const auto toIndex = [&](const float value) {
+        return std::min(std::max((value - valueRange.x) * scale, 0.0),
+                        lastIndex);
+    };
+
+    // Trilinear sampling close to the upper faces of a macrocell also reads
+    // the first voxels of the next ones, so their ranges are merged in.
+    const auto nbCells = getMacrocellDimensions();
+    _macrocellOpacities.resize(_macrocellRanges.size());
+    size_t index = 0;
+    for (uint32_t z = 0; z < nbCells.z; ++z)
+        for (uint32_t y = 0; y < nbCells.y; ++y)
+            for (uint32_t x = 0; x < nbCells.x; ++x)
+            {
+                const Vector3ui neighbor =
+                    glm::min(Vector3ui(x, y, z) + 1u, nbCells - 1u);
+                auto range = EMPTY_RANGE;
+                bool complete = true;
+                for (uint32_t nz = z; nz <= neighbor.z; ++nz)
+                    for (uint32_t ny = y; ny <= neighbor.y; ++ny)
+                        for (uint32_t nx = x; nx <= neighbor.x; ++nx)
+                        {
+                            const auto& cell =
+                                _macrocellRanges[(size_t(nz) * nbCells.y + ny) *
+                                                     nbCells.x +
+                                                 nx];
+                            complete &= cell.x <= cell.y;
+                            range.x = std::min(range.x, cell.x);
+                            range.y = std::max(range.y, cell.y);
+                        }
+
+                float opacity = 1.f;
+                if (complete)
+                {
+                    const auto first = opacities.begin() +
+                                       size_t(std::floor(toIndex(range.x)));
+                    const auto last = opacities.begin() +
+                                      size_t(std::ceil(toIndex(range.y)));
+                    opacity = *std::max_element(first, last + 1);
+                }
+                _macrocellOpacities[index++] = opacity;
+            }
+
+    _macrocellOpacitiesModified = true;
+    markModified();
+}
+
+void Volume::_updateMacrocellRanges(const void* voxels,
+                                    const Vector3ui& position,
+                                    const Vector3ui& size)
+{
+    if (glm::compMul(size) == 0)
+        return;
+
+    // Compute the ranges of the covered macrocells without holding the lock,
+    // bricks may be set from several threads
+    const auto firstCell = position / MACROCELL_SIZE;
+    const auto lastCell = (position + size - 1u) / MACROCELL_SIZE;
+    const auto nbCells = lastCell - firstCell + 1u;
+    std::vector<Vector2f> ranges(glm::compMul(nbCells), EMPTY_RANGE);
+
+    switch (_dataType)
+    {
+    case DataType::FLOAT:
+        computeRanges(static_cast<const float*>(voxels), position, size,
+                      firstCell, nbCells, ranges);
+        break;
+    case DataType::DOUBLE:
+        computeRanges(static_cast<const double*>(voxels), position, size,
+                      firstCell, nbCells, ranges);
+        break;
+    case DataType::UINT8:
+        computeRanges(static_cast<const uint8_t*>(voxels), position, size,
+                      firstCell, nbCells, ranges);
+        break;
+    case DataType::UINT16:
+        computeRanges(static_cast<const uint16_t*>(voxels), position, size,
+                      firstCell, nbCells, ranges);
+        break;
+    case DataType::INT16:
+        computeRanges(static_cast<const int16_t*>(voxels), position, size,
+                      firstCell, nbCells, ranges);
+        break;
+    case DataType::UINT32:
+    case DataType::INT8:
+    case DataType::INT32:
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_macrocellMutex);
+    const auto allCells = getMacrocellDimensions();
+    if (_macrocellRanges.empty())
+        _macrocellRanges.resize(glm::compMul(allCells), EMPTY_RANGE);
+
+    size_t index = 0;
+    for (uint32_t z = firstCell.z; z <= lastCell.z; ++z)
+        for (uint32_t y = firstCell.y; y <= lastCell.y; ++y)
+            for (uint32_t x = firstCell.x; x <= lastCell.x; ++x)
+            {
+                auto& cell =
+                    _macrocellRanges[(size_t(z) * allCells.y + y) * allCells.x +
+                                     x];
+                const auto& range = ranges[index++];
+                cell.x = std::min(cell.x, range.x);
+                cell.y = std::max(cell.y, range.y);
+            }
+    _macrocellRangesModified = true;
+}
 }
@@ -23,6 +23,8 @@
 #include <brayns/common/BaseObject.h>
 #include <brayns/common/types.h>
 
+#include <mutex>
+
 namespace brayns
 {
 /** A base class for volumes to share common properties. */
@@ -47,10 +49,50 @@ public:
                  _dimensions.z * _spacing.z}};
     }
 
+    /** @name Macrocells for empty space skipping */
+    //@{
+    /** @return the number of macrocells along each axis. */
+    Vector3ui getMacrocellDimensions() const;
+
+    /** @return the extent of one macrocell in volume space. */
+    Vector3f getMacrocellSize() const;
+
+    /**
+     * @return the maximum opacity of each macrocell, x varying fastest; empty
+     *         until updateMacrocellOpacities() was called.
+     */
+    const floats& getMacrocellOpacities() const { return _macrocellOpacities; }
+
+    /** @return true if voxels were set since the last opacity update. */
+    bool hasNewMacrocellRanges() const { return _macrocellRangesModified; }
+
+    /**
+     * Compute the maximum opacity of each macrocell for the given transfer
+     * function opacities spread over valueRange. Macrocells with voxels not
+     * set yet are considered opaque.
+     */
+    void updateMacrocellOpacities(const floats& opacities,
+                                  const Vector2d& valueRange);
+    //@}
+
 protected:
+    /**
+     * Update the value range of the macrocells covered by the given voxels,
+     * to be called by the engine-specific voxel setters.
+     */
+    void _updateMacrocellRanges(const void* voxels, const Vector3ui& position,
+                                const Vector3ui& size);
+
     std::atomic_size_t _sizeInBytes{0};
     const Vector3ui _dimensions;
     const Vector3f _spacing;
     const DataType _dataType;
+    bool _macrocellOpacitiesModified{false};
+
+private:
+    std::mutex _macrocellMutex;
+    std::vector<Vector2f> _macrocellRanges;
+    std::atomic_bool _macrocellRangesModified{false};
+    floats _macrocellOpacities;
 };
 }
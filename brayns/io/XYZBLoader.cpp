@@ -74,7 +74,7 @@ ModelDescriptorPtr XYZBLoader::importFromBlob(
     const auto name = fs::path({blob.name}).stem();
     const auto materialId = 0;
     model->createMaterial(materialId, name);
-    auto& spheres = model->getSpheres()[materialId];
+    auto& spheres = model->getSpheres(materialId);
 
     const size_t startOffset = spheres.size();
     spheres.reserve(spheres.size() + numlines);
@@ -140,7 +140,7 @@ ModelDescriptorPtr XYZBLoader::importFromBlob(
         if (auto modelDesc_ = modelDesc.lock())
         {
             const auto newRadius = property.template get<double>();
-            for (auto& sphere : modelDesc_->getModel().getSpheres()[materialId])
+            for (auto& sphere : modelDesc_->getModel().getSpheres(materialId))
                 sphere.radius = newRadius;
         }
     });
@@ -24,6 +24,7 @@ namespace
 {
 constexpr auto PARAM_ANIMATION_FRAME = "animation-frame";
 constexpr auto PARAM_PLAY_ANIMATION = "play-animation";
+constexpr auto PARAM_PREFETCH_FRAMES = "animation-prefetch-frames";
 }
 
 namespace brayns
@@ -35,13 +36,17 @@ AnimationParameters::AnimationParameters()
                               po::value<uint32_t>(&_current),
                               "Scene animation frame [uint]")(
         PARAM_PLAY_ANIMATION, po::bool_switch(&_playing)->default_value(false),
-        "Start animation playback");
+        "Start animation playback")(
+        PARAM_PREFETCH_FRAMES, po::value<uint32_t>(&_prefetchFrames),
+        "Number of simulation frames loaded ahead during playback [uint]");
 }
 
 void AnimationParameters::print()
 {
     AbstractParameters::print();
     BRAYNS_INFO << "Animation frame          : " << _current << std::endl;
+    BRAYNS_INFO << "Prefetched frames        : " << _prefetchFrames
+                << std::endl;
 }
 
 void AnimationParameters::reset()
@@ -97,6 +97,15 @@ public:
 
     void togglePlayback() { _playing = !_playing; }
     bool isPlaying() const { return _playing; }
+    /**
+     * The number of simulation frames, in the direction of the delta, that are
+     * loaded in the background while the animation is playing.
+     */
+    void setPrefetchFrames(const uint32_t frames)
+    {
+        _updateValue(_prefetchFrames, frames);
+    }
+    uint32_t getPrefetchFrames() const { return _prefetchFrames; }
 private:
     uint32_t _adjustedCurrent(const uint32_t newCurrent) const
     {
@@ -109,6 +118,7 @@ private:
     uint32_t _current{0};
     int32_t _delta{1};
     bool _playing{false};
+    uint32_t _prefetchFrames{4};
     double _dt{0};
     std::string _unit;
 
@@ -29,6 +29,7 @@ const std::string PARAM_HTTP_SERVER = "http-server";
 const std::string PARAM_IMAGE_STREAM_FPS = "image-stream-fps";
 const std::string PARAM_INPUT_PATHS = "input-paths";
 const std::string PARAM_JPEG_COMPRESSION = "jpeg-compression";
+const std::string PARAM_JPEG_DELTA_ENCODING = "jpeg-delta-encoding";
 const std::string PARAM_MAX_RENDER_FPS = "max-render-fps";
 const std::string PARAM_MODULE = "module";
 const std::string PARAM_PARALLEL_RENDERING = "parallel-rendering";
@@ -73,6 +74,9 @@ ApplicationParameters::ApplicationParameters()
          "Enable benchmarking") //
         (PARAM_JPEG_COMPRESSION.c_str(), po::value<size_t>(&_jpegCompression),
          "JPEG compression rate (100 is full quality) [int]") //
+        (PARAM_JPEG_DELTA_ENCODING.c_str(),
+         po::bool_switch(&_jpegDeltaEncoding)->default_value(false),
+         "Only re-encode the changed parts of the JPEG stream images") //
         (PARAM_PARALLEL_RENDERING.c_str(),
          po::bool_switch(&_parallelRendering)->default_value(false),
          "Enable parallel rendering, equivalent to --osp:mpi") //
@@ -117,6 +121,8 @@ void ApplicationParameters::print()
                 << std::endl;
     BRAYNS_INFO << "JPEG Compression            : " << _jpegCompression
                 << std::endl;
+    BRAYNS_INFO << "JPEG delta encoding         : "
+                << asString(_jpegDeltaEncoding) << std::endl;
     BRAYNS_INFO << "Image stream FPS            : " << _imageStreamFPS
                 << std::endl;
     BRAYNS_INFO << "Max. render  FPS            : " << _maxRenderFPS
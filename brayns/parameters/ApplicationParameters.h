@@ -71,6 +71,12 @@ public:
         _updateValue(_jpegCompression, compression);
     }
     size_t getJpegCompression() const { return _jpegCompression; }
+    /** Re-encode only the changed strips of the JPEG stream images */
+    bool useJpegDeltaEncoding() const { return _jpegDeltaEncoding; }
+    void setJpegDeltaEncoding(const bool enabled)
+    {
+        _updateValue(_jpegDeltaEncoding, enabled);
+    }
     /** Image stream FPS */
     size_t getImageStreamFPS() const { return _imageStreamFPS; }
     void setImageStreamFPS(const size_t fps)
@@ -100,6 +106,7 @@ protected:
     Vector2d _windowSize;
     bool _benchmarking{false};
     size_t _jpegCompression;
+    bool _jpegDeltaEncoding{false};
     bool _stereo{false};
     size_t _imageStreamFPS{60};
     size_t _maxRenderFPS{std::numeric_limits<size_t>::max()};
@@ -22,6 +22,8 @@
 #include <brayns/common/log.h>
 #include <brayns/common/types.h>
 
+#include <limits>
+
 namespace
 {
 const std::string PARAM_COLOR_SCHEME = "color-scheme";
@@ -29,12 +31,14 @@ const std::string PARAM_GEOMETRY_QUALITY = "geometry-quality";
 const std::string PARAM_RADIUS_MULTIPLIER = "radius-multiplier";
 const std::string PARAM_MEMORY_MODE = "memory-mode";
 const std::string PARAM_DEFAULT_BVH_FLAG = "default-bvh-flag";
+const std::string PARAM_SDF_MAX_STEPS = "sdf-max-steps";
 
 const std::array<std::string, 5> COLOR_SCHEMES = {
     {"none", "by-id", "protein-atoms", "protein-chains", "protein-residues"}};
 
 const std::string GEOMETRY_QUALITIES[3] = {"low", "medium", "high"};
-const std::string GEOMETRY_MEMORY_MODES[2] = {"shared", "replicated"};
+const std::string GEOMETRY_MEMORY_MODES[3] = {"shared", "replicated",
+                                              "compact"};
 const std::map<std::string, brayns::BVHFlag> BVH_TYPES = {
     {"dynamic", brayns::BVHFlag::dynamic},
     {"compact", brayns::BVHFlag::compact},
@@ -60,12 +64,16 @@ GeometryParameters::GeometryParameters()
         //
         (PARAM_MEMORY_MODE.c_str(), po::value<std::string>(),
          "Defines what memory mode should be used between Brayns and "
-         "the underlying renderer [shared|replicated]")
+         "the underlying renderer [shared|replicated|compact]")
         //
         (PARAM_DEFAULT_BVH_FLAG.c_str(),
          po::value<std::vector<std::string>>()->multitoken(),
          "Set a default flag to apply to BVH creation, one of "
-         "[dynamic|compact|robust], may appear multiple times.");
+         "[dynamic|compact|robust], may appear multiple times.")
+        //
+        (PARAM_SDF_MAX_STEPS.c_str(), po::value<size_t>(),
+         "Maximum number of sphere tracing steps per SDF geometry and ray "
+         "[int]");
 }
 
 void GeometryParameters::parse(const po::variables_map& vm)
@@ -98,6 +106,15 @@ void GeometryParameters::parse(const po::variables_map& vm)
     }
     if (vm.count(PARAM_RADIUS_MULTIPLIER))
         _radiusMultiplier = vm[PARAM_RADIUS_MULTIPLIER].as<float>();
+    if (vm.count(PARAM_SDF_MAX_STEPS))
+    {
+        // The geometry takes the number of steps as a 32 bits integer
+        const size_t maxSteps = std::numeric_limits<int32_t>::max();
+        _sdfMaxSteps = vm[PARAM_SDF_MAX_STEPS].as<size_t>();
+        if (_sdfMaxSteps == 0 || _sdfMaxSteps > maxSteps)
+            throw po::error("sdf-max-steps must be between 1 and " +
+                            std::to_string(maxSteps));
+    }
     if (vm.count(PARAM_MEMORY_MODE))
     {
         const auto& memoryMode = vm[PARAM_MEMORY_MODE].as<std::string>();
@@ -136,7 +153,9 @@ void GeometryParameters::print()
     BRAYNS_INFO << "Radius multiplier          : " << _radiusMultiplier
                 << std::endl;
     BRAYNS_INFO << "Memory mode                : "
-                << (_memoryMode == MemoryMode::shared ? "Shared" : "Replicated")
+                << GEOMETRY_MEMORY_MODES[static_cast<size_t>(_memoryMode)]
+                << std::endl;
+    BRAYNS_INFO << "SDF max steps              : " << _sdfMaxSteps
                 << std::endl;
 }
 }
@@ -54,6 +54,11 @@ public:
     {
         return _defaultBVHFlags;
     }
+    /**
+     * Maximum number of sphere tracing steps per SDF geometry and ray, the
+     * closest point found so far is used as hit once exhausted
+     */
+    size_t getSDFMaxSteps() const { return _sdfMaxSteps; }
 
 protected:
     void parse(const po::variables_map& vm) final;
@@ -65,6 +70,7 @@ protected:
     ColorScheme _colorScheme{ColorScheme::none};
     GeometryQuality _geometryQuality{GeometryQuality::high};
     float _radiusMultiplier{1};
+    size_t _sdfMaxSteps{100};
 
     // System parameters
     MemoryMode _memoryMode{MemoryMode::shared};
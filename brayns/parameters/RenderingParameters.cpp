@@ -23,6 +23,7 @@
 namespace
 {
 const std::string PARAM_ACCUMULATION = "disable-accumulation";
+const std::string PARAM_ADAPTIVE_SUBSAMPLING = "adaptive-subsampling";
 const std::string PARAM_BACKGROUND_COLOR = "background-color";
 const std::string PARAM_CAMERA = "camera";
 const std::string PARAM_HEAD_LIGHT = "no-head-light";
@@ -31,6 +32,8 @@ const std::string PARAM_RENDERER = "renderer";
 const std::string PARAM_SPP = "samples-per-pixel";
 const std::string PARAM_SUBSAMPLING = "subsampling";
 const std::string PARAM_VARIANCE_THRESHOLD = "variance-threshold";
+
+const uint32_t DEFAULT_MAX_ADAPTIVE_SUBSAMPLING = 8;
 }
 
 namespace brayns
@@ -45,6 +48,10 @@ RenderingParameters::RenderingParameters()
          "Number of samples per pixel [uint]") //
         (PARAM_SUBSAMPLING.c_str(), po::value<uint32_t>(&_subsampling),
          "Subsampling factor [uint]") //
+        (PARAM_ADAPTIVE_SUBSAMPLING.c_str(),
+         po::bool_switch(&_adaptiveSubsampling)->default_value(false),
+         "Adapt the subsampling factor to the max render FPS, up to the "
+         "subsampling factor or 8 if it is not set") //
         (PARAM_ACCUMULATION.c_str(), po::bool_switch()->default_value(false),
          "Disable accumulation") //
         (PARAM_BACKGROUND_COLOR.c_str(), po::fixed_tokens_value<floats>(3, 3),
@@ -87,6 +94,12 @@ void RenderingParameters::parse(const po::variables_map& vm)
     markModified();
 }
 
+uint32_t RenderingParameters::getMaxAdaptiveSubsampling() const
+{
+    // Also applies if adaptive subsampling is turned on at runtime
+    return _subsampling > 1 ? _subsampling : DEFAULT_MAX_ADAPTIVE_SUBSAMPLING;
+}
+
 void RenderingParameters::print()
 {
     AbstractParameters::print();
@@ -104,5 +117,11 @@ void RenderingParameters::print()
                 << asString(_accumulation) << std::endl;
     BRAYNS_INFO << "Max. accumulation frames          : " << _maxAccumFrames
                 << std::endl;
+    if (_adaptiveSubsampling)
+        BRAYNS_INFO << "Subsampling                       : adaptive up to "
+                    << getMaxAdaptiveSubsampling() << std::endl;
+    else
+        BRAYNS_INFO << "Subsampling                       : " << _subsampling
+                    << std::endl;
 }
 }
@@ -70,6 +70,20 @@ public:
     {
         _updateValue(_subsampling, std::max(1u, subsampling));
     }
+    /**
+     * If the subsampling factor of interactive frames is adapted to reach the
+     * max render FPS, up to getMaxAdaptiveSubsampling().
+     */
+    bool getAdaptiveSubsampling() const { return _adaptiveSubsampling; }
+    void setAdaptiveSubsampling(const bool value)
+    {
+        _updateValue(_adaptiveSubsampling, value);
+    }
+    /**
+     * @return the highest factor of adaptive subsampling: the subsampling
+     *         factor if one is set, a default otherwise
+     */
+    uint32_t getMaxAdaptiveSubsampling() const;
     const Vector3d& getBackgroundColor() const { return _backgroundColor; }
     void setBackgroundColor(const Vector3d& value)
     {
@@ -116,6 +130,7 @@ protected:
     std::deque<std::string> _cameras;
     uint32_t _spp{1};
     uint32_t _subsampling{1};
+    bool _adaptiveSubsampling{false};
     bool _accumulation{true};
     Vector3d _backgroundColor{0., 0., 0.};
     bool _headLight{true};
@@ -113,6 +113,14 @@ void OptiXFrameBuffer::map()
     _mapUnsafe();
 }
 
+bool OptiXFrameBuffer::tryMap()
+{
+    if (!_mapMutex.try_lock())
+        return false;
+    _mapUnsafe();
+    return true;
+}
+
 void OptiXFrameBuffer::_mapUnsafe()
 {
     rtBufferMap(_frameBuffer->get(), &_imageData);
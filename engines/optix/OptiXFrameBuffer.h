@@ -42,6 +42,7 @@ public:
     void resize(const Vector2ui& size) final;
     void map() final;
     void unmap() final;
+    bool tryMap() final;
     void setAccumulation(const bool accumulation) final;
 
     std::unique_lock<std::mutex> getScopeLock()
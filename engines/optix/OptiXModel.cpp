@@ -59,6 +59,16 @@ void setBuffer(RTbuffertype bufferType, RTformat bufferFormat,
                  numElements, sizeof(T) * src.size());
 }
 
+template <typename T>
+void setBuffer(RTbuffertype bufferType, RTformat bufferFormat,
+               optix::Handle<optix::BufferObj>& buffer,
+               optix::Handle<optix::VariableObj> geometry,
+               const GeometryView<T>& src, const size_t numElements)
+{
+    setBufferRaw(bufferType, bufferFormat, buffer, geometry, src.data,
+                 numElements, sizeof(T) * src.size);
+}
+
 OptiXModel::OptiXModel(AnimationParameters& animationParameters,
                        VolumeParameters& volumeParameters)
     : Model(animationParameters, volumeParameters)
@@ -82,26 +92,23 @@ void OptiXModel::commitGeometry()
     size_t nbSpheres = 0;
     size_t nbCylinders = 0;
     size_t nbCones = 0;
-    if (_spheresDirty)
-        for (const auto& spheres : _geometries->_spheres)
-        {
-            nbSpheres += spheres.second.size();
-            _commitSpheres(spheres.first);
-        }
-
-    if (_cylindersDirty)
-        for (const auto& cylinders : _geometries->_cylinders)
-        {
-            nbCylinders += cylinders.second.size();
-            _commitCylinders(cylinders.first);
-        }
-
-    if (_conesDirty)
-        for (const auto& cones : _geometries->_cones)
-        {
-            nbCones += cones.second.size();
-            _commitCones(cones.first);
-        }
+    for (const auto materialId : _getDirtySphereMaterials())
+    {
+        nbSpheres += getSpheresView(materialId).size;
+        _commitSpheres(materialId);
+    }
+
+    for (const auto materialId : _getDirtyCylinderMaterials())
+    {
+        nbCylinders += getCylindersView(materialId).size;
+        _commitCylinders(materialId);
+    }
+
+    for (const auto materialId : _getDirtyConeMaterials())
+    {
+        nbCones += getConesView(materialId).size;
+        _commitCones(materialId);
+    }
 
     if (_triangleMeshesDirty)
         for (const auto& meshes : _geometries->_triangleMeshes)
@@ -129,17 +136,17 @@ void OptiXModel::_commitSpheres(const size_t materialId)
         return;
 
     auto context = OptiXContext::get().getOptixContext();
-    const auto& spheres = _geometries->_spheres[materialId];
+    const auto spheres = getSpheresView(materialId);
     context["sphere_size"]->setUint(sizeof(Sphere) / sizeof(float));
 
     // Geometry
     _optixSpheres[materialId] =
         OptiXContext::get().createGeometry(OptixGeometryType::sphere);
-    _optixSpheres[materialId]->setPrimitiveCount(spheres.size());
+    _optixSpheres[materialId]->setPrimitiveCount(spheres.size);
 
     setBuffer(RT_BUFFER_INPUT, RT_FORMAT_FLOAT, _spheresBuffers[materialId],
               _optixSpheres[materialId]["spheres"], spheres,
-              sizeof(Sphere) * spheres.size());
+              sizeof(Sphere) * spheres.size);
 
     // Material
     auto& mat = static_cast<OptiXMaterial&>(*_materials[materialId]);
@@ -165,17 +172,17 @@ void OptiXModel::_commitCylinders(const size_t materialId)
         return;
 
     auto context = OptiXContext::get().getOptixContext();
-    const auto& cylinders = _geometries->_cylinders[materialId];
+    const auto cylinders = getCylindersView(materialId);
     context["cylinder_size"]->setUint(sizeof(Cylinder) / sizeof(float));
     _optixCylinders[materialId] =
         OptiXContext::get().createGeometry(OptixGeometryType::cylinder);
 
     auto& optixCylinders = _optixCylinders[materialId];
-    optixCylinders->setPrimitiveCount(cylinders.size());
+    optixCylinders->setPrimitiveCount(cylinders.size);
 
     setBuffer(RT_BUFFER_INPUT, RT_FORMAT_FLOAT, _cylindersBuffers[materialId],
               _optixCylinders[materialId]["cylinders"], cylinders,
-              sizeof(Cylinder) * cylinders.size());
+              sizeof(Cylinder) * cylinders.size);
 
     auto& mat = static_cast<OptiXMaterial&>(*_materials[materialId]);
     const auto material = mat.getOptixMaterial();
@@ -198,17 +205,17 @@ void OptiXModel::_commitCones(const size_t materialId)
         return;
 
     auto context = OptiXContext::get().getOptixContext();
-    const auto& cones = _geometries->_cones[materialId];
+    const auto cones = getConesView(materialId);
     context["cone_size"]->setUint(sizeof(Cone) / sizeof(float));
     _optixCones[materialId] =
         OptiXContext::get().createGeometry(OptixGeometryType::cone);
 
     auto& optixCones = _optixCones[materialId];
-    optixCones->setPrimitiveCount(cones.size());
+    optixCones->setPrimitiveCount(cones.size);
 
     setBuffer(RT_BUFFER_INPUT, RT_FORMAT_FLOAT, _conesBuffers[materialId],
               _optixCones[materialId]["cones"], cones,
-              sizeof(Cone) * cones.size());
+              sizeof(Cone) * cones.size);
 
     auto& mat = static_cast<OptiXMaterial&>(*_materials[materialId]);
     auto material = mat.getOptixMaterial();
@@ -133,6 +133,14 @@ void OSPRayFrameBuffer::map()
     _mapUnsafe();
 }
 
+bool OSPRayFrameBuffer::tryMap()
+{
+    if (!_mapMutex.try_lock())
+        return false;
+    _mapUnsafe();
+    return true;
+}
+
 void OSPRayFrameBuffer::_mapUnsafe()
 {
     if (_frameBufferFormat == FrameBufferFormat::none)
@@ -39,6 +39,7 @@ public:
     void resize(const Vector2ui& frameSize) final;
     void map() final;
     void unmap() final;
+    bool tryMap() final;
     void setAccumulation(const bool accumulation) final;
     void setFormat(FrameBufferFormat frameBufferFormat) final;
     void setSubsampling(const size_t) final;
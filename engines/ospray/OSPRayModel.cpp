@@ -28,10 +28,15 @@
 #include <brayns/engine/Scene.h>
 #include <brayns/parameters/AnimationParameters.h>
 
+#include <algorithm>
+
 namespace brayns
 {
 namespace
 {
+// Entries of the baked transfer function shared with the renderers
+const size_t TRANSFER_FUNCTION_LOOKUP_SIZE = 1024;
+
 template <typename VecT>
 OSPData allocateVectorData(const std::vector<VecT>& vec,
                            const OSPDataType ospType,
@@ -41,6 +46,16 @@ OSPData allocateVectorData(const std::vector<VecT>& vec,
     return ospNewData(totBytes / ospray::sizeOf(ospType), ospType, vec.data(),
                       memoryManagementFlags);
 }
+
+template <typename T>
+OSPData allocateVectorData(const GeometryView<T>& view,
+                           const OSPDataType ospType,
+                           const size_t memoryManagementFlags)
+{
+    const size_t totBytes = view.size * sizeof(T);
+    return ospNewData(totBytes / ospray::sizeOf(ospType), ospType, view.data,
+                      memoryManagementFlags);
+}
 } // namespace
 
 OSPRayModel::OSPRayModel(AnimationParameters& animationParameters,
@@ -55,7 +70,8 @@ OSPRayModel::OSPRayModel(AnimationParameters& animationParameters,
 OSPRayModel::~OSPRayModel()
 {
     ospRelease(_ospTransferFunction);
-    ospRelease(_ospSimulationData);
+    for (auto& buffer : _simulationBuffers)
+        ospRelease(buffer.data);
 
     const auto releaseAndClearGeometry = [](auto& geometryMap) {
         for (auto geom : geometryMap)
@@ -166,12 +182,39 @@ OSPGeometry& OSPRayModel::_createGeometry(GeometryMap& map,
     return geometry;
 }
 
+template <typename T>
+void OSPRayModel::_commitCompactGeometry(GeometryMap& map,
+                                        const size_t materialId,
+                                        const char* name,
+                                        const CompactGeometries<T>& geometries)
+{
+    auto& geometry = _createGeometry(map, materialId, name);
+
+    auto data = allocateVectorData(geometries.primitives, OSP_UCHAR,
+                                   _memoryManagementFlags);
+    ospSetObject(geometry, "primitives", data);
+    ospRelease(data);
+
+    osphelper::set(geometry, "origin", geometries.origin);
+    osphelper::set(geometry, "scale", geometries.scale);
+    ospCommit(geometry);
+
+    _addGeometryToModel(geometry, materialId);
+}
+
 void OSPRayModel::_commitSpheres(const size_t materialId)
 {
+    if (_compactGeometry)
+    {
+        _commitCompactGeometry(_ospSpheres, materialId, "compactspheres",
+                               _compactSpheres(materialId));
+        return;
+    }
+
     auto& geometry = _createGeometry(_ospSpheres, materialId, "spheres");
 
-    auto data = allocateVectorData(_geometries->_spheres.at(materialId),
-                                   OSP_FLOAT, _memoryManagementFlags);
+    auto data = allocateVectorData(getSpheresView(materialId), OSP_FLOAT,
+                                   _memoryManagementFlags);
 
     ospSetObject(geometry, "spheres", data);
     ospRelease(data);
@@ -189,10 +232,17 @@ void OSPRayModel::_commitSpheres(const size_t materialId)
 
 void OSPRayModel::_commitCylinders(const size_t materialId)
 {
+    if (_compactGeometry)
+    {
+        _commitCompactGeometry(_ospCylinders, materialId, "compactcylinders",
+                               _compactCylinders(materialId));
+        return;
+    }
+
     auto& geometry = _createGeometry(_ospCylinders, materialId, "cylinders");
 
-    auto data = allocateVectorData(_geometries->_cylinders.at(materialId),
-                                   OSP_FLOAT, _memoryManagementFlags);
+    auto data = allocateVectorData(getCylindersView(materialId), OSP_FLOAT,
+                                   _memoryManagementFlags);
     ospSetObject(geometry, "cylinders", data);
     ospRelease(data);
 
@@ -211,9 +261,16 @@ void OSPRayModel::_commitCylinders(const size_t materialId)
 
 void OSPRayModel::_commitCones(const size_t materialId)
 {
+    if (_compactGeometry)
+    {
+        _commitCompactGeometry(_ospCones, materialId, "compactcones",
+                               _compactCones(materialId));
+        return;
+    }
+
     auto& geometry = _createGeometry(_ospCones, materialId, "cones");
-    auto data = allocateVectorData(_geometries->_cones.at(materialId),
-                                   OSP_FLOAT, _memoryManagementFlags);
+    auto data = allocateVectorData(getConesView(materialId), OSP_FLOAT,
+                                   _memoryManagementFlags);
 
     ospSetObject(geometry, "cones", data);
     ospRelease(data);
@@ -353,6 +410,7 @@ void OSPRayModel::_commitSDFGeometries()
 
         ospSetData(geometry, "neighbours", neighbourData);
         ospSetData(geometry, "geometries", globalData);
+        osphelper::set(geometry, "maxSteps", int32_t(_sdfMaxSteps));
 
         ospCommit(geometry);
 
@@ -384,31 +442,27 @@ void OSPRayModel::commitGeometry()
     if (!isDirty())
         return;
 
-    if (!_primaryModel)
-        _primaryModel = ospNewModel();
-
     // Materials
     for (auto material : _materials)
         material.second->commit();
 
-    // Group geometry
-    if (_spheresDirty)
-    {
-        for (const auto& spheres : _geometries->_spheres)
-            _commitSpheres(spheres.first);
-    }
+    // Added or removed instances are handled by the scene and do not require
+    // to rebuild the models
+    if (_primaryModel && !_areGeometriesDirty() && !_streamlinesDirty)
+        return;
 
-    if (_cylindersDirty)
-    {
-        for (const auto& cylinders : _geometries->_cylinders)
-            _commitCylinders(cylinders.first);
-    }
+    if (!_primaryModel)
+        _primaryModel = ospNewModel();
 
-    if (_conesDirty)
-    {
-        for (const auto& cones : _geometries->_cones)
-            _commitCones(cones.first);
-    }
+    // Group geometry, only for the materials that have been modified
+    for (const auto materialId : _getDirtySphereMaterials())
+        _commitSpheres(materialId);
+
+    for (const auto materialId : _getDirtyCylinderMaterials())
+        _commitCylinders(materialId);
+
+    for (const auto materialId : _getDirtyConeMaterials())
+        _commitCones(materialId);
 
     if (_triangleMeshesDirty)
     {
@@ -429,15 +483,13 @@ void OSPRayModel::commitGeometry()
     _markGeometriesClean();
     _setBVHFlags();
 
-    // handled by the scene
-    _instancesDirty = false;
-
     // Commit models
     ospCommit(_primaryModel);
     if (_secondaryModel)
         ospCommit(_secondaryModel);
     if (_boundingBoxModel)
         ospCommit(_boundingBoxModel);
+    ++_geometryVersion;
 }
 
 void OSPRayModel::commitMaterials(const std::string& renderer)
@@ -521,15 +573,67 @@ void OSPRayModel::_commitTransferFunctionImpl(const Vector3fs& colors,
     // Value range
     osphelper::set(_ospTransferFunction, "valueRange", Vector2f(valueRange));
 
+    // Baked RGBA table for renderers shading simulation data, read with a
+    // single lookup instead of evaluating the transfer function per sample
+    const auto lookupTable =
+        TransferFunction::calculateLookupTable(colors, opacities,
+                                               TRANSFER_FUNCTION_LOOKUP_SIZE);
+    OSPData lookupTableData =
+        ospNewData(lookupTable.size(), OSP_FLOAT4, lookupTable.data());
+    ospSetData(_ospTransferFunction, "lookupTable", lookupTableData);
+    ospRelease(lookupTableData);
+
     ospCommit(_ospTransferFunction);
 }
 
 void OSPRayModel::_commitSimulationDataImpl(const float* frameData,
                                             const size_t frameSize)
 {
-    ospRelease(_ospSimulationData);
-    _ospSimulationData =
-        ospNewData(frameSize, OSP_FLOAT, frameData, _memoryManagementFlags);
-    ospCommit(_ospSimulationData);
+    auto& buffers = _simulationBuffers;
+
+    // Replicated data is a copy of the frame, which is only valid until the
+    // handler loads another frame in the same buffer
+    if (_memoryManagementFlags != OSP_DATA_SHARED_BUFFER)
+    {
+        for (auto& buffer : buffers)
+            ospRelease(buffer.data);
+        buffers.resize(1);
+        buffers[0].data = ospNewData(frameSize, OSP_FLOAT, frameData,
+                                     _memoryManagementFlags);
+        ospCommit(buffers[0].data);
+        ++_simulationDataCount;
+        return;
+    }
+
+    // The handler cycles frames through the current frame and its prefetch
+    // ring, so the shared data of each of these buffers is created once
+    const size_t nbHandlerBuffers =
+        _simulationHandler ? _simulationHandler->getPrefetchWindow() + 2 : 2;
+    const auto isBufferOf = [frameData, frameSize](const auto& buffer) {
+        return buffer.frameData == frameData && buffer.frameSize == frameSize;
+    };
+    auto i = std::find_if(buffers.begin(), buffers.end(), isBufferOf);
+    if (i == buffers.end())
+    {
+        if (buffers.size() < nbHandlerBuffers)
+            i = buffers.insert(buffers.end(), SimulationBuffer());
+        else
+            i = buffers.end() - 1;
+        ospRelease(i->data);
+        i->data = ospNewData(frameSize, OSP_FLOAT, frameData,
+                             OSP_DATA_SHARED_BUFFER);
+        ospCommit(i->data);
+        ++_simulationDataCount;
+        i->frameData = frameData;
+        i->frameSize = frameSize;
+    }
+    std::rotate(buffers.begin(), i, i + 1);
+
+    // Buffers beyond a shrunk prefetch ring are the least recently used
+    while (buffers.size() > nbHandlerBuffers)
+    {
+        ospRelease(buffers.back().data);
+        buffers.pop_back();
+    }
 }
 } // namespace brayns
@@ -35,12 +35,30 @@ public:
 
     void setMemoryFlags(const size_t memoryManagementFlags);
 
+    /**
+     * Store spheres, cylinders and cones in their compact quantized form once
+     * committed, see MemoryMode::compact.
+     */
+    void setCompactGeometry(const bool compactGeometry)
+    {
+        _compactGeometry = compactGeometry;
+    }
+
+    /** Maximum number of sphere tracing steps per SDF geometry and ray. */
+    void setSDFMaxSteps(const size_t maxSteps) { _sdfMaxSteps = maxSteps; }
+
     void commitGeometry() final;
     void commitMaterials(const std::string& renderer);
 
     OSPModel getPrimaryModel() const { return _primaryModel; }
     OSPModel getSecondaryModel() const { return _secondaryModel; }
     OSPModel getBoundingBoxModel() const { return _boundingBoxModel; }
+
+    /**
+     * @return a counter that is increased each time the OSPRay models are
+     *         committed, which invalidates all instances of them.
+     */
+    size_t getGeometryVersion() const { return _geometryVersion; }
     SharedDataVolumePtr createSharedDataVolume(const Vector3ui& dimensions,
                                                const Vector3f& spacing,
                                                const DataType type) const final;
@@ -50,7 +68,13 @@ public:
 
     void buildBoundingBox() final;
 
-    OSPData simulationData() const { return _ospSimulationData; }
+    OSPData simulationData() const
+    {
+        return _simulationBuffers.empty() ? nullptr
+                                          : _simulationBuffers.front().data;
+    }
+    /** @return the number of simulation data created so far. */
+    size_t getSimulationDataCount() const { return _simulationDataCount; }
     OSPTransferFunction transferFunction() const
     {
         return _ospTransferFunction;
@@ -71,6 +95,10 @@ private:
     void _commitSpheres(const size_t materialId);
     void _commitCylinders(const size_t materialId);
     void _commitCones(const size_t materialId);
+    template <typename T>
+    void _commitCompactGeometry(GeometryMap& map, const size_t materialId,
+                                const char* name,
+                                const CompactGeometries<T>& geometries);
     void _commitMeshes(const size_t materialId);
     void _commitStreamlines(const size_t materialId);
     void _commitSDFGeometries();
@@ -86,8 +114,18 @@ private:
     // Bounding box
     size_t _boudingBoxMaterialId{0};
 
-    // Simulation model
-    OSPData _ospSimulationData{nullptr};
+    size_t _geometryVersion{0};
+
+    // Simulation model: one data per buffer of the simulation handler, the
+    // current frame first, followed by the most recently used ones
+    struct SimulationBuffer
+    {
+        OSPData data{nullptr};
+        const float* frameData{nullptr};
+        size_t frameSize{0};
+    };
+    std::vector<SimulationBuffer> _simulationBuffers;
+    size_t _simulationDataCount{0};
 
     OSPTransferFunction _ospTransferFunction{nullptr};
 
@@ -100,6 +138,8 @@ private:
     std::map<size_t, OSPGeometry> _ospSDFGeometries;
 
     size_t _memoryManagementFlags{OSP_DATA_SHARED_BUFFER};
+    bool _compactGeometry{false};
+    size_t _sdfMaxSteps{100};
 
     std::string _renderer;
 
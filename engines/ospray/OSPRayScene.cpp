@@ -40,9 +40,9 @@ OSPRayScene::OSPRayScene(AnimationParameters& animationParameters,
                          VolumeParameters& volumeParameters)
     : Scene(animationParameters, geometryParameters, volumeParameters)
     , _memoryManagementFlags(geometryParameters.getMemoryMode() ==
-                                     MemoryMode::shared
-                                 ? uint32_t(OSP_DATA_SHARED_BUFFER)
-                                 : 0)
+                                     MemoryMode::replicated
+                                 ? 0
+                                 : uint32_t(OSP_DATA_SHARED_BUFFER))
 {
     _backgroundMaterial = std::make_shared<OSPRayMaterial>(PropertyMap(), true);
 }
@@ -50,6 +50,12 @@ OSPRayScene::OSPRayScene(AnimationParameters& animationParameters,
 OSPRayScene::~OSPRayScene()
 {
     _destroyLights();
+    for (auto& committed : _committedModels)
+        for (auto& instance : committed.second.instances)
+        {
+            ospRelease(instance.second.primary);
+            ospRelease(instance.second.boundingBox);
+        }
     if (_rootModel)
         ospRelease(_rootModel);
 }
@@ -75,104 +81,203 @@ void OSPRayScene::commit()
         modelDescriptors = _modelDescriptors;
     }
 
-    const bool rebuildScene = isModified();
-    const bool addRemoveVolumes =
+    const auto modelsWithChangedVolumes =
         _commitVolumeAndTransferFunction(modelDescriptors);
 
-    if (!rebuildScene && !addRemoveVolumes)
+    if (!_rootModel)
+        _rootModel = ospNewModel();
+
+    bool rootModified = false;
+
+    // remove the models that have been removed from the scene or disabled
+    const std::set<ModelDescriptorPtr> sceneModels(modelDescriptors.begin(),
+                                                   modelDescriptors.end());
+    for (auto i = _committedModels.begin(); i != _committedModels.end();)
     {
-        // check for dirty models aka their geometry has been altered
-        bool doUpdate = false;
-        for (auto& modelDescriptor : modelDescriptors)
+        if (sceneModels.count(i->first) && i->first->getEnabled())
         {
-            auto& model = modelDescriptor->getModel();
-            if (model.isDirty())
-            {
-                model.commitGeometry();
-                // need to continue re-adding the models to update the bounding
-                // box model to reflect the new model size
-                doUpdate = true;
-            }
+            ++i;
+            continue;
         }
-        if (!doUpdate)
-            return;
-    }
-
-    _activeModels.clear();
 
-    if (_rootModel)
-        ospRelease(_rootModel);
-    _rootModel = ospNewModel();
+        for (auto& instance : i->second.instances)
+            _removeInstance(instance.second);
+        _removeVolumes(i->second);
+        i = _committedModels.erase(i);
+        rootModified = true;
+    }
 
-    for (auto modelDescriptor : modelDescriptors)
+    // only (re-)instance the models and instances that have been modified
+    for (auto& modelDescriptor : modelDescriptors)
     {
         if (!modelDescriptor->getEnabled())
             continue;
 
-        // keep models from being deleted via removeModel() as long as we use
-        // them here
-        _activeModels.push_back(modelDescriptor);
+        auto& committed = _committedModels[modelDescriptor];
+        const bool volumesChanged =
+            modelsWithChangedVolumes.count(modelDescriptor) > 0;
+        if (_commitModel(*modelDescriptor, volumesChanged, committed))
+            rootModified = true;
+    }
+
+    if (!rootModified)
+        return;
+
+    BRAYNS_DEBUG << "Committing root models" << std::endl;
+
+    ospCommit(_rootModel);
 
-        auto& impl = static_cast<OSPRayModel&>(modelDescriptor->getModel());
-        const auto& transformation = modelDescriptor->getTransformation();
+    _computeBounds();
+}
 
-        BRAYNS_DEBUG << "Committing " << modelDescriptor->getName()
+bool OSPRayScene::_commitModel(ModelDescriptor& modelDescriptor,
+                               const bool volumesChanged,
+                               CommittedModel& committed)
+{
+    auto& impl = static_cast<OSPRayModel&>(modelDescriptor.getModel());
+
+    // Instances flagged on the model rather than individually are all
+    // recommitted, the flag is cleared once they are
+    const bool instancesDirty = impl.areInstancesDirty();
+
+    if (impl.isDirty())
+    {
+        BRAYNS_DEBUG << "Committing " << modelDescriptor.getName()
                      << std::endl;
 
         impl.commitGeometry();
         impl.logInformation();
+    }
+
+    const auto& instances = modelDescriptor.getInstances();
+    const size_t firstInstanceID =
+        instances.empty() ? 0 : instances.front().getInstanceID();
+
+    // Rebuilt models invalidate all their instances. The model visibility,
+    // bounding box and transformation affect all instances as well.
+    const bool allInstancesDirty =
+        committed.geometryVersion != impl.getGeometryVersion() ||
+        modelDescriptor.isModified() ||
+        committed.firstInstanceID != firstInstanceID;
+
+    if (!allInstancesDirty && !volumesChanged && !instancesDirty &&
+        !modelDescriptor.areInstancesModified() &&
+        committed.instances.size() == instances.size())
+    {
+        return false;
+    }
+
+    if (allInstancesDirty || volumesChanged)
+    {
+        _removeVolumes(committed);
 
         // add volumes to root model, because scivis renderer does not consider
         // volumes from instances
-        if (modelDescriptor->getVisible())
+        if (modelDescriptor.getVisible())
         {
-            modelDescriptor->getModel().commitGeometry();
-            for (auto volume : modelDescriptor->getModel().getVolumes())
+            for (auto volume : impl.getVolumes())
             {
                 auto ospVolume =
-                    std::dynamic_pointer_cast<OSPRayVolume>(volume);
-                ospAddVolume(_rootModel, ospVolume->impl());
+                    std::dynamic_pointer_cast<OSPRayVolume>(volume)->impl();
+                ospAddVolume(_rootModel, ospVolume);
+                committed.volumes.push_back(ospVolume);
             }
         }
+    }
 
-        const auto& instances = modelDescriptor->getInstances();
-        for (size_t i = 0; i < instances.size(); ++i)
+    std::set<size_t> instanceIDs;
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        const auto& instance = instances[i];
+        const auto instanceID = instance.getInstanceID();
+        instanceIDs.insert(instanceID);
+
+        const bool isNew = committed.instances.count(instanceID) == 0;
+        auto& committedInstance = committed.instances[instanceID];
+        if (!isNew && !allInstancesDirty && !instancesDirty &&
+            !instance.isModified())
         {
-            const auto& instance = instances[i];
-
-            // First instance uses model transformation
-            const auto instanceTransform =
-                (i == 0 ? transformation : instance.getTransformation());
+            continue;
+        }
 
-            if (modelDescriptor->getBoundingBox() && instance.getBoundingBox())
-            {
-                // scale and move the unit-sized bounding box geometry to the
-                // model size/scale first, then apply the instance transform
-                const auto& modelBounds =
-                    modelDescriptor->getModel().getBounds();
-                Transformation modelTransform;
-                modelTransform.setTranslation(modelBounds.getCenter() /
-                                                  modelBounds.getSize() -
-                                              Vector3d(0.5));
-                modelTransform.setScale(modelBounds.getSize());
-
-                addInstance(_rootModel, impl.getBoundingBoxModel(),
-                            transformationToAffine3f(instanceTransform) *
-                                transformationToAffine3f(modelTransform));
-            }
+        _removeInstance(committedInstance);
+        _addInstance(modelDescriptor, instance, i == 0, committedInstance);
+    }
 
-            if (modelDescriptor->getVisible() && instance.getVisible())
-                addInstance(_rootModel, impl.getPrimaryModel(),
-                            instanceTransform);
+    for (auto i = committed.instances.begin(); i != committed.instances.end();)
+    {
+        if (instanceIDs.count(i->first))
+        {
+            ++i;
+            continue;
         }
+        _removeInstance(i->second);
+        i = committed.instances.erase(i);
+    }
+
+    committed.firstInstanceID = firstInstanceID;
+    committed.geometryVersion = impl.getGeometryVersion();
 
-        impl.markInstancesClean();
+    modelDescriptor.resetInstancesModified();
+    impl.markInstancesClean();
+    return true;
+}
+
+void OSPRayScene::_addInstance(const ModelDescriptor& modelDescriptor,
+                               const ModelInstance& instance,
+                               const bool isFirst, CommittedInstance& committed)
+{
+    const auto& impl =
+        static_cast<const OSPRayModel&>(modelDescriptor.getModel());
+
+    // First instance uses model transformation
+    const auto& instanceTransform = isFirst
+                                        ? modelDescriptor.getTransformation()
+                                        : instance.getTransformation();
+
+    if (modelDescriptor.getBoundingBox() && instance.getBoundingBox())
+    {
+        // scale and move the unit-sized bounding box geometry to the model
+        // size/scale first, then apply the instance transform
+        const auto& modelBounds = impl.getBounds();
+        Transformation modelTransform;
+        modelTransform.setTranslation(modelBounds.getCenter() /
+                                          modelBounds.getSize() -
+                                      Vector3d(0.5));
+        modelTransform.setScale(modelBounds.getSize());
+
+        committed.boundingBox =
+            createInstance(impl.getBoundingBoxModel(),
+                           transformationToAffine3f(instanceTransform) *
+                               transformationToAffine3f(modelTransform));
+        ospAddGeometry(_rootModel, committed.boundingBox);
     }
-    BRAYNS_DEBUG << "Committing root models" << std::endl;
 
-    ospCommit(_rootModel);
+    if (modelDescriptor.getVisible() && instance.getVisible())
+    {
+        committed.primary =
+            createInstance(impl.getPrimaryModel(), instanceTransform);
+        ospAddGeometry(_rootModel, committed.primary);
+    }
+}
 
-    _computeBounds();
+void OSPRayScene::_removeInstance(CommittedInstance& committed)
+{
+    for (auto geometry : {committed.primary, committed.boundingBox})
+    {
+        if (!geometry)
+            continue;
+        ospRemoveGeometry(_rootModel, geometry);
+        ospRelease(geometry);
+    }
+    committed = CommittedInstance();
+}
+
+void OSPRayScene::_removeVolumes(CommittedModel& committed)
+{
+    for (auto volume : committed.volumes)
+        ospRemoveVolume(_rootModel, volume);
+    committed.volumes.clear();
 }
 
 bool OSPRayScene::commitLights()
@@ -258,10 +363,10 @@ bool OSPRayScene::commitLights()
     return true;
 }
 
-bool OSPRayScene::_commitVolumeAndTransferFunction(
+std::set<ModelDescriptorPtr> OSPRayScene::_commitVolumeAndTransferFunction(
     ModelDescriptors& modelDescriptors)
 {
-    bool rebuildScene = false;
+    std::set<ModelDescriptorPtr> modelsWithChangedVolumes;
     for (auto& modelDescriptor : modelDescriptors)
     {
         auto& model = static_cast<OSPRayModel&>(modelDescriptor->getModel());
@@ -270,14 +375,15 @@ bool OSPRayScene::_commitVolumeAndTransferFunction(
 
         if (dirtyTransferFunction || dirtySimulationData)
             markModified(false);
-        if (model.isVolumesDirty())
+        const bool volumesChanged = model.isVolumesDirty();
+        if (volumesChanged)
         {
-            rebuildScene = true;
+            modelsWithChangedVolumes.insert(modelDescriptor);
             model.resetVolumesDirty();
         }
         for (auto volume : model.getVolumes())
         {
-            if (volume->isModified() || rebuildScene ||
+            if (volume->isModified() || volumesChanged ||
                 _volumeParameters.isModified())
             {
                 volume->commit();
@@ -286,13 +392,18 @@ bool OSPRayScene::_commitVolumeAndTransferFunction(
             }
         }
     }
-    return rebuildScene;
+    return modelsWithChangedVolumes;
 }
 
 ModelPtr OSPRayScene::createModel() const
 {
-    return std::make_unique<OSPRayModel>(_animationParameters,
-                                         _volumeParameters);
+    auto model = std::make_unique<OSPRayModel>(_animationParameters,
+                                               _volumeParameters);
+    model->setMemoryFlags(_memoryManagementFlags);
+    model->setCompactGeometry(_geometryParameters.getMemoryMode() ==
+                              MemoryMode::compact);
+    model->setSDFMaxSteps(_geometryParameters.getSDFMaxSteps());
+    return model;
 }
 
 ModelDescriptorPtr OSPRayScene::getSimulatedModel()
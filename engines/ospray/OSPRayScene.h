@@ -26,6 +26,9 @@
 
 #include <ospray.h>
 
+#include <map>
+#include <set>
+
 namespace brayns
 {
 /**
@@ -58,7 +61,31 @@ public:
     ModelDescriptorPtr getSimulatedModel();
 
 private:
-    bool _commitVolumeAndTransferFunction(ModelDescriptors& modelDescriptors);
+    /** The OSPRay instances of one ModelInstance in the root model. */
+    struct CommittedInstance
+    {
+        OSPGeometry primary{nullptr};
+        OSPGeometry boundingBox{nullptr};
+    };
+
+    /** The OSPRay objects of one ModelDescriptor in the root model. */
+    struct CommittedModel
+    {
+        std::map<size_t, CommittedInstance> instances;
+        std::vector<OSPVolume> volumes;
+        size_t firstInstanceID{0};
+        size_t geometryVersion{0};
+    };
+
+    std::set<ModelDescriptorPtr> _commitVolumeAndTransferFunction(
+        ModelDescriptors& modelDescriptors);
+    bool _commitModel(ModelDescriptor& modelDescriptor, bool volumesChanged,
+                      CommittedModel& committed);
+    void _addInstance(const ModelDescriptor& modelDescriptor,
+                      const ModelInstance& instance, bool isFirst,
+                      CommittedInstance& committed);
+    void _removeInstance(CommittedInstance& committed);
+    void _removeVolumes(CommittedModel& committed);
     void _destroyLights();
 
     OSPModel _rootModel{nullptr};
@@ -69,7 +96,9 @@ private:
 
     size_t _memoryManagementFlags{0};
 
-    ModelDescriptors _activeModels;
+    // keeps models from being deleted via removeModel() as long as they are
+    // part of the root model
+    std::map<ModelDescriptorPtr, CommittedModel> _committedModels;
 };
 } // namespace brayns
 #endif // OSPRAYSCENE_H
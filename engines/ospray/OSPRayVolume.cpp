@@ -115,6 +115,7 @@ void OSPRayBrickedVolume::setBrick(const void* data, const Vector3ui& position,
     ospSetRegion(_volume, const_cast<void*>(data), (osp::vec3i&)pos,
                  (osp::vec3i&)size);
     BrickedVolume::_sizeInBytes += glm::compMul(size_) * _dataSize;
+    _updateMacrocellRanges(data, position, size_);
     markModified();
 }
 
@@ -126,6 +127,7 @@ void OSPRaySharedDataVolume::setVoxels(const void* voxels)
         glm::compMul(SharedDataVolume::_dimensions) * _dataSize;
     ospSetData(_volume, "voxelData", data);
     ospRelease(data);
+    _updateMacrocellRanges(voxels, {0, 0, 0}, SharedDataVolume::_dimensions);
     markModified();
 }
 
@@ -152,8 +154,23 @@ void OSPRayVolume::commit()
         osphelper::set(_volume, "volumeClippingBoxUpper",
                        Vector3f(_parameters.getClipBox().getMax()));
     }
+    if (_macrocellOpacitiesModified)
+        _commitMacrocells();
     if (isModified() || _parameters.isModified())
         ospCommit(_volume);
     resetModified();
 }
+
+void OSPRayVolume::_commitMacrocells()
+{
+    // Not used by OSPRay itself, renderers read them for empty space skipping
+    const auto& opacities = getMacrocellOpacities();
+    OSPData data = ospNewData(opacities.size(), OSP_FLOAT, opacities.data());
+    ospSetData(_volume, "macrocellOpacities", data);
+    ospRelease(data);
+    osphelper::set(_volume, "macrocellDimensions",
+                   Vector3i(getMacrocellDimensions()));
+    osphelper::set(_volume, "macrocellSize", getMacrocellSize());
+    _macrocellOpacitiesModified = false;
+}
 } // namespace brayns
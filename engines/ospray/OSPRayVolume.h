@@ -41,6 +41,8 @@ public:
 
     OSPVolume impl() const { return _volume; }
 protected:
+    void _commitMacrocells();
+
     size_t _dataSize{0};
     const VolumeParameters& _parameters;
     OSPVolume _volume;
@@ -0,0 +1,72 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Brayns
+#include <brayns/common/geometry/CompactGeometry.h>
+
+// ospray
+#include "CompactCones.h"
+#include "ospray/SDK/common/Data.h"
+#include "ospray/SDK/common/Model.h"
+// ispc-generated files
+#include "CompactCones_ispc.h"
+
+namespace ospray
+{
+CompactCones::CompactCones()
+{
+    this->ispcEquivalent = ispc::CompactCones_create(this);
+}
+
+void CompactCones::finalize(ospray::Model* model)
+{
+    data = getParamData("primitives", nullptr);
+    if (data.ptr == nullptr)
+        throw std::runtime_error(
+            "#ospray:geometry/compactcones: no 'primitives' data specified");
+
+    const vec3f ospOrigin = getParam3f("origin", vec3f(0.f));
+    const float scale = getParam1f("scale", 1.f);
+    const brayns::Vector3f origin(ospOrigin.x, ospOrigin.y, ospOrigin.z);
+
+    const size_t numPrimitives = data->numBytes / sizeof(brayns::CompactCone);
+
+    bounds = empty;
+    const auto primitives = static_cast<brayns::CompactCone*>(data->data);
+    for (size_t i = 0; i < numPrimitives; i++)
+    {
+        const brayns::CompactCone& primitive = primitives[i];
+        const auto center =
+            brayns::decodePosition(origin, scale, primitive.center);
+        const auto up = brayns::decodePosition(origin, scale, primitive.up);
+        const float centerRadius = brayns::decodeRadius(primitive.centerRadius);
+        const float upRadius = brayns::decodeRadius(primitive.upRadius);
+        bounds.extend(vec3f(center.x, center.y, center.z) - centerRadius);
+        bounds.extend(vec3f(center.x, center.y, center.z) + centerRadius);
+        bounds.extend(vec3f(up.x, up.y, up.z) - upRadius);
+        bounds.extend(vec3f(up.x, up.y, up.z) + upRadius);
+    }
+
+    ispc::CompactConesGeometry_set(getIE(), model->getIE(), data->data,
+                                   numPrimitives, (ispc::vec3f&)ospOrigin,
+                                   scale);
+}
+
+OSP_REGISTER_GEOMETRY(CompactCones, compactcones);
+
+} // ::brayns
@@ -0,0 +1,71 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Brayns
+#include <brayns/common/geometry/CompactGeometry.h>
+
+// ospray
+#include "CompactCylinders.h"
+#include "ospray/SDK/common/Data.h"
+#include "ospray/SDK/common/Model.h"
+// ispc-generated files
+#include "CompactCylinders_ispc.h"
+
+namespace ospray
+{
+CompactCylinders::CompactCylinders()
+{
+    this->ispcEquivalent = ispc::CompactCylinders_create(this);
+}
+
+void CompactCylinders::finalize(ospray::Model* model)
+{
+    data = getParamData("primitives", nullptr);
+    if (data.ptr == nullptr)
+        throw std::runtime_error("#ospray:geometry/compactcylinders: no "
+                                 "'primitives' data specified");
+
+    const vec3f ospOrigin = getParam3f("origin", vec3f(0.f));
+    const float scale = getParam1f("scale", 1.f);
+    const brayns::Vector3f origin(ospOrigin.x, ospOrigin.y, ospOrigin.z);
+
+    const size_t numPrimitives =
+        data->numBytes / sizeof(brayns::CompactCylinder);
+
+    bounds = empty;
+    const auto primitives = static_cast<brayns::CompactCylinder*>(data->data);
+    for (size_t i = 0; i < numPrimitives; i++)
+    {
+        const brayns::CompactCylinder& primitive = primitives[i];
+        const auto v0 = brayns::decodePosition(origin, scale, primitive.center);
+        const auto v1 = brayns::decodePosition(origin, scale, primitive.up);
+        const float radius = brayns::decodeRadius(primitive.radius);
+        bounds.extend(vec3f(v0.x, v0.y, v0.z) - radius);
+        bounds.extend(vec3f(v0.x, v0.y, v0.z) + radius);
+        bounds.extend(vec3f(v1.x, v1.y, v1.z) - radius);
+        bounds.extend(vec3f(v1.x, v1.y, v1.z) + radius);
+    }
+
+    ispc::CompactCylindersGeometry_set(getIE(), model->getIE(), data->data,
+                                       numPrimitives, (ispc::vec3f&)ospOrigin,
+                                       scale);
+}
+
+OSP_REGISTER_GEOMETRY(CompactCylinders, compactcylinders);
+
+} // ::brayns
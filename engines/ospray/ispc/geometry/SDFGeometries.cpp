@@ -51,6 +51,7 @@ void SDFGeometries::finalize(ospray::Model* model)
 
     const size_t numSDFGeometries = data->numItems;
     const size_t numNeighbours = neighbours->numItems;
+    const int maxSteps = getParam1i("maxSteps", 100);
 
     bounds = empty;
     const auto geoms = static_cast<brayns::SDFGeometry*>(geometries->data);
@@ -68,7 +69,8 @@ void SDFGeometries::finalize(ospray::Model* model)
 
     ispc::SDFGeometriesGeometry_set(getIE(), model->getIE(), data->data,
                                     numSDFGeometries, neighbours->data,
-                                    numNeighbours, geometries->data);
+                                    numNeighbours, geometries->data,
+                                    maxSteps);
 }
 
 OSP_REGISTER_GEOMETRY(SDFGeometries, sdfgeometries);
@@ -183,23 +183,16 @@ ospcommon::affine3f transformationToAffine3f(
                                            float(-rotationCenter.z)});
 }
 
-void addInstance(OSPModel rootModel, OSPModel modelToAdd,
-                 const Transformation& transform)
+OSPGeometry createInstance(OSPModel model, const Transformation& transform)
 {
-    auto affine = transformationToAffine3f(transform);
-    OSPGeometry instance = ospNewInstance(modelToAdd, (osp::affine3f&)affine);
-    ospCommit(instance);
-    ospAddGeometry(rootModel, instance);
-    ospRelease(instance);
+    return createInstance(model, transformationToAffine3f(transform));
 }
 
-void addInstance(OSPModel rootModel, OSPModel modelToAdd,
-                 const ospcommon::affine3f& affine)
+OSPGeometry createInstance(OSPModel model, const ospcommon::affine3f& affine)
 {
-    OSPGeometry instance = ospNewInstance(modelToAdd, (osp::affine3f&)affine);
+    OSPGeometry instance = ospNewInstance(model, (osp::affine3f&)affine);
     ospCommit(instance);
-    ospAddGeometry(rootModel, instance);
-    ospRelease(instance);
+    return instance;
 }
 
 namespace osphelper
@@ -42,11 +42,12 @@ void fromOSPRayProperties(PropertyMap& object,
 ospcommon::affine3f transformationToAffine3f(
     const Transformation& transformation);
 
-/** Helper to add the given model as an instance to the given root model. */
-void addInstance(OSPModel rootModel, OSPModel modelToAdd,
-                 const Transformation& transform);
-void addInstance(OSPModel rootModel, OSPModel modelToAdd,
-                 const ospcommon::affine3f& affine);
+/**
+ * Helper to create a committed instance of the given model. The caller owns the
+ * returned instance and is responsible for releasing it.
+ */
+OSPGeometry createInstance(OSPModel model, const Transformation& transform);
+OSPGeometry createInstance(OSPModel model, const ospcommon::affine3f& affine);
 
 /** Helper to convert a vector of double tuples to a vector of float tuples. */
 template <size_t S>
@@ -277,6 +277,9 @@ const brayns::Property PROP_MORPHOLOGY_QUALITY = {
 const brayns::Property PROP_MORPHOLOGY_MAX_DISTANCE_TO_SOMA = {
     "091MaxDistanceToSoma", std::numeric_limits<double>::max(),
     {"Maximum distance to soma"}};
+const brayns::Property PROP_MORPHOLOGY_CACHE_FOLDER = {
+    "092MorphologyCacheFolder", std::string(),
+    {"Folder of the persistent morphology geometry cache"}};
 const brayns::Property PROP_CELL_CLIPPING = {
     "100CellClipping", false,
     {"Clip cells according to scene-defined clipping planes"}};
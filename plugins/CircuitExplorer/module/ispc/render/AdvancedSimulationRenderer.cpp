@@ -27,6 +27,7 @@
 // ospray
 #include <ospray/SDK/common/Data.h>
 #include <ospray/SDK/common/Model.h>
+#include <ospray/SDK/volume/Volume.h>
 
 // ispc exports
 #include "AdvancedSimulationRenderer_ispc.h"
@@ -56,6 +57,21 @@ void AdvancedSimulationRenderer::commit()
     _maxDistanceToSecondaryModel =
         getParam1f("maxDistanceToSecondaryModel", 30.f);
 
+    // Macrocells published by the Brayns volumes
+    _macrocellOpacities.clear();
+    _macrocellDimensions.clear();
+    _macrocellSizes.clear();
+    if (model)
+        for (const auto& volume : model->volume)
+        {
+            auto data = volume->getParamData("macrocellOpacities", nullptr);
+            _macrocellOpacities.push_back(data ? (float*)data->data : nullptr);
+            _macrocellDimensions.push_back(
+                volume->getParam3i("macrocellDimensions", vec3i(0)));
+            _macrocellSizes.push_back(
+                volume->getParam3f("macrocellSize", vec3f(0.f)));
+        }
+
     const auto simulationDataSize =
         _simulationData ? _simulationData->size() : 0;
 
@@ -73,7 +89,9 @@ void AdvancedSimulationRenderer::commit()
         simulationDataSize, _samplingThreshold, _maxDistanceToSecondaryModel,
         _volumeSpecularExponent, _volumeAlphaCorrection, _pixelAlpha,
         _fogThickness, _fogStart, (const ispc::vec4f*)clipPlaneData,
-        numClipPlanes);
+        numClipPlanes, _macrocellOpacities.data(),
+        (const ispc::vec3i*)_macrocellDimensions.data(),
+        (const ispc::vec3f*)_macrocellSizes.data(), _macrocellOpacities.size());
 }
 
 AdvancedSimulationRenderer::AdvancedSimulationRenderer()
@@ -59,6 +59,11 @@ private:
     float _volumeSpecularExponent;
     float _volumeAlphaCorrection;
 
+    // Empty space skipping, one entry per volume of the model
+    std::vector<const float*> _macrocellOpacities;
+    std::vector<ospray::vec3i> _macrocellDimensions;
+    std::vector<ospray::vec3f> _macrocellSizes;
+
     // Clip planes
     ospray::Ref<ospray::Data> clipPlanes;
 };
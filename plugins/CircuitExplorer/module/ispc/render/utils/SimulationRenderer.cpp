@@ -24,9 +24,13 @@
 #include "SimulationRenderer.h"
 #include "SimulationRenderer_ispc.h"
 
+#include <brayns/ispc/geometry/CompactCones.h>
+#include <brayns/ispc/geometry/CompactCylinders.h>
+#include <brayns/ispc/geometry/CompactSpheres.h>
 #include <brayns/ispc/geometry/Cones.h>
 #include <brayns/ispc/geometry/SDFGeometries.h>
 
+#include <brayns/common/geometry/CompactGeometry.h>
 #include <brayns/common/geometry/Cone.h>
 #include <brayns/common/geometry/Cylinder.h>
 #include <brayns/common/geometry/SDFGeometry.h>
@@ -52,8 +56,25 @@ extern "C"
             return sizeof(brayns::Cone);
         else if (dynamic_cast<const ospray::SDFGeometries*>(base))
             return sizeof(brayns::SDFGeometry);
+        else if (dynamic_cast<const ospray::CompactSpheres*>(base))
+            return sizeof(brayns::CompactSphere);
+        else if (dynamic_cast<const ospray::CompactCylinders*>(base))
+            return sizeof(brayns::CompactCylinder);
+        else if (dynamic_cast<const ospray::CompactCones*>(base))
+            return sizeof(brayns::CompactCone);
         return 0;
     }
+
+    int SimulationRenderer_getBytesPerUserData(const void* geometry)
+    {
+        const ospray::Geometry* base =
+            static_cast<const ospray::Geometry*>(geometry);
+        if (dynamic_cast<const ospray::CompactSpheres*>(base) ||
+            dynamic_cast<const ospray::CompactCylinders*>(base) ||
+            dynamic_cast<const ospray::CompactCones*>(base))
+            return sizeof(uint32_t);
+        return sizeof(uint64_t);
+    }
 }
 
 namespace brayns
@@ -74,8 +95,22 @@ void SimulationRenderer::commit()
     ospray::TransferFunction* transferFunction =
         (ospray::TransferFunction*)getParamObject("transferFunction", nullptr);
     if (transferFunction)
-        ispc::SimulationRenderer_setTransferFunction(getIE(),
-                                                     transferFunction->getIE());
+    {
+        // Prefer the RGBA table baked by Brayns to the generic evaluation
+        _transferFunctionLookupTable =
+            transferFunction->getParamData("lookupTable", nullptr);
+        const auto valueRange =
+            transferFunction->getParam2f("valueRange", ospray::vec2f(0.f, 1.f));
+        ispc::SimulationRenderer_setTransferFunction(
+            getIE(), transferFunction->getIE(),
+            _transferFunctionLookupTable
+                ? (ispc::vec4f*)_transferFunctionLookupTable->data
+                : nullptr,
+            _transferFunctionLookupTable
+                ? _transferFunctionLookupTable->size()
+                : 0,
+            (const ispc::vec2f&)valueRange);
+    }
 }
 
 } // namespace brayns
@@ -48,6 +48,8 @@ protected:
     ospray::Ref<ospray::Data> _simulationData;
     ospray::uint64 _simulationDataSize;
 
+    ospray::Ref<ospray::Data> _transferFunctionLookupTable;
+
     float _alphaCorrection;
     float _maxDistanceToSecondaryModel;
     float _pixelAlpha;
@@ -39,7 +39,6 @@
 #include <brayns/common/Progress.h>
 #include <brayns/common/Timer.h>
 #include <brayns/common/geometry/Streamline.h>
-#include <brayns/common/utils/imageUtils.h>
 #include <brayns/engine/Camera.h>
 #include <brayns/engine/Engine.h>
 #include <brayns/engine/FrameBuffer.h>
@@ -50,7 +49,8 @@
 #include <brayns/pluginapi/PluginAPI.h>
 
 #include <brion/brion.h>
-#include <fstream>
+#include <cmath>
+#include <thread>
 
 #define REGISTER_LOADER(LOADER, FUNC) \
     registry.registerLoader({std::bind(&LOADER::getSupportedDataTypes), FUNC});
@@ -144,6 +144,30 @@ void _addGrowthRenderer(brayns::Engine& engine)
     engine.addRendererType("growth_simulation", properties);
 }
 
+brayns::PropertyMap _getMeshingPerValueParameters(const bool metaballs)
+{
+    brayns::PropertyMap properties;
+    properties.setProperty({"modelId", 0, {"Model ID"}});
+    properties.setProperty({"frame", 0, {"Simulation frame"}});
+    properties.setProperty({"value", 0., {"Simulation value"}});
+    properties.setProperty(
+        {"epsilon", 0., {"Maximum distance to the simulation value"}});
+    if (metaballs)
+    {
+        properties.setProperty({"gridSize", 0, {"Metaballs grid size"}});
+        properties.setProperty({"threshold", 0., {"Metaballs threshold"}});
+    }
+    return properties;
+}
+
+brayns::PropertyMap _getMeshingResult()
+{
+    brayns::PropertyMap properties;
+    properties.setProperty({"success", false, {"Success"}});
+    properties.setProperty({"error", std::string(), {"Error message"}});
+    return properties;
+}
+
 CircuitExplorerPlugin::CircuitExplorerPlugin()
     : ExtensionPlugin()
 {
@@ -227,18 +251,29 @@ void CircuitExplorerPlugin::init()
 
         PLUGIN_INFO << "Registering 'set-connections-per-value' endpoint"
                     << std::endl;
-        actionInterface->registerNotification<ConnectionsPerValue>(
-            "set-connections-per-value", [&](const ConnectionsPerValue& param) {
-                _setConnectionsPerValue(param);
-            });
+        actionInterface
+            ->registerTask<ConnectionsPerValue, PointCloudMeshingFunctor>(
+                {"set-connections-per-value",
+                 "Mesh the cells matching a simulation value as convex hulls",
+                 brayns::Execution::async, "param",
+                 "Model, frame and simulation value"},
+                _getMeshingPerValueParameters(false), _getMeshingResult(),
+                [&](const ConnectionsPerValue& param) {
+                    return _setConnectionsPerValue(param);
+                });
 
         PLUGIN_INFO
             << "Registering 'set-metaballs-per-simulation-value' endpoint"
             << std::endl;
-        actionInterface->registerNotification<MetaballsFromSimulationValue>(
-            "set-metaballs-per-simulation-value",
+        actionInterface->registerTask<MetaballsFromSimulationValue,
+                                      PointCloudMeshingFunctor>(
+            {"set-metaballs-per-simulation-value",
+             "Mesh the cells matching a simulation value as metaballs",
+             brayns::Execution::async, "param",
+             "Model, frame, simulation value and metaballs parameters"},
+            _getMeshingPerValueParameters(true), _getMeshingResult(),
             [&](const MetaballsFromSimulationValue& param) {
-                _setMetaballsPerSimulationValue(param);
+                return _setMetaballsPerSimulationValue(param);
             });
 
         PLUGIN_INFO << "Registering 'set-camera' endpoint" << std::endl;
@@ -299,6 +334,10 @@ void CircuitExplorerPlugin::preRender()
         if (_frameNumber >= ai.size())
         {
             _exportFramesToDiskDirty = false;
+            // The movie is complete once the last frames are written
+            _frameExporter->flush();
+            PLUGIN_INFO << "Movie exported to "
+                        << _exportFramesToDiskPayload.path << std::endl;
         }
         else
         {
@@ -553,119 +592,75 @@ void CircuitExplorerPlugin::_saveModelToCache(const SaveModelToCache& saveModel)
                      << std::endl;
 }
 
-void CircuitExplorerPlugin::_setConnectionsPerValue(
-    const ConnectionsPerValue& cpv)
+PointCloud CircuitExplorerPlugin::_getPointCloudForValue(
+    const int32_t modelId, const int32_t frame, const double value,
+    const double epsilon)
 {
-    PointCloud pointCloud;
-
-    auto modelDescriptor = _api->getScene().getModel(cpv.modelId);
-    if (modelDescriptor)
+    auto modelDescriptor = _api->getScene().getModel(modelId);
+    if (!modelDescriptor)
+        PLUGIN_THROW("Model " + std::to_string(modelId) +
+                     " is not registered");
+
+    // Read only: the non-const geometry accessors would expand compact and
+    // mapped geometry and mark it for commit
+    const auto& model = modelDescriptor->getModel();
+    auto simulationHandler = model.getSimulationHandler();
+    if (!simulationHandler)
+        PLUGIN_THROW("Model " + std::to_string(modelId) +
+                     " has no simulation handler");
+
+    // Fetch the frame once and keep a copy, the handler is shared with the
+    // renderer and may move on to other frames while the mesh is built
+    auto data = simulationHandler->getFrameData(frame);
+    if (!data)
     {
-        auto simulationHandler =
-            modelDescriptor->getModel().getSimulationHandler();
-        if (!simulationHandler)
-        {
-            BRAYNS_ERROR << "Scene has not user data handler" << std::endl;
-            return;
-        }
+        simulationHandler->waitReady();
+        data = simulationHandler->getFrameData(frame);
+    }
+    if (!data)
+        PLUGIN_THROW("Frame " + std::to_string(frame) + " is not available");
 
-        auto& model = modelDescriptor->getModel();
-        for (const auto& spheres : model.getSpheres())
-        {
-            for (const auto& s : spheres.second)
-            {
-                const float* data = static_cast<float*>(
-                    simulationHandler->getFrameData(cpv.frame));
+    const auto values = static_cast<const float*>(data);
+    const brayns::floats frameData(values,
+                                   values + simulationHandler->getFrameSize());
 
-                const float value = data[s.userData];
-                if (abs(value - cpv.value) < cpv.epsilon)
-                    pointCloud[spheres.first].push_back(
-                        {s.center.x, s.center.y, s.center.z, s.radius});
-            }
-        }
-
-        if (!pointCloud.empty())
+    // Gather the points here rather than in the task, the model geometry may
+    // only be read from the thread that modifies it
+    PointCloud pointCloud;
+    for (const auto materialId : model.getSphereMaterialIds())
+    {
+        for (const auto& s : model.getSpheresView(materialId))
         {
-            auto meshModel = _api->getScene().createModel();
-            PointCloudMesher mesher;
-            if (mesher.toConvexHull(*meshModel, pointCloud))
-            {
-                auto modelDesc = std::make_shared<brayns::ModelDescriptor>(
-                    std::move(meshModel),
-                    "Connection for value " + std::to_string(cpv.value));
-
-                _api->getScene().addModel(modelDesc);
-                _dirty = true;
-            }
+            if (s.userData >= frameData.size())
+                continue;
+            if (std::abs(frameData[s.userData] - value) < epsilon)
+                pointCloud[materialId].push_back(
+                    {s.center.x, s.center.y, s.center.z, s.radius});
         }
-        else
-            PLUGIN_INFO << "No connections added for value "
-                        << std::to_string(cpv.value) << std::endl;
     }
-    else
-        PLUGIN_INFO << "Model " << cpv.modelId << " is not registered"
-                    << std::endl;
+    return pointCloud;
 }
 
-void CircuitExplorerPlugin::_setMetaballsPerSimulationValue(
-    const MetaballsFromSimulationValue& mpsv)
+PointCloudMeshingFunctor CircuitExplorerPlugin::_setConnectionsPerValue(
+    const ConnectionsPerValue& cpv)
 {
-    PointCloud pointCloud;
-
-    auto modelDescriptor = _api->getScene().getModel(mpsv.modelId);
-    if (modelDescriptor)
-    {
-        auto simulationHandler =
-            modelDescriptor->getModel().getSimulationHandler();
-        if (!simulationHandler)
-        {
-            BRAYNS_ERROR << "Scene has not user data handler" << std::endl;
-            return;
-        }
-
-        auto& model = modelDescriptor->getModel();
-        for (const auto& spheres : model.getSpheres())
-        {
-            for (const auto& s : spheres.second)
-            {
-                const float* data = static_cast<float*>(
-                    simulationHandler->getFrameData(mpsv.frame));
-
-                const float value = data[s.userData];
-                if (abs(value - mpsv.value) < mpsv.epsilon)
-                    pointCloud[spheres.first].push_back(
-                        {s.center.x, s.center.y, s.center.z, s.radius});
-            }
-        }
-
-        if (!pointCloud.empty())
-        {
-            auto meshModel = _api->getScene().createModel();
-            PointCloudMesher mesher;
-            if (mesher.toMetaballs(*meshModel, pointCloud, mpsv.gridSize,
-                                   mpsv.threshold))
-            {
-                auto modelDesc = std::make_shared<brayns::ModelDescriptor>(
-                    std::move(meshModel),
-                    "Connection for value " + std::to_string(mpsv.value));
-
-                _api->getScene().addModel(modelDesc);
-                PLUGIN_INFO << "Metaballs successfully added to the scene"
-                            << std::endl;
+    return {_api->getEngine(),
+            _getPointCloudForValue(cpv.modelId, cpv.frame, cpv.value,
+                                   cpv.epsilon),
+            "Connection for value " + std::to_string(cpv.value),
+            PointCloudMeshingFunctor::Shape::convexHull};
+}
 
-                _dirty = true;
-            }
-            else
-                PLUGIN_INFO << "No mesh was created for value "
-                            << std::to_string(mpsv.value) << std::endl;
-        }
-        else
-            PLUGIN_INFO << "No connections added for value "
-                        << std::to_string(mpsv.value) << std::endl;
-    }
-    else
-        PLUGIN_INFO << "Model " << mpsv.modelId << " is not registered"
-                    << std::endl;
+PointCloudMeshingFunctor CircuitExplorerPlugin::_setMetaballsPerSimulationValue(
+    const MetaballsFromSimulationValue& mpsv)
+{
+    return {_api->getEngine(),
+            _getPointCloudForValue(mpsv.modelId, mpsv.frame, mpsv.value,
+                                   mpsv.epsilon),
+            "Connection for value " + std::to_string(mpsv.value),
+            PointCloudMeshingFunctor::Shape::metaballs,
+            static_cast<size_t>(mpsv.gridSize),
+            static_cast<float>(mpsv.threshold)};
 }
 
 void CircuitExplorerPlugin::_setCamera(const CameraDefinition& payload)
@@ -757,6 +752,19 @@ void CircuitExplorerPlugin::_attachCircuitSimulationHandler(
 void CircuitExplorerPlugin::_exportFramesToDisk(
     const ExportFramesToDisk& payload)
 {
+    if (!FrameExporter::isFormatSupported(payload.format))
+        PLUGIN_THROW("Unknown format: " + payload.format);
+
+    if (!_frameExporter)
+    {
+        // A few encoding threads keep up with the renderer while leaving it
+        // most of the cores
+        const size_t nbThreads =
+            std::max(1u, std::thread::hardware_concurrency() / 4);
+        _frameExporter =
+            std::make_unique<FrameExporter>(nbThreads, 2 * nbThreads);
+    }
+
     _exportFramesToDiskPayload = payload;
     _exportFramesToDiskDirty = true;
     _frameNumber = 0;
@@ -769,46 +777,18 @@ void CircuitExplorerPlugin::_exportFramesToDisk(
 
 void CircuitExplorerPlugin::_doExportFrameToDisk()
 {
-    auto& frameBuffer = _api->getEngine().getFrameBuffer();
-    auto image = frameBuffer.getImage();
-    auto fif = _exportFramesToDiskPayload.format == "jpg"
-                   ? FIF_JPEG
-                   : FreeImage_GetFIFFromFormat(
-                         _exportFramesToDiskPayload.format.c_str());
-    if (fif == FIF_JPEG)
-        image.reset(FreeImage_ConvertTo24Bits(image.get()));
-    else if (fif == FIF_UNKNOWN)
-        throw std::runtime_error("Unknown format: " +
-                                 _exportFramesToDiskPayload.format);
-
-    int flags = _exportFramesToDiskPayload.quality;
-    if (fif == FIF_TIFF)
-        flags = TIFF_NONE;
-
-    brayns::freeimage::MemoryPtr memory(FreeImage_OpenMemory());
-
-    FreeImage_SaveToMemory(fif, image.get(), memory.get(), flags);
-
-    BYTE* pixels = nullptr;
-    DWORD numPixels = 0;
-    FreeImage_AcquireMemory(memory.get(), &pixels, &numPixels);
-
-    char frame[7];
-    sprintf(frame, "%05d",
-            _exportFramesToDiskPayload.startFrame + _frameNumber);
-    std::string filename = _exportFramesToDiskPayload.path + '/' + frame + "." +
-                           _exportFramesToDiskPayload.format;
-    std::ofstream file;
-    file.open(filename, std::ios_base::binary);
-    if (!file.is_open())
-        PLUGIN_THROW("Failed to create " + filename);
-
-    file.write((char*)pixels, numPixels);
-    file.close();
+    FrameExporter::Settings settings;
+    settings.path = _exportFramesToDiskPayload.path;
+    settings.format = _exportFramesToDiskPayload.format;
+    settings.quality = _exportFramesToDiskPayload.quality;
+    settings.exportDepth = _exportFramesToDiskPayload.exportDepth;
 
+    // Only copies the frame, encoding and writing happen in the background
+    auto& frameBuffer = _api->getEngine().getFrameBuffer();
+    _frameExporter->exportFrame(frameBuffer, settings,
+                                _exportFramesToDiskPayload.startFrame +
+                                    _frameNumber);
     frameBuffer.clear();
-
-    PLUGIN_INFO << "Frame saved to " << filename << std::endl;
 }
 
 void CircuitExplorerPlugin::_addGrid(const AddGrid& payload)
@@ -24,6 +24,8 @@
 
 #include <api/CircuitExplorerParams.h>
 #include <io/AbstractCircuitLoader.h>
+#include <io/FrameExporter.h>
+#include <meshing/PointCloudMeshingFunctor.h>
 
 #include <array>
 #include <brayns/common/types.h>
@@ -58,8 +60,13 @@ private:
 
     // Experimental
     void _setSynapseAttributes(const SynapseAttributes&);
-    void _setConnectionsPerValue(const ConnectionsPerValue&);
-    void _setMetaballsPerSimulationValue(const MetaballsFromSimulationValue&);
+    PointCloudMeshingFunctor _setConnectionsPerValue(
+        const ConnectionsPerValue&);
+    PointCloudMeshingFunctor _setMetaballsPerSimulationValue(
+        const MetaballsFromSimulationValue&);
+    PointCloud _getPointCloudForValue(const int32_t modelId,
+                                      const int32_t frame, const double value,
+                                      const double epsilon);
     void _saveModelToCache(const SaveModelToCache&);
 
     // Handlers
@@ -80,6 +87,7 @@ private:
     bool _dirty{false};
 
     ExportFramesToDisk _exportFramesToDiskPayload;
+    std::unique_ptr<FrameExporter> _frameExporter;
     bool _exportFramesToDiskDirty{false};
     uint16_t _frameNumber{0};
     uint16_t _accumulationFrameNumber{0};
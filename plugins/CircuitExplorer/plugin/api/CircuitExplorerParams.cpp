@@ -453,6 +453,8 @@ bool from_json(ExportFramesToDisk& param, const std::string& payload)
         FROM_JSON(param, js, startFrame);
         FROM_JSON(param, js, animationInformation);
         FROM_JSON(param, js, cameraInformation);
+        if (js.find("exportDepth") != js.end())
+            FROM_JSON(param, js, exportDepth);
     }
     catch (...)
     {
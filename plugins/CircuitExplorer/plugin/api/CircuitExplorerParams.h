@@ -261,6 +261,7 @@ struct ExportFramesToDisk
     uint16_t startFrame;
     std::vector<uint64_t> animationInformation;
     std::vector<double> cameraInformation;
+    bool exportDepth{false};
 };
 bool from_json(ExportFramesToDisk& param, const std::string& payload);
 
@@ -87,6 +87,7 @@ brayns::PropertyMap AdvancedCircuitLoader::getCLIProperties()
     pm.setProperty(PROP_MORPHOLOGY_COLOR_SCHEME);
     pm.setProperty(PROP_MORPHOLOGY_QUALITY);
     pm.setProperty(PROP_MORPHOLOGY_MAX_DISTANCE_TO_SOMA);
+    pm.setProperty(PROP_MORPHOLOGY_CACHE_FOLDER);
     pm.setProperty(PROP_CELL_CLIPPING);
     pm.setProperty(PROP_AREAS_OF_INTEREST);
     pm.setProperty(PROP_SYNAPSE_RADIUS);
@@ -20,6 +20,7 @@
  */
 
 #include "BrickLoader.h"
+#include "MemoryMappedFile.h"
 #include "MorphologyLoader.h"
 #include "SpikeSimulationHandler.h"
 #include "VoltageSimulationHandler.h"
@@ -41,6 +42,13 @@ namespace
 const size_t CACHE_VERSION_1 = 1;
 const size_t CACHE_VERSION_2 = 2;
 const size_t CACHE_VERSION_3 = 3;
+const size_t CACHE_VERSION_4 = 4;
+
+// Version 4 aligns the geometry section on a page boundary and each primitive
+// buffer on a cache line, so that buffers can be used in place from a memory
+// mapping of the file.
+const size_t GEOMETRY_SECTION_ALIGNMENT = 4096;
+const size_t PRIMITIVE_BUFFER_ALIGNMENT = 64;
 
 const std::string LOADER_NAME = "Pre-computed brick loader";
 const std::string SUPPORTED_EXTENTION_BRAYNS = "brayns";
@@ -59,6 +67,65 @@ const brayns::Property PROP_LOAD_SDF = {
     "sdf", true, {"Load signed distance field geometry"}};
 const brayns::Property PROP_LOAD_SIMULATION = {
     "simulation", true, {"Attach simulation data (if applicable"}};
+
+struct SphereV1
+{
+    brayns::Vector3f center;
+    float radius;
+    float timestamp;
+    float value;
+};
+
+struct CylinderV1
+{
+    brayns::Vector3f center;
+    brayns::Vector3f up;
+    float radius;
+    float timestamp;
+    float value;
+};
+
+struct ConeV1
+{
+    brayns::Vector3f center;
+    brayns::Vector3f up;
+    float centerRadius;
+    float upRadius;
+    float timestamp;
+    float value;
+};
+
+size_t getPadding(const size_t position, const size_t alignment)
+{
+    return (alignment - position % alignment) % alignment;
+}
+
+void skipPadding(std::istream& file, const size_t alignment)
+{
+    file.ignore(getPadding(file.tellg(), alignment));
+}
+
+void writePadding(std::ofstream& file, const size_t alignment)
+{
+    const std::vector<char> padding(getPadding(file.tellp(), alignment), 0);
+    file.write(padding.data(), padding.size());
+}
+
+template <typename T>
+brayns::GeometryView<T> getMappedView(
+    std::istream& file, const std::shared_ptr<MemoryMappedFile>& mapping,
+    const size_t nbElements)
+{
+    if (!file)
+        throw std::runtime_error("Failed to read brick cache file");
+    const auto offset = static_cast<size_t>(file.tellg());
+    if (offset > mapping->size() ||
+        nbElements > (mapping->size() - offset) / sizeof(T))
+        throw std::runtime_error("Brick cache file is truncated or corrupted");
+    file.ignore(nbElements * sizeof(T));
+    return {reinterpret_cast<const T*>(mapping->data() + offset), nbElements,
+            mapping};
+}
 } // namespace
 
 BrickLoader::BrickLoader(brayns::Scene& scene,
@@ -94,7 +161,7 @@ brayns::ModelDescriptorPtr BrickLoader::importFromBlob(
     throw std::runtime_error("Loading circuit from blob is not supported");
 }
 
-std::string BrickLoader::_readString(std::ifstream& f) const
+std::string BrickLoader::_readString(std::istream& f) const
 {
     size_t size;
     f.read((char*)&size, sizeof(size_t));
@@ -115,12 +182,11 @@ brayns::ModelDescriptorPtr BrickLoader::importFromFile(
 
     callback.updateProgress("Loading cache...", 0);
     PLUGIN_INFO << "Loading model from cache file: " << filename << std::endl;
-    std::ifstream file(filename, std::ios::in | std::ios::binary);
-    if (!file.good())
-    {
-        const std::string msg = "Could not open cache file " + filename;
-        PLUGIN_THROW(msg);
-    }
+    // The file is mapped rather than streamed: version 4 primitive buffers
+    // are then handed to the model in place, without any copy
+    const auto mapping = std::make_shared<MemoryMappedFile>(filename);
+    MemoryStreamBuffer buffer(mapping->data(), mapping->size());
+    std::istream file(&buffer);
 
     // File version
     size_t version;
@@ -226,40 +292,43 @@ brayns::ModelDescriptorPtr BrickLoader::importFromFile(
 
     // Spheres
     callback.updateProgress("Spheres", 0.2f);
+    if (version >= CACHE_VERSION_4)
+        skipPadding(file, GEOMETRY_SECTION_ALIGNMENT);
     file.read((char*)&nbSpheres, sizeof(size_t));
     for (size_t i = 0; i < nbSpheres; ++i)
     {
         file.read((char*)&materialId, sizeof(size_t));
         file.read((char*)&nbElements, sizeof(size_t));
+        bufferSize = nbElements * (version >= CACHE_VERSION_2
+                                       ? sizeof(brayns::Sphere)
+                                       : sizeof(SphereV1));
+        if (version >= CACHE_VERSION_4)
+            skipPadding(file, PRIMITIVE_BUFFER_ALIGNMENT);
         if (props.getProperty<bool>(PROP_LOAD_SPHERES.name))
         {
             callback.updateProgress("Spheres (" + std::to_string(i + 1) + "/" +
                                         std::to_string(nbSpheres) + ")",
                                     0.2f + 0.1f * float(i) / float(nbSpheres));
-            auto& spheres = model->getSpheres()[materialId];
+            if (version >= CACHE_VERSION_4)
+            {
+                model->setMappedSpheres(
+                    materialId, getMappedView<brayns::Sphere>(file, mapping,
+                                                              nbElements));
+                continue;
+            }
+
+            auto& spheres = model->getSpheres(materialId);
             spheres.resize(nbElements);
 
             if (version >= CACHE_VERSION_2)
-            {
-                bufferSize = nbElements * sizeof(brayns::Sphere);
                 file.read((char*)spheres.data(), bufferSize);
-            }
             else
             {
-                struct SphereV1
-                {
-                    brayns::Vector3f center;
-                    float radius;
-                    float timestamp;
-                    float value;
-                };
-
                 std::vector<SphereV1> spheresV1;
                 spheresV1.resize(nbElements);
-                bufferSize = nbElements * sizeof(SphereV1);
                 file.read((char*)spheresV1.data(), bufferSize);
                 for (uint64_t s = 0; s < spheresV1.size(); ++s)
-                    spheres[s] = {spheresV1[i].center, spheresV1[i].radius};
+                    spheres[s] = {spheresV1[s].center, spheresV1[s].radius};
             }
         }
         else
@@ -272,36 +341,36 @@ brayns::ModelDescriptorPtr BrickLoader::importFromFile(
     {
         file.read((char*)&materialId, sizeof(size_t));
         file.read((char*)&nbElements, sizeof(size_t));
+        bufferSize = nbElements * (version >= CACHE_VERSION_2
+                                       ? sizeof(brayns::Cylinder)
+                                       : sizeof(CylinderV1));
+        if (version >= CACHE_VERSION_4)
+            skipPadding(file, PRIMITIVE_BUFFER_ALIGNMENT);
         if (props.getProperty<bool>(PROP_LOAD_CYLINDERS.name))
         {
             callback.updateProgress("Cylinders (" + std::to_string(i + 1) +
                                         "/" + std::to_string(nbCylinders) + ")",
                                     0.3f +
                                         0.1f * float(i) / float(nbCylinders));
-            auto& cylinders = model->getCylinders()[materialId];
+            if (version >= CACHE_VERSION_4)
+            {
+                model->setMappedCylinders(
+                    materialId, getMappedView<brayns::Cylinder>(file, mapping,
+                                                                nbElements));
+                continue;
+            }
+
+            auto& cylinders = model->getCylinders(materialId);
             cylinders.resize(nbElements);
             if (version >= CACHE_VERSION_2)
-            {
-                bufferSize = nbElements * sizeof(brayns::Cylinder);
                 file.read((char*)cylinders.data(), bufferSize);
-            }
             else
             {
-                struct CylinderV1
-                {
-                    brayns::Vector3f center;
-                    brayns::Vector3f up;
-                    float radius;
-                    float timestamp;
-                    float value;
-                };
-
                 std::vector<CylinderV1> cylindersV1(nbElements);
-                bufferSize = nbElements * sizeof(CylinderV1);
                 file.read((char*)cylindersV1.data(), bufferSize);
                 for (uint64_t s = 0; s < cylindersV1.size(); ++s)
-                    cylinders[s] = {cylindersV1[i].center, cylindersV1[i].up,
-                                    cylindersV1[i].radius};
+                    cylinders[s] = {cylindersV1[s].center, cylindersV1[s].up,
+                                    cylindersV1[s].radius};
             }
         }
         else
@@ -314,36 +383,35 @@ brayns::ModelDescriptorPtr BrickLoader::importFromFile(
     {
         file.read((char*)&materialId, sizeof(size_t));
         file.read((char*)&nbElements, sizeof(size_t));
+        bufferSize = nbElements * (version >= CACHE_VERSION_2
+                                       ? sizeof(brayns::Cone)
+                                       : sizeof(ConeV1));
+        if (version >= CACHE_VERSION_4)
+            skipPadding(file, PRIMITIVE_BUFFER_ALIGNMENT);
         if (props.getProperty<bool>(PROP_LOAD_CONES.name))
         {
             callback.updateProgress("Cones (" + std::to_string(i + 1) + "/" +
                                         std::to_string(nbCones) + ")",
                                     0.4f + 0.1f * float(i) / float(nbCones));
-            auto& cones = model->getCones()[materialId];
+            if (version >= CACHE_VERSION_4)
+            {
+                model->setMappedCones(materialId,
+                                      getMappedView<brayns::Cone>(file, mapping,
+                                                                  nbElements));
+                continue;
+            }
+
+            auto& cones = model->getCones(materialId);
             cones.resize(nbElements);
             if (version >= CACHE_VERSION_2)
-            {
-                bufferSize = nbElements * sizeof(brayns::Cone);
                 file.read((char*)cones.data(), bufferSize);
-            }
             else
             {
-                struct ConeV1
-                {
-                    brayns::Vector3f center;
-                    brayns::Vector3f up;
-                    float centerRadius;
-                    float upRadius;
-                    float timestamp;
-                    float value;
-                };
-
                 std::vector<ConeV1> conesV1(nbElements);
-                bufferSize = nbElements * sizeof(ConeV1);
                 file.read((char*)conesV1.data(), bufferSize);
                 for (uint64_t s = 0; s < conesV1.size(); ++s)
-                    cones[s] = {conesV1[i].center, conesV1[i].up,
-                                conesV1[i].centerRadius, conesV1[i].upRadius};
+                    cones[s] = {conesV1[s].center, conesV1[s].up,
+                                conesV1[s].centerRadius, conesV1[s].upRadius};
             }
         }
         else
@@ -631,8 +699,6 @@ brayns::ModelDescriptorPtr BrickLoader::importFromFile(
     }
     callback.updateProgress("Done", 1.f);
 
-    file.close();
-
     auto modelDescriptor =
         std::make_shared<brayns::ModelDescriptor>(std::move(model), "Brick",
                                                   filename, metadata);
@@ -650,11 +716,14 @@ void BrickLoader::exportToFile(const brayns::ModelDescriptorPtr modelDescriptor,
         PLUGIN_THROW(msg);
     }
 
-    const size_t version = CACHE_VERSION_3;
+    const size_t version = CACHE_VERSION_4;
     file.write((char*)&version, sizeof(size_t));
 
     // Save geometry
     auto& model = modelDescriptor->getModel();
+    // Geometry is read through the views so that the model keeps compact or
+    // mapped buffers. Compact buffers are expanded into a temporary copy by
+    // the views to be written.
     uint64_t bufferSize{0};
 
     // Metadata
@@ -736,48 +805,52 @@ void BrickLoader::exportToFile(const brayns::ModelDescriptorPtr modelDescriptor,
     }
 
     // Spheres
-    nbElements = model.getSpheres().size();
+    writePadding(file, GEOMETRY_SECTION_ALIGNMENT);
+    const auto sphereMaterialIds = model.getSphereMaterialIds();
+    nbElements = sphereMaterialIds.size();
     file.write((char*)&nbElements, sizeof(size_t));
-    for (auto& spheres : model.getSpheres())
+    for (const auto materialId : sphereMaterialIds)
     {
-        const auto materialId = spheres.first;
         file.write((char*)&materialId, sizeof(size_t));
 
-        const auto& data = spheres.second;
-        nbElements = data.size();
+        const auto data = model.getSpheresView(materialId);
+        nbElements = data.size;
         file.write((char*)&nbElements, sizeof(size_t));
+        writePadding(file, PRIMITIVE_BUFFER_ALIGNMENT);
         bufferSize = nbElements * sizeof(brayns::Sphere);
-        file.write((char*)data.data(), bufferSize);
+        file.write((char*)data.data, bufferSize);
     }
 
     // Cylinders
-    nbElements = model.getCylinders().size();
+    const auto cylinderMaterialIds = model.getCylinderMaterialIds();
+    nbElements = cylinderMaterialIds.size();
     file.write((char*)&nbElements, sizeof(size_t));
-    for (auto& cylinders : model.getCylinders())
+    for (const auto materialId : cylinderMaterialIds)
     {
-        const auto materialId = cylinders.first;
         file.write((char*)&materialId, sizeof(size_t));
 
-        const auto& data = cylinders.second;
-        nbElements = data.size();
+        const auto data = model.getCylindersView(materialId);
+        nbElements = data.size;
         file.write((char*)&nbElements, sizeof(size_t));
+        writePadding(file, PRIMITIVE_BUFFER_ALIGNMENT);
         bufferSize = nbElements * sizeof(brayns::Cylinder);
-        file.write((char*)data.data(), bufferSize);
+        file.write((char*)data.data, bufferSize);
     }
 
     // Cones
-    nbElements = model.getCones().size();
+    const auto coneMaterialIds = model.getConeMaterialIds();
+    nbElements = coneMaterialIds.size();
     file.write((char*)&nbElements, sizeof(size_t));
-    for (auto& cones : model.getCones())
+    for (const auto materialId : coneMaterialIds)
     {
-        const auto materialId = cones.first;
         file.write((char*)&materialId, sizeof(size_t));
 
-        const auto& data = cones.second;
-        nbElements = data.size();
+        const auto data = model.getConesView(materialId);
+        nbElements = data.size;
         file.write((char*)&nbElements, sizeof(size_t));
+        writePadding(file, PRIMITIVE_BUFFER_ALIGNMENT);
         bufferSize = nbElements * sizeof(brayns::Cone);
-        file.write((char*)data.data(), bufferSize);
+        file.write((char*)data.data, bufferSize);
     }
 
     // Meshes
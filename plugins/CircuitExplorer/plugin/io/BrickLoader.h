@@ -27,6 +27,7 @@
 #include <brayns/common/loader/Loader.h>
 #include <brayns/common/types.h>
 
+#include <istream>
 #include <set>
 #include <vector>
 
@@ -66,6 +67,6 @@ public:
                       const std::string& filename);
 
 private:
-    std::string _readString(std::ifstream& f) const;
+    std::string _readString(std::istream& f) const;
     brayns::PropertyMap _defaults;
 };
@@ -0,0 +1,311 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of the circuit explorer for Brayns
+ * <https://github.com/favreau/Brayns-UC-CircuitExplorer>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "FrameExporter.h"
+
+#include <common/log.h>
+
+#include <brayns/common/utils/imageUtils.h>
+#include <brayns/engine/FrameBuffer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+size_t _getBytesPerPixel(const brayns::FrameBufferFormat format)
+{
+    switch (format)
+    {
+    case brayns::FrameBufferFormat::rgba_i8:
+    case brayns::FrameBufferFormat::bgra_i8:
+        return 4;
+    case brayns::FrameBufferFormat::rgb_i8:
+        return 3;
+    case brayns::FrameBufferFormat::rgb_f32:
+        return 4 * sizeof(float);
+    default:
+        return 0;
+    }
+}
+
+FREE_IMAGE_FORMAT _getImageFormat(const std::string& format)
+{
+    return format == "jpg" ? FIF_JPEG
+                           : FreeImage_GetFIFFromFormat(format.c_str());
+}
+
+/** Float RGBA image, the only color representation supported by EXR */
+brayns::freeimage::ImagePtr _createFloatImage(
+    const uint8_t* buffer, const brayns::Vector2ui& size,
+    const brayns::FrameBufferFormat format)
+{
+    brayns::freeimage::ImagePtr image(
+        FreeImage_AllocateT(FIT_RGBAF, size.x, size.y));
+    const bool isFloat = format == brayns::FrameBufferFormat::rgb_f32;
+    const bool isBGR = format == brayns::FrameBufferFormat::bgra_i8;
+    const size_t bytesPerPixel = _getBytesPerPixel(format);
+    const float* floats = reinterpret_cast<const float*>(buffer);
+    for (uint32_t y = 0; y < size.y; ++y)
+    {
+        auto line = reinterpret_cast<FIRGBAF*>(FreeImage_GetScanLine(
+            image.get(), y));
+        for (uint32_t x = 0; x < size.x; ++x)
+        {
+            const size_t index = y * size.x + x;
+            auto& pixel = line[x];
+            if (isFloat)
+            {
+                pixel.red = floats[index * 4];
+                pixel.green = floats[index * 4 + 1];
+                pixel.blue = floats[index * 4 + 2];
+                pixel.alpha = floats[index * 4 + 3];
+                continue;
+            }
+            const uint8_t* bytes = buffer + index * bytesPerPixel;
+            pixel.red = bytes[isBGR ? 2 : 0] / 255.f;
+            pixel.green = bytes[1] / 255.f;
+            pixel.blue = bytes[isBGR ? 0 : 2] / 255.f;
+            pixel.alpha = bytesPerPixel == 4 ? bytes[3] / 255.f : 1.f;
+        }
+    }
+    return image;
+}
+
+/** Image in the layout of the frame buffer, for 8 bits per channel formats */
+brayns::freeimage::ImagePtr _createImage(const uint8_t* buffer,
+                                         const brayns::Vector2ui& size,
+                                         const brayns::FrameBufferFormat format)
+{
+    if (format == brayns::FrameBufferFormat::rgb_f32)
+    {
+        // FreeImage does not convert RGBAF to 8 bits, values are clamped to
+        // [0, 1] like the frame buffer does for its own 8 bits formats
+        brayns::freeimage::ImagePtr image(
+            FreeImage_Allocate(size.x, size.y, 32));
+        const float* floats = reinterpret_cast<const float*>(buffer);
+        const auto toByte = [](const float value) {
+            return BYTE(std::min(std::max(value, 0.f), 1.f) * 255.f + 0.5f);
+        };
+        for (uint32_t y = 0; y < size.y; ++y)
+        {
+            BYTE* line = FreeImage_GetScanLine(image.get(), y);
+            const float* pixels = floats + size_t(y) * size.x * 4;
+            for (uint32_t x = 0; x < size.x; ++x, line += 4, pixels += 4)
+            {
+                line[FI_RGBA_RED] = toByte(pixels[0]);
+                line[FI_RGBA_GREEN] = toByte(pixels[1]);
+                line[FI_RGBA_BLUE] = toByte(pixels[2]);
+                line[FI_RGBA_ALPHA] = toByte(pixels[3]);
+            }
+        }
+        return image;
+    }
+
+    const size_t depth = _getBytesPerPixel(format);
+    brayns::freeimage::ImagePtr image(
+        FreeImage_ConvertFromRawBits(const_cast<uint8_t*>(buffer), size.x,
+                                     size.y, depth * size.x, 8 * depth,
+                                     0xFF0000, 0x00FF00, 0x0000FF, false));
+#if FREEIMAGE_COLORORDER == FREEIMAGE_COLORORDER_BGR
+    if (format != brayns::FrameBufferFormat::bgra_i8)
+        brayns::freeimage::SwapRedBlue32(image.get());
+#endif
+    return image;
+}
+
+brayns::freeimage::ImagePtr _createDepthImage(const std::vector<float>& buffer,
+                                              const brayns::Vector2ui& size)
+{
+    brayns::freeimage::ImagePtr image(
+        FreeImage_AllocateT(FIT_FLOAT, size.x, size.y));
+    for (uint32_t y = 0; y < size.y; ++y)
+        std::copy(buffer.begin() + y * size.x,
+                  buffer.begin() + (y + 1) * size.x,
+                  reinterpret_cast<float*>(
+                      FreeImage_GetScanLine(image.get(), y)));
+    return image;
+}
+
+void _save(FIBITMAP* image, const FREE_IMAGE_FORMAT fif, const int flags,
+           const std::string& filename)
+{
+    brayns::freeimage::MemoryPtr memory(FreeImage_OpenMemory());
+    if (!FreeImage_SaveToMemory(fif, image, memory.get(), flags))
+        PLUGIN_THROW("Failed to encode " + filename);
+
+    BYTE* pixels = nullptr;
+    DWORD numPixels = 0;
+    FreeImage_AcquireMemory(memory.get(), &pixels, &numPixels);
+
+    std::ofstream file(filename, std::ios_base::binary);
+    if (!file.is_open())
+        PLUGIN_THROW("Failed to create " + filename);
+    file.write((char*)pixels, numPixels);
+}
+} // namespace
+
+FrameExporter::FrameExporter(const size_t nbThreads,
+                             const size_t maxPendingFrames)
+    : _maxPendingFrames(std::max(maxPendingFrames, size_t(1)))
+{
+    for (size_t i = 0; i < std::max(nbThreads, size_t(1)); ++i)
+        _threads.emplace_back([this] { _run(); });
+}
+
+FrameExporter::~FrameExporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _frameQueued.notify_all();
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+bool FrameExporter::isFormatSupported(const std::string& format)
+{
+    const auto fif = _getImageFormat(format);
+    return fif != FIF_UNKNOWN && FreeImage_FIFSupportsWriting(fif);
+}
+
+void FrameExporter::exportFrame(brayns::FrameBuffer& frameBuffer,
+                                const Settings& settings, const uint32_t frame)
+{
+    FramePtr data;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _frameDone.wait(lock,
+                        [this] { return _pendingFrames < _maxPendingFrames; });
+        ++_pendingFrames;
+        if (!_freeFrames.empty())
+        {
+            data = std::move(_freeFrames.back());
+            _freeFrames.pop_back();
+        }
+    }
+    if (!data)
+        data.reset(new Frame());
+
+    const auto snapshot = frameBuffer.getSnapshot();
+    data->settings = settings;
+    data->index = frame;
+    data->size = snapshot->size;
+    data->format = snapshot->format;
+    const size_t nbPixels = size_t(data->size.x) * data->size.y;
+
+    // Buffers keep their capacity when frames are recycled, the copy below is
+    // the only work left to the render thread
+    const auto color = snapshot->colorBuffer;
+    data->color.assign(color,
+                       color + nbPixels * _getBytesPerPixel(data->format));
+    const auto depth = snapshot->depthBuffer;
+    if (settings.exportDepth && depth)
+        data->depth.assign(depth, depth + nbPixels);
+    else
+        data->depth.clear();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(std::move(data));
+    }
+    _frameQueued.notify_one();
+}
+
+void FrameExporter::flush()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _frameDone.wait(lock, [this] { return _pendingFrames == 0; });
+}
+
+void FrameExporter::_run()
+{
+    for (;;)
+    {
+        FramePtr frame;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _frameQueued.wait(lock,
+                              [this] { return _stop || !_queue.empty(); });
+            // Queued frames are written before stopping
+            if (_queue.empty())
+                return;
+            frame = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        try
+        {
+            _write(*frame);
+        }
+        catch (const std::exception& e)
+        {
+            PLUGIN_ERROR << "Failed to export frame " << frame->index << ": "
+                         << e.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _freeFrames.push_back(std::move(frame));
+            --_pendingFrames;
+        }
+        _frameDone.notify_all();
+    }
+}
+
+void FrameExporter::_write(const Frame& frame) const
+{
+    const auto& settings = frame.settings;
+    char index[7];
+    sprintf(index, "%05d", frame.index);
+    const std::string basename = settings.path + '/' + index;
+
+    const auto fif = _getImageFormat(settings.format);
+    if (fif == FIF_UNKNOWN)
+        PLUGIN_THROW("Unknown format: " + settings.format);
+
+    brayns::freeimage::ImagePtr image;
+    int flags = settings.quality;
+    if (fif == FIF_EXR)
+    {
+        image = _createFloatImage(frame.color.data(), frame.size, frame.format);
+        flags = EXR_FLOAT;
+    }
+    else
+    {
+        image = _createImage(frame.color.data(), frame.size, frame.format);
+        if (fif == FIF_JPEG)
+            image.reset(FreeImage_ConvertTo24Bits(image.get()));
+        else if (fif == FIF_TIFF)
+            flags = TIFF_NONE;
+    }
+    const std::string filename = basename + "." + settings.format;
+    _save(image.get(), fif, flags, filename);
+    PLUGIN_INFO << "Frame saved to " << filename << std::endl;
+
+    if (!frame.depth.empty())
+    {
+        auto depth = _createDepthImage(frame.depth, frame.size);
+        _save(depth.get(), FIF_EXR, EXR_FLOAT, basename + "_depth.exr");
+    }
+}
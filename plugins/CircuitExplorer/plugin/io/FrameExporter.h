@@ -0,0 +1,101 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of the circuit explorer for Brayns
+ * <https://github.com/favreau/Brayns-UC-CircuitExplorer>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#pragma once
+
+#include <brayns/common/types.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The FrameExporter class writes movie frames to disk in the
+ * background. The render thread only copies the mapped framebuffer into a
+ * recycled buffer, encoding and writing is done by a pool of worker threads.
+ * The number of queued frames is bounded, exportFrame() blocks when encoding
+ * cannot keep up with rendering.
+ */
+class FrameExporter
+{
+public:
+    struct Settings
+    {
+        /** Destination folder */
+        std::string path;
+        /** Image format of the color buffer, e.g. png, jpg or exr */
+        std::string format;
+        /** Quality of lossy formats */
+        int quality{100};
+        /** Also write the raw depth buffer as a float EXR image */
+        bool exportDepth{false};
+    };
+
+    /**
+     * @param nbThreads Number of encoding threads
+     * @param maxPendingFrames Maximum number of frames waiting to be written
+     */
+    FrameExporter(const size_t nbThreads, const size_t maxPendingFrames);
+    ~FrameExporter();
+
+    /**
+     * Copies the content of the frame buffer and queues it for writing to
+     * <path>/<frame>.<format>, and <path>/<frame>_depth.exr if requested.
+     */
+    void exportFrame(brayns::FrameBuffer& frameBuffer, const Settings& settings,
+                     const uint32_t frame);
+
+    /** Waits until all queued frames have been written */
+    void flush();
+
+    /** @return true if the format is supported for the color buffer */
+    static bool isFormatSupported(const std::string& format);
+
+private:
+    struct Frame
+    {
+        Settings settings;
+        uint32_t index{0};
+        brayns::Vector2ui size;
+        brayns::FrameBufferFormat format;
+        std::vector<uint8_t> color;
+        std::vector<float> depth;
+    };
+    using FramePtr = std::unique_ptr<Frame>;
+
+    void _run();
+    void _write(const Frame& frame) const;
+
+    std::vector<std::thread> _threads;
+    const size_t _maxPendingFrames;
+
+    std::mutex _mutex;
+    std::condition_variable _frameQueued;
+    std::condition_variable _frameDone;
+    std::deque<FramePtr> _queue;
+    std::vector<FramePtr> _freeFrames;
+    size_t _pendingFrames{0};
+    bool _stop{false};
+};
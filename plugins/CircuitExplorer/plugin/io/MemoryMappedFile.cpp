@@ -0,0 +1,96 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of the circuit explorer for Brayns
+ * <https://github.com/favreau/Brayns-UC-CircuitExplorer>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "MemoryMappedFile.h"
+
+#include <common/log.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MemoryMappedFile::MemoryMappedFile(const std::string& filename)
+{
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+        PLUGIN_THROW("Could not open file " + filename);
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1)
+    {
+        close(fd);
+        PLUGIN_THROW("Could not get size of file " + filename);
+    }
+    _size = static_cast<size_t>(sb.st_size);
+
+    if (_size > 0)
+    {
+        void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            PLUGIN_THROW("Could not map file " + filename);
+        }
+        _data = static_cast<const char*>(data);
+    }
+    // The mapping remains valid once the descriptor is closed
+    close(fd);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (_data)
+        munmap(const_cast<char*>(_data), _size);
+}
+
+MemoryStreamBuffer::MemoryStreamBuffer(const char* data, const size_t size)
+{
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekoff(
+    const off_type offset, const std::ios_base::seekdir dir,
+    const std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::in))
+        return pos_type(off_type(-1));
+
+    char* position = gptr();
+    if (dir == std::ios_base::beg)
+        position = eback() + offset;
+    else if (dir == std::ios_base::cur)
+        position = gptr() + offset;
+    else
+        position = egptr() + offset;
+
+    if (position < eback() || position > egptr())
+        return pos_type(off_type(-1));
+
+    setg(eback(), position, egptr());
+    return pos_type(position - eback());
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekpos(
+    const pos_type position, const std::ios_base::openmode which)
+{
+    return seekoff(off_type(position), std::ios_base::beg, which);
+}
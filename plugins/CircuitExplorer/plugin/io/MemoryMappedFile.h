@@ -0,0 +1,61 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of the circuit explorer for Brayns
+ * <https://github.com/favreau/Brayns-UC-CircuitExplorer>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <streambuf>
+#include <string>
+
+/**
+ * Read-only memory mapping of a file. The mapping stays valid for the lifetime
+ * of the object, so pointers into it can be handed to the engines as long as
+ * the object is kept alive alongside them.
+ */
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile(const std::string& filename);
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+
+private:
+    const char* _data{nullptr};
+    size_t _size{0};
+};
+
+/**
+ * Stream buffer reading directly from a memory region, used to parse the
+ * headers of a memory mapped file with std::istream without copying it.
+ */
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+    MemoryStreamBuffer(const char* data, size_t size);
+
+protected:
+    pos_type seekoff(off_type offset, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which) final;
+    pos_type seekpos(pos_type position, std::ios_base::openmode which) final;
+};
@@ -0,0 +1,272 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of the circuit explorer for Brayns
+ * <https://github.com/favreau/Brayns-UC-CircuitExplorer>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "MorphologyCache.h"
+
+#include <common/log.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+const size_t CACHE_VERSION = 1;
+const std::string CACHE_EXTENSION = ".morphology";
+
+// 64-bit FNV-1a, stable across sessions and platforms unlike std::hash
+uint64_t hash(const std::string& value)
+{
+    uint64_t result = 14695981039346656037ull;
+    for (const auto c : value)
+    {
+        result ^= static_cast<unsigned char>(c);
+        result *= 1099511628211ull;
+    }
+    return result;
+}
+
+template <typename T>
+void write(std::ofstream& file, const T& value)
+{
+    file.write((const char*)&value, sizeof(T));
+}
+
+template <typename T>
+void writeVector(std::ofstream& file, const std::vector<T>& values)
+{
+    write(file, values.size());
+    file.write((const char*)values.data(), values.size() * sizeof(T));
+}
+
+template <typename T>
+void writeMap(std::ofstream& file, const std::map<size_t, std::vector<T>>& map)
+{
+    write(file, map.size());
+    for (const auto& entry : map)
+    {
+        write(file, entry.first);
+        writeVector(file, entry.second);
+    }
+}
+
+template <typename T>
+void read(std::ifstream& file, T& value)
+{
+    file.read((char*)&value, sizeof(T));
+}
+
+template <typename T>
+void readVector(std::ifstream& file, std::vector<T>& values)
+{
+    size_t size{0};
+    read(file, size);
+    values.resize(size);
+    file.read((char*)values.data(), size * sizeof(T));
+}
+
+template <typename T>
+void readMap(std::ifstream& file, std::map<size_t, std::vector<T>>& map)
+{
+    size_t size{0};
+    read(file, size);
+    for (size_t i = 0; i < size && file.good(); ++i)
+    {
+        size_t materialId{0};
+        read(file, materialId);
+        readVector(file, map[materialId]);
+    }
+}
+} // namespace
+
+MorphologyCache::MorphologyCache(const std::string& folder,
+                                 const size_t maxEntries)
+    : _folder(folder)
+    , _maxEntries(std::max(maxEntries, size_t(1)))
+{
+    if (!_folder.empty())
+        boost::filesystem::create_directories(_folder);
+}
+
+std::string MorphologyCache::getKey(const std::string& path,
+                                    const std::string& parameters)
+{
+    std::stringstream description;
+    description << path << ";" << parameters;
+
+    boost::system::error_code error;
+    const auto size = boost::filesystem::file_size(path, error);
+    if (!error)
+        description << ";" << size;
+    const auto time = boost::filesystem::last_write_time(path, error);
+    if (!error)
+        description << ";" << time;
+
+    std::stringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0')
+        << hash(description.str());
+    return key.str();
+}
+
+bool MorphologyCache::get(const std::string& key,
+                          ParallelModelContainer& container)
+{
+    ContainerPtr entry;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end())
+        {
+            it->second.lastUse = ++_uses;
+            entry = it->second.container;
+        }
+    }
+
+    if (!entry)
+    {
+        entry = _load(key);
+        if (!entry)
+            return false;
+        _insert(key, entry);
+    }
+
+    container = *entry;
+    return true;
+}
+
+void MorphologyCache::put(const std::string& key,
+                          const ParallelModelContainer& container)
+{
+    _insert(key, std::make_shared<ParallelModelContainer>(container));
+    _save(key, container);
+}
+
+void MorphologyCache::_insert(const std::string& key,
+                              const ContainerPtr& container)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& entry = _entries[key];
+    entry.container = container;
+    entry.lastUse = ++_uses;
+
+    // Entries evicted from memory are still found on disk, if enabled
+    if (_entries.size() > _maxEntries)
+    {
+        const auto oldest =
+            std::min_element(_entries.begin(), _entries.end(),
+                             [](const auto& a, const auto& b) {
+                                 return a.second.lastUse < b.second.lastUse;
+                             });
+        _entries.erase(oldest);
+    }
+}
+
+MorphologyCache::ContainerPtr MorphologyCache::_load(
+    const std::string& key) const
+{
+    if (_folder.empty())
+        return nullptr;
+
+    const auto filename = _folder + "/" + key + CACHE_EXTENSION;
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file.good())
+        return nullptr;
+
+    size_t version{0};
+    read(file, version);
+    if (version != CACHE_VERSION)
+        return nullptr;
+
+    auto container = std::make_shared<ParallelModelContainer>();
+    auto& info = container->morphologyInfo;
+    brayns::Vector3d boundsMin;
+    brayns::Vector3d boundsMax;
+    read(file, info.somaPosition);
+    read(file, boundsMin);
+    read(file, boundsMax);
+    read(file, info.maxDistanceToSoma);
+    info.bounds = brayns::Boxd(boundsMin, boundsMax);
+
+    readMap(file, container->spheres);
+    readMap(file, container->cylinders);
+    readMap(file, container->cones);
+    readVector(file, container->sdfGeometries);
+    readVector(file, container->sdfMaterials);
+    size_t nbNeighbours{0};
+    read(file, nbNeighbours);
+    container->sdfNeighbours.resize(nbNeighbours);
+    for (auto& neighbours : container->sdfNeighbours)
+        readVector(file, neighbours);
+
+    if (!file.good())
+    {
+        PLUGIN_WARN << "Ignoring corrupted morphology cache file " << filename
+                    << std::endl;
+        return nullptr;
+    }
+    return container;
+}
+
+void MorphologyCache::_save(const std::string& key,
+                            const ParallelModelContainer& container) const
+{
+    if (_folder.empty())
+        return;
+
+    // Written under a temporary name and then renamed, so that concurrent
+    // sessions never read a partially written entry
+    const auto filename = _folder + "/" + key + CACHE_EXTENSION;
+    const auto tmpFilename = boost::filesystem::unique_path(
+                                 filename + ".%%%%-%%%%")
+                                 .string();
+    {
+        std::ofstream file(tmpFilename, std::ios::out | std::ios::binary);
+        if (!file.good())
+        {
+            PLUGIN_WARN << "Could not write morphology cache file "
+                        << tmpFilename << std::endl;
+            return;
+        }
+
+        write(file, CACHE_VERSION);
+        const auto& info = container.morphologyInfo;
+        write(file, info.somaPosition);
+        write(file, info.bounds.getMin());
+        write(file, info.bounds.getMax());
+        write(file, info.maxDistanceToSoma);
+
+        writeMap(file, container.spheres);
+        writeMap(file, container.cylinders);
+        writeMap(file, container.cones);
+        writeVector(file, container.sdfGeometries);
+        writeVector(file, container.sdfMaterials);
+        write(file, container.sdfNeighbours.size());
+        for (const auto& neighbours : container.sdfNeighbours)
+            writeVector(file, neighbours);
+    }
+
+    boost::system::error_code error;
+    boost::filesystem::rename(tmpFilename, filename, error);
+    if (error)
+        boost::filesystem::remove(tmpFilename, error);
+}
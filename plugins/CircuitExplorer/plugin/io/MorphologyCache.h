@@ -0,0 +1,89 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of the circuit explorer for Brayns
+ * <https://github.com/favreau/Brayns-UC-CircuitExplorer>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <common/types.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief The MorphologyCache class keeps the processed geometry of
+ * morphologies, in local coordinates, so that it is computed only once for all
+ * the cells sharing the same morphology. The most recently used entries are
+ * kept in memory and, if a folder is specified, all entries are stored on disk
+ * to be reused by later sessions.
+ */
+class MorphologyCache
+{
+public:
+    static const size_t DEFAULT_MAX_ENTRIES = 1024;
+
+    /**
+     * @param folder Folder of the on-disk cache, disabled if empty
+     * @param maxEntries Maximum number of entries kept in memory
+     */
+    MorphologyCache(const std::string& folder,
+                    size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+    const std::string& getFolder() const { return _folder; }
+
+    /**
+     * @brief getKey returns the key identifying a morphology file, using its
+     * path, size and modification time, combined with the given description
+     * of the parameters used to process it
+     */
+    static std::string getKey(const std::string& path,
+                              const std::string& parameters);
+
+    /**
+     * @brief get copies the geometry cached for the given key into the given
+     * container
+     * @return false if nothing is cached for the key
+     */
+    bool get(const std::string& key, ParallelModelContainer& container);
+
+    /**
+     * @brief put caches the geometry of the given container for the given key
+     */
+    void put(const std::string& key, const ParallelModelContainer& container);
+
+private:
+    using ContainerPtr = std::shared_ptr<const ParallelModelContainer>;
+    struct Entry
+    {
+        ContainerPtr container;
+        uint64_t lastUse{0};
+    };
+
+    ContainerPtr _load(const std::string& key) const;
+    void _save(const std::string& key,
+               const ParallelModelContainer& container) const;
+    void _insert(const std::string& key, const ContainerPtr& container);
+
+    const std::string _folder;
+    const size_t _maxEntries;
+    std::mutex _mutex;
+    std::unordered_map<std::string, Entry> _entries;
+    uint64_t _uses{0};
+};
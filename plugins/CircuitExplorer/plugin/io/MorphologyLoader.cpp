@@ -20,6 +20,7 @@
  */
 
 #include "MorphologyLoader.h"
+#include "MorphologyCache.h"
 #include "Utils.h"
 #include "meshing/MetaballsGenerator.h"
 #include <common/log.h>
@@ -33,6 +34,9 @@
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+#include <sstream>
+
 namespace
 {
 const std::string SUPPORTED_EXTENTION_H5 = "h5";
@@ -44,6 +48,16 @@ const float DEFAULT_MAX_BUTTON_SIZE = 0.40f;
 const float DEFAULT_MAX_SPINE_START_RADIUS = 0.17f;
 const float DEFAULT_POWER = 1.f;
 
+// Index used when processing a morphology for the cache. User data holding
+// it is set to the index of the actual cell when the geometry is reused
+const uint64_t CACHED_MORPHOLOGY_INDEX =
+    std::numeric_limits<uint64_t>::max() - 1;
+
+// Material used in the cache in place of the default material of the cell, so
+// that cells with different materials share the same cached geometry
+const size_t CACHED_MORPHOLOGY_MATERIAL =
+    std::numeric_limits<size_t>::max() - 1;
+
 // From http://en.cppreference.com/w/cpp/types/numeric_limits/epsilon
 template <class T>
 typename std::enable_if<!std::numeric_limits<T>::is_integer, bool>::type
@@ -61,6 +75,51 @@ inline double _getLastSampleRadius(const brain::neuron::Section& section)
 {
     return section[-1][3] * 0.5f;
 }
+
+template <typename T>
+void _setCellIndex(std::map<size_t, std::vector<T>>& geometries,
+                   const uint64_t index)
+{
+    for (auto& materialGeometries : geometries)
+        for (auto& geometry : materialGeometries.second)
+            if (geometry.userData == CACHED_MORPHOLOGY_INDEX)
+                geometry.userData = index;
+}
+
+template <typename T>
+void _setMaterialId(std::map<size_t, std::vector<T>>& geometries,
+                    const size_t from, const size_t to)
+{
+    auto it = geometries.find(from);
+    if (it == geometries.end())
+        return;
+    auto& target = geometries[to];
+    if (target.empty())
+        target.swap(it->second);
+    else
+        target.insert(target.end(), it->second.begin(), it->second.end());
+    geometries.erase(it);
+}
+
+void _setMaterialId(ParallelModelContainer& model, const size_t from,
+                    const size_t to)
+{
+    _setMaterialId(model.spheres, from, to);
+    _setMaterialId(model.cylinders, from, to);
+    _setMaterialId(model.cones, from, to);
+    std::replace(model.sdfMaterials.begin(), model.sdfMaterials.end(), from,
+                 to);
+}
+
+void _setCellIndex(ParallelModelContainer& model, const uint64_t index)
+{
+    _setCellIndex(model.spheres, index);
+    _setCellIndex(model.cylinders, index);
+    _setCellIndex(model.cones, index);
+    for (auto& geometry : model.sdfGeometries)
+        if (geometry.userData == CACHED_MORPHOLOGY_INDEX)
+            geometry.userData = index;
+}
 } // namespace
 
 MorphologyLoader::MorphologyLoader(brayns::Scene& scene,
@@ -96,8 +155,33 @@ MorphologyInfo MorphologyLoader::importMorphology(
     CompartmentReportPtr compartmentReport) const
 {
     ParallelModelContainer modelContainer;
-    _importMorphology(properties, source, index, modelContainer, transformation,
-                      compartmentReport, afferentSynapses, efferentSynapses);
+    if (_isCacheable(properties, source, compartmentReport, afferentSynapses,
+                     efferentSynapses))
+    {
+        auto cache = _getMorphologyCache(properties);
+        const auto key = _getCacheKey(properties, source);
+        // With a default material, all the geometry of the morphology uses
+        // it, and the cache holds it under a placeholder material instead
+        const bool useDefaultMaterial =
+            _defaultMaterialId != brayns::NO_MATERIAL;
+        if (!cache->get(key, modelContainer))
+        {
+            _importMorphology(properties, source, CACHED_MORPHOLOGY_INDEX,
+                              modelContainer, transformation, nullptr);
+            if (useDefaultMaterial)
+                _setMaterialId(modelContainer, _defaultMaterialId,
+                               CACHED_MORPHOLOGY_MATERIAL);
+            cache->put(key, modelContainer);
+        }
+        if (useDefaultMaterial)
+            _setMaterialId(modelContainer, CACHED_MORPHOLOGY_MATERIAL,
+                           _defaultMaterialId);
+        _setCellIndex(modelContainer, index);
+    }
+    else
+        _importMorphology(properties, source, index, modelContainer,
+                          transformation, compartmentReport, afferentSynapses,
+                          efferentSynapses);
 
     modelContainer.applyTransformation(transformation);
     modelContainer.addSpheresToModel(model);
@@ -913,6 +997,67 @@ size_t MorphologyLoader::_getMaterialIdFromColorScheme(
     return materialId;
 }
 
+bool MorphologyLoader::_isCacheable(const brayns::PropertyMap& properties,
+                                    const servus::URI& source,
+                                    CompartmentReportPtr compartmentReport,
+                                    brain::Synapses* afferentSynapses,
+                                    brain::Synapses* efferentSynapses) const
+{
+    // Simulation offsets are specific to each cell
+    if (compartmentReport || afferentSynapses || efferentSynapses)
+        return false;
+    if (source.getPath().empty())
+        return false;
+
+    // Points and realistic somas are cheap or not tessellated per section
+    const auto sectionTypes = getSectionTypesFromProperties(properties);
+    if (sectionTypes.size() == 1 &&
+        sectionTypes[0] == brain::neuron::SectionType::soma)
+        return false;
+    return !properties.getProperty<bool>(PROP_USE_REALISTIC_SOMA.name);
+}
+
+std::string MorphologyLoader::_getCacheKey(
+    const brayns::PropertyMap& properties, const servus::URI& source) const
+{
+    std::stringstream parameters;
+    for (const auto& name :
+         {PROP_SECTION_TYPE_SOMA.name, PROP_SECTION_TYPE_AXON.name,
+          PROP_SECTION_TYPE_DENDRITE.name,
+          PROP_SECTION_TYPE_APICAL_DENDRITE.name, PROP_USE_SDF_GEOMETRY.name,
+          PROP_DAMPEN_BRANCH_THICKNESS_CHANGERATE.name})
+        parameters << properties.getProperty<bool>(name) << ";";
+    for (const auto& name :
+         {PROP_RADIUS_MULTIPLIER.name, PROP_RADIUS_CORRECTION.name,
+          PROP_MORPHOLOGY_MAX_DISTANCE_TO_SOMA.name})
+        parameters << properties.getProperty<double>(name) << ";";
+    for (const auto& name :
+         {PROP_USER_DATA_TYPE.name, PROP_MORPHOLOGY_COLOR_SCHEME.name,
+          PROP_MORPHOLOGY_QUALITY.name})
+        parameters << properties.getProperty<std::string>(name) << ";";
+    // Only whether materials come from the color scheme or from the default
+    // material of the cell matters, see importMorphology
+    parameters << "material="
+               << (_defaultMaterialId != brayns::NO_MATERIAL ? "default"
+                                                             : "scheme");
+    return MorphologyCache::getKey(source.getPath(), parameters.str());
+}
+
+std::shared_ptr<MorphologyCache> MorphologyLoader::_getMorphologyCache(
+    const brayns::PropertyMap& properties) const
+{
+    const auto folder =
+        properties.hasProperty(PROP_MORPHOLOGY_CACHE_FOLDER.name)
+            ? properties.getProperty<std::string>(
+                  PROP_MORPHOLOGY_CACHE_FOLDER.name)
+            : std::string();
+
+    std::lock_guard<std::mutex> lock(_morphologyCacheMutex);
+    if (!_morphologyCache || _morphologyCache->getFolder() != folder)
+        _morphologyCache = std::make_shared<MorphologyCache>(folder);
+    return _morphologyCache;
+}
+
 brayns::ModelDescriptorPtr MorphologyLoader::importFromBlob(
     brayns::Blob&& /*blob*/, const brayns::LoaderProgress& /*callback*/,
     const brayns::PropertyMap& /*properties*/) const
@@ -962,6 +1107,7 @@ brayns::PropertyMap MorphologyLoader::getCLIProperties()
     pm.setProperty(PROP_MORPHOLOGY_COLOR_SCHEME);
     pm.setProperty(PROP_MORPHOLOGY_QUALITY);
     pm.setProperty(PROP_MORPHOLOGY_MAX_DISTANCE_TO_SOMA);
+    pm.setProperty(PROP_MORPHOLOGY_CACHE_FOLDER);
     return pm;
 }
 
@@ -32,6 +32,7 @@
 #include <brain/brain.h>
 #include <brion/brion.h>
 
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -41,6 +42,7 @@ class URI;
 }
 
 class AdvancedCircuitLoader;
+class MorphologyCache;
 struct ParallelModelContainer;
 using GIDOffsets = std::vector<uint64_t>;
 using CompartmentReportPtr = std::shared_ptr<brion::CompartmentReport>;
@@ -274,8 +276,34 @@ private:
         const brayns::PropertyMap& properties,
         const brain::neuron::SectionType& sectionType) const;
 
+    /**
+     * @brief _isCacheable returns true if the geometry of the morphology does
+     * not depend on the cell it is loaded for, and can then be shared with
+     * all other cells using the same morphology. The cache is never used
+     * when a compartment report is attached, since the simulation offsets
+     * of the geometry are specific to each cell.
+     */
+    bool _isCacheable(const brayns::PropertyMap& properties,
+                      const servus::URI& source,
+                      CompartmentReportPtr compartmentReport,
+                      brain::Synapses* afferentSynapses,
+                      brain::Synapses* efferentSynapses) const;
+
+    /**
+     * @brief _getCacheKey returns the morphology cache key for the given
+     * morphology and the loader parameters affecting its geometry
+     */
+    std::string _getCacheKey(const brayns::PropertyMap& properties,
+                             const servus::URI& source) const;
+
+    std::shared_ptr<MorphologyCache> _getMorphologyCache(
+        const brayns::PropertyMap& properties) const;
+
     size_t _defaultMaterialId{brayns::NO_MATERIAL};
     brayns::PropertyMap _defaults;
+
+    mutable std::mutex _morphologyCacheMutex;
+    mutable std::shared_ptr<MorphologyCache> _morphologyCache;
 };
 
 #endif // MORPHOLOGY_LOADER_H
@@ -24,12 +24,29 @@
 #include "SpikeSimulationHandler.h"
 #include <brayns/parameters/AnimationParameters.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace
 {
 const float DEFAULT_REST_VALUE = -80.f;
 const float DEFAULT_SPIKING_VALUE = -1.f;
 const float DEFAULT_TIME_INTERVAL = 0.01f;
 const float DEFAULT_DECAY_SPEED = 1.f;
+
+// Cells spiking within that time window after the current time are displayed
+// as spiking
+const float SPIKING_TIME_WINDOW = 1.f;
+
+// Number of frames after which a spiking cell has decayed to rest
+const uint64_t DECAY_FRAMES = std::ceil(
+    (DEFAULT_SPIKING_VALUE - DEFAULT_REST_VALUE) / DEFAULT_DECAY_SPEED);
+
+// Number of frames of spikes read at once from the report when indexing
+const uint32_t LOADING_FRAMES = 10000;
+
+// Number of cells processed by each task when generating a frame
+const int64_t CELLS_PER_TASK = 65536;
 } // namespace
 
 SpikeSimulationHandler::SpikeSimulationHandler(const std::string& reportPath,
@@ -39,19 +56,14 @@ SpikeSimulationHandler::SpikeSimulationHandler(const std::string& reportPath,
     , _gids(gids)
     , _spikeReport(new brain::SpikeReportReader(brain::URI(reportPath), gids))
 {
-    uint64_t c{0};
-    for (const auto gid : _gids)
-    {
-        _gidMap[gid] = c;
-        ++c;
-    }
-
     // Load simulation information from compartment reports
     _nbFrames = _spikeReport->getEndTime() / DEFAULT_TIME_INTERVAL;
     _dt = DEFAULT_TIME_INTERVAL;
     _frameSize = _gids.size();
     _frameData.resize(_frameSize, DEFAULT_REST_VALUE);
 
+    _buildSpikeIndex();
+
     PLUGIN_INFO << "-----------------------------------------------------------"
                 << std::endl;
     PLUGIN_INFO << "Spike simulation information" << std::endl;
@@ -65,6 +77,8 @@ SpikeSimulationHandler::SpikeSimulationHandler(const std::string& reportPath,
     PLUGIN_INFO << "Decay speed           : " << DEFAULT_DECAY_SPEED
                 << std::endl;
     PLUGIN_INFO << "Number of frames      : " << _nbFrames << std::endl;
+    PLUGIN_INFO << "Number of spikes      : " << _spikeIndex->indices.size()
+                << std::endl;
     PLUGIN_INFO << "-----------------------------------------------------------"
                 << std::endl;
 }
@@ -75,7 +89,7 @@ SpikeSimulationHandler::SpikeSimulationHandler(
     , _reportPath(rhs._reportPath)
     , _gids(rhs._gids)
     , _spikeReport(rhs._spikeReport)
-    , _gidMap(rhs._gidMap)
+    , _spikeIndex(rhs._spikeIndex)
 {
 }
 
@@ -84,27 +98,118 @@ void* SpikeSimulationHandler::getFrameData(const uint32_t frame)
     const auto boundedFrame = _getBoundedFrame(frame);
     if (_currentFrame != boundedFrame)
     {
-        for (size_t i = 0; i < _frameSize; ++i)
+        _generateFrame(boundedFrame);
+        _currentFrame = boundedFrame;
+    }
+
+    return _frameData.data();
+}
+
+void SpikeSimulationHandler::_buildSpikeIndex()
+{
+    auto spikeIndex = std::make_shared<SpikeIndex>();
+    auto& offsets = spikeIndex->offsets;
+    auto& indices = spikeIndex->indices;
+    offsets.reserve(_nbFrames + 1);
+    offsets.push_back(0);
+
+    // Dense GID to frame data index lookup
+    const uint32_t noIndex = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> gidIndices(_gids.empty() ? 0 : *_gids.rbegin() + 1,
+                                     noIndex);
+    uint32_t index{0};
+    for (const auto gid : _gids)
+        gidIndices[gid] = index++;
+
+    std::vector<std::pair<uint32_t, uint32_t>> frameSpikes;
+    for (uint32_t first = 0; first < _nbFrames; first += LOADING_FRAMES)
+    {
+        const uint32_t last = std::min(first + LOADING_FRAMES, _nbFrames);
+        const auto spikes = _spikeReport->getSpikes(first * _dt, last * _dt);
+
+        frameSpikes.clear();
+        for (const auto& spike : spikes)
         {
-            if (_frameData[i] > DEFAULT_REST_VALUE)
-                _frameData[i] -= DEFAULT_DECAY_SPEED;
-            else
-                _frameData[i] = DEFAULT_REST_VALUE;
+            if (spike.second >= gidIndices.size() ||
+                gidIndices[spike.second] == noIndex)
+                continue;
+            const auto spikeFrame =
+                std::min(std::max(static_cast<uint32_t>(spike.first / _dt),
+                                  first),
+                         last - 1);
+            frameSpikes.emplace_back(spikeFrame, gidIndices[spike.second]);
         }
+        std::sort(frameSpikes.begin(), frameSpikes.end());
 
-        const float ts = boundedFrame * _dt;
-        const float endTime = _spikeReport->getEndTime() - _dt;
-        const auto& spikes =
-            _spikeReport->getSpikes(std::min(ts, endTime),
-                                    std::min(ts + 1.f, endTime));
+        auto spike = frameSpikes.begin();
+        for (uint32_t frame = first; frame < last; ++frame)
+        {
+            for (; spike != frameSpikes.end() && spike->first == frame; ++spike)
+                indices.push_back(spike->second);
+            offsets.push_back(indices.size());
+        }
+    }
+    indices.shrink_to_fit();
+    _spikeIndex = spikeIndex;
+}
 
-        for (const auto spike : spikes)
-            _frameData[_gidMap[spike.second]] = DEFAULT_SPIKING_VALUE;
+void SpikeSimulationHandler::_generateFrame(const uint32_t frame)
+{
+    const float endTime = _spikeReport->getEndTime() - _dt;
+    const float frameTime = frame * _dt;
+    const float startTime = std::min(frameTime, endTime);
+    const float stopTime = std::min(startTime + SPIKING_TIME_WINDOW, endTime);
 
-        _currentFrame = boundedFrame;
-    }
+    const auto& offsets = _spikeIndex->offsets;
+    const auto& indices = _spikeIndex->indices;
+    if (offsets.size() < 2)
+        return;
 
-    return _frameData.data();
+    // Cells spiking from the current frame onwards are spiking, the ones that
+    // spiked within the last DECAY_FRAMES are decaying, all others are at rest
+    const uint64_t nbIndexedFrames = offsets.size() - 1;
+    const uint64_t currentFrame =
+        std::min<uint64_t>(std::lround(startTime / _dt), nbIndexedFrames - 1);
+    const uint64_t endFrame =
+        std::min<uint64_t>(std::lround(stopTime / _dt), nbIndexedFrames);
+    const uint64_t firstFrame =
+        currentFrame > DECAY_FRAMES ? currentFrame - DECAY_FRAMES : 0;
+
+    float* values = _frameData.data();
+    const int64_t nbCells = _frameSize;
+    const int64_t nbTasks = (nbCells + CELLS_PER_TASK - 1) / CELLS_PER_TASK;
+
+    // Each task owns a range of cells, and goes through the frames in
+    // chronological order so that the latest spike of a cell prevails
+#pragma omp parallel for
+    for (int64_t task = 0; task < nbTasks; ++task)
+    {
+        const uint32_t begin = task * CELLS_PER_TASK;
+        const uint32_t end = std::min(nbCells, (task + 1) * CELLS_PER_TASK);
+
+#pragma omp simd
+        for (uint32_t i = begin; i < end; ++i)
+            values[i] = DEFAULT_REST_VALUE;
+
+        for (uint64_t spikeFrame = firstFrame; spikeFrame < endFrame;
+             ++spikeFrame)
+        {
+            const float value =
+                spikeFrame >= currentFrame
+                    ? DEFAULT_SPIKING_VALUE
+                    : std::max(DEFAULT_REST_VALUE,
+                               DEFAULT_SPIKING_VALUE -
+                                   (currentFrame - spikeFrame) *
+                                       DEFAULT_DECAY_SPEED);
+
+            const auto last = indices.begin() + offsets[spikeFrame + 1];
+            for (auto i = std::lower_bound(indices.begin() +
+                                               offsets[spikeFrame],
+                                           last, begin);
+                 i != last && *i < end; ++i)
+                values[*i] = value;
+        }
+    }
 }
 
 brayns::AbstractSimulationHandlerPtr SpikeSimulationHandler::clone() const
@@ -30,6 +30,11 @@
 
 typedef std::shared_ptr<brain::SpikeReportReader> SpikeReportReaderPtr;
 
+/**
+ * @brief The SpikeSimulationHandler class generates frames from a spike
+ * report. Spikes are indexed once per frame, so that any frame can be
+ * computed from the few frames around it, without replaying the history.
+ */
 class SpikeSimulationHandler : public brayns::AbstractSimulationHandler
 {
 public:
@@ -45,11 +50,25 @@ public:
     brayns::AbstractSimulationHandlerPtr clone() const final;
 
 private:
+    /**
+     * Spikes bucketed by frame: the sorted frame data indices of the cells
+     * spiking during frame i are indices[offsets[i]] to
+     * indices[offsets[i + 1]].
+     */
+    struct SpikeIndex
+    {
+        std::vector<uint64_t> offsets;
+        std::vector<uint32_t> indices;
+    };
+
+    void _buildSpikeIndex();
+    void _generateFrame(uint32_t frame);
+
     std::string _reportPath;
     brain::GIDSet _gids;
     SpikeReportReaderPtr _spikeReport;
 
-    std::map<uint64_t, uint64_t> _gidMap;
+    std::shared_ptr<const SpikeIndex> _spikeIndex;
 };
 
 #endif // SPIKESIMULATIONHANDLER_H
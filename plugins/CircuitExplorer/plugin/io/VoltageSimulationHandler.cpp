@@ -52,6 +52,20 @@ VoltageSimulationHandler::VoltageSimulationHandler(
     PLUGIN_INFO << "Frame size           : " << _frameSize << std::endl;
     PLUGIN_INFO << "-----------------------------------------------------------"
                 << std::endl;
+
+    _setFrameLoader([report = _compartmentReport, dt = _dt,
+                     nbFrames = _nbFrames](const uint32_t frame,
+                                           brayns::floats& buffer) {
+        float timestamp = frame * dt;
+        timestamp = std::min(static_cast<float>(nbFrames), timestamp);
+
+        // brion only loads into its own buffer, which is copied to keep the
+        // preallocated buffer of the prefetch ring
+        const auto loadedFrame = report->loadFrame(timestamp).get();
+        if (!loadedFrame.data)
+            PLUGIN_THROW("No data for timestamp " + std::to_string(timestamp));
+        buffer.assign(loadedFrame.data->begin(), loadedFrame.data->end());
+    });
 }
 
 VoltageSimulationHandler::VoltageSimulationHandler(
@@ -77,60 +91,8 @@ bool VoltageSimulationHandler::isReady() const
 
 void* VoltageSimulationHandler::getFrameData(const uint32_t frame)
 {
-    const auto boundedFrame = _getBoundedFrame(frame);
-
-    if (!_currentFrameFuture.valid() && _currentFrame != boundedFrame)
-        _triggerLoading(boundedFrame);
-
-    if (!_makeFrameReady(boundedFrame))
-        return nullptr;
-
-    return _frameData.data();
-}
-
-void VoltageSimulationHandler::_triggerLoading(const uint32_t frame)
-{
-    float timestamp = frame * _dt;
-    timestamp = std::min(static_cast<float>(_nbFrames), timestamp);
-
-    if (_currentFrameFuture.valid())
-        _currentFrameFuture.wait();
-
-    _ready = false;
-    _currentFrameFuture = _compartmentReport->loadFrame(timestamp);
-}
-
-bool VoltageSimulationHandler::_isFrameLoaded() const
-{
-    if (!_currentFrameFuture.valid())
-        return false;
-
-    if (_synchronousMode)
-    {
-        _currentFrameFuture.wait();
-        return true;
-    }
-
-    return _currentFrameFuture.wait_for(std::chrono::milliseconds(0)) ==
-           std::future_status::ready;
-}
-
-bool VoltageSimulationHandler::_makeFrameReady(const uint32_t frame)
-{
-    if (_isFrameLoaded())
-    {
-        try
-        {
-            _frameData = std::move(*_currentFrameFuture.get().data);
-        }
-        catch (const std::exception& e)
-        {
-            PLUGIN_ERROR << "Error loading simulation frame " << frame << ": "
-                         << e.what() << std::endl;
-            return false;
-        }
-        _currentFrame = frame;
-        _ready = true;
-    }
-    return true;
+    auto data = _getPrefetchedFrameData(_getBoundedFrame(frame),
+                                        _synchronousMode);
+    _ready = data != nullptr;
+    return data;
 }
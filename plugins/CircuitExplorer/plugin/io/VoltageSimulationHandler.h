@@ -63,15 +63,10 @@ public:
     brayns::AbstractSimulationHandlerPtr clone() const final;
 
 private:
-    void _triggerLoading(const uint32_t frame);
-    bool _isFrameLoaded() const;
-    bool _makeFrameReady(const uint32_t frame);
     bool _synchronousMode{false};
 
     std::string _reportPath;
     CompartmentReportPtr _compartmentReport;
-    std::future<brion::Frame> _currentFrameFuture;
-    std::map<uint64_t, std::vector<float>> _frames;
     bool _ready{false};
 };
 
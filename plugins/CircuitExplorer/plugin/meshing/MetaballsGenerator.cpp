@@ -22,14 +22,28 @@
  */
 
 #include "MetaballsGenerator.h"
+#include "../../common/log.h"
 
-#include <brayns/common/geometry/Sphere.h>
+#include <brayns/common/Timer.h>
 #include <brayns/common/geometry/TriangleMesh.h>
-#include <brayns/common/log.h>
-#include <brayns/engine/Material.h>
+
+#include <algorithm>
+#include <cmath>
 
 const size_t NB_EDGES = 12;
 
+// Number of cubes per dimension of the blocks used for binning the metaballs
+const uint32_t BLOCK_SIZE = 8;
+
+// Fraction of the threshold at which the field of a metaball is cut off. It
+// defines the radius of influence of each ball, beyond which its field is zero.
+const float FIELD_CUTOFF = 0.01f;
+
+// Grid offsets of the 8 corners of a cube, in marching cubes order
+const uint32_t CUBE_CORNERS[8][3] = {{0, 0, 0}, {0, 0, 1}, {0, 1, 1},
+                                     {0, 1, 0}, {1, 0, 0}, {1, 0, 1},
+                                     {1, 1, 1}, {1, 1, 0}};
+
 const size_t METABALLS_VERTICES[24] = {0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6,
                                        6, 7, 7, 4, 0, 4, 1, 5, 2, 6, 3, 7};
 
@@ -322,250 +336,279 @@ MetaballsGenerator::~MetaballsGenerator()
     _clear();
 }
 
-void MetaballsGenerator::_buildVerticesAndCubes(
-    const brayns::Vector4fs& metaballs, const size_t gridSize,
-    const size_t defaultMaterialId, const float scale)
+void MetaballsGenerator::_buildGrid(const brayns::Vector4fs& metaballs,
+                                    const size_t gridSize, const float scale)
 {
-    // Determine bounding box
+    // Determine bounding box, including the radius of the balls so that the
+    // grid is never flat
     brayns::Box<float> bounds;
     for (const auto& ball : metaballs)
-        bounds.merge(brayns::Vector3f(ball.x, ball.y, ball.z));
+    {
+        const brayns::Vector3f center(ball.x, ball.y, ball.z);
+        bounds.merge(center - ball.w);
+        bounds.merge(center + ball.w);
+    }
     const auto center = bounds.getCenter();
 
     // Upscale the bounding box to make sure there is no whole in the isosurface
-    auto rescaledBounds =
-        brayns::Box<float>(center - bounds.getSize() * scale / 2.f,
-                           center + bounds.getSize() * scale / 2.f);
+    const auto rescaledSize = bounds.getSize() * scale;
+    _gridSize = gridSize;
+    _gridOrigin = center - rescaledSize / 2.f;
+    _cellSize = rescaledSize / static_cast<float>(gridSize);
+
+    PLUGIN_DEBUG << "Nb metaballs   : " << metaballs.size() << std::endl;
+    PLUGIN_DEBUG << "Grid size      : " << gridSize << std::endl;
+    PLUGIN_DEBUG << "Grid dimensions: " << bounds << "/" << bounds.getSize()
+                 << std::endl;
+}
 
-    const auto rescaledSize = rescaledBounds.getSize();
-    const size_t incrementedSize = gridSize + 1;
-    _vertices.resize(incrementedSize * incrementedSize * incrementedSize);
+brayns::Vector3f MetaballsGenerator::_getVertexPosition(
+    const brayns::Vector3ui& index) const
+{
+    return _gridOrigin + brayns::Vector3f(index) * _cellSize;
+}
 
-    size_t x = 0;
-    for (x = 0; x < incrementedSize; ++x)
+bool MetaballsGenerator::_getVertexRange(const brayns::Vector3f& center,
+                                         const float radius,
+                                         brayns::Vector3ui& first,
+                                         brayns::Vector3ui& last) const
+{
+    for (size_t i = 0; i < 3; ++i)
     {
-        for (size_t y = 0; y < incrementedSize; ++y)
+        const float min = center[i] - radius - _gridOrigin[i];
+        const float max = center[i] + radius - _gridOrigin[i];
+        if (_cellSize[i] == 0.f)
         {
-            for (size_t z = 0; z < incrementedSize; ++z)
-            {
-                CubeGridVertex cgv;
-                cgv.position.x =
-                    rescaledBounds.getMin().x + x * rescaledSize.x / gridSize;
-                cgv.position.y =
-                    rescaledBounds.getMin().y + y * rescaledSize.y / gridSize;
-                cgv.position.z =
-                    rescaledBounds.getMin().z + z * rescaledSize.z / gridSize;
-
-                cgv.texCoords.x =
-                    static_cast<float>(x) / static_cast<float>(gridSize);
-                cgv.texCoords.y =
-                    static_cast<float>(y) / static_cast<float>(gridSize);
-                cgv.texCoords.z = 0.f;
-
-                cgv.value = 0.f;
-                cgv.normal = {0.f, 0.f, 0.f};
-
-                cgv.materialId = defaultMaterialId;
-
-                const size_t index = x * incrementedSize * incrementedSize +
-                                     y * incrementedSize + z;
-
-                _vertices[index] = cgv;
-            }
+            // Flat grid, all vertices share the same coordinate
+            if (min > 0.f || max < 0.f)
+                return false;
+            first[i] = 0;
+            last[i] = _gridSize;
+            continue;
         }
-    }
 
-    _cubes.resize(gridSize * gridSize * gridSize);
-    for (x = 0; x < gridSize; ++x)
-    {
-        for (size_t y = 0; y < gridSize; ++y)
-        {
-            for (size_t z = 0; z < gridSize; ++z)
-            {
-                CubeGridCube cgc;
-                cgc.vertices[0] =
-                    &_vertices[(x * incrementedSize + y) * incrementedSize + z];
-                cgc.vertices[1] =
-                    &_vertices[(x * incrementedSize + y) * incrementedSize + z +
-                               1];
-                cgc.vertices[2] = &_vertices[(x * incrementedSize + (y + 1)) *
-                                                 incrementedSize +
-                                             z + 1];
-                cgc.vertices[3] = &_vertices[(x * incrementedSize + (y + 1)) *
-                                                 incrementedSize +
-                                             z];
-                cgc.vertices[4] = &_vertices[((x + 1) * incrementedSize + y) *
-                                                 incrementedSize +
-                                             z];
-                cgc.vertices[5] = &_vertices[((x + 1) * incrementedSize + y) *
-                                                 incrementedSize +
-                                             z + 1];
-                cgc.vertices[6] =
-                    &_vertices[((x + 1) * incrementedSize + (y + 1)) *
-                                   incrementedSize +
-                               z + 1];
-                cgc.vertices[7] =
-                    &_vertices[((x + 1) * incrementedSize + (y + 1)) *
-                                   incrementedSize +
-                               z];
-
-                const size_t index = x * gridSize * gridSize + y * gridSize + z;
-                _cubes[index] = cgc;
-            }
-        }
+        const float firstVertex = std::ceil(min / _cellSize[i]);
+        const float lastVertex = std::floor(max / _cellSize[i]);
+        if (lastVertex < 0.f || firstVertex > float(_gridSize) ||
+            firstVertex > lastVertex)
+            return false;
+        first[i] = static_cast<uint32_t>(std::max(firstVertex, 0.f));
+        last[i] = static_cast<uint32_t>(
+            std::min(lastVertex, static_cast<float>(_gridSize)));
     }
-
-    BRAYNS_DEBUG << "Nb metaballs   : " << metaballs.size() << std::endl;
-    BRAYNS_DEBUG << "Nb Vertices    : " << _vertices.size() << std::endl;
-    BRAYNS_DEBUG << "Nb Cubes       : " << _cubes.size() << std::endl;
-    BRAYNS_DEBUG << "Grid size      : " << gridSize << std::endl;
-    BRAYNS_DEBUG << "Grid dimensions: " << bounds << "/" << bounds.getSize()
-                 << std::endl;
+    return true;
 }
 
-void MetaballsGenerator::_buildTriangles(const brayns::Vector4fs& metaballs,
-                                         const float threshold,
-                                         const size_t defaultMaterialId,
-                                         brayns::TriangleMeshMap& triangles)
+void MetaballsGenerator::_binMetaballs(const brayns::Vector4fs& metaballs,
+                                       const float threshold)
 {
-    for (const auto metaball : metaballs)
+    const float influence = 1.f / std::sqrt(threshold * FIELD_CUTOFF);
+    const uint32_t lastCube = _gridSize - 1;
+    for (uint32_t i = 0; i < metaballs.size(); ++i)
     {
-        const auto radius = metaball.w;
-        const auto squaredRadius = radius * radius;
-
-        for (auto& vertex : _vertices)
-        {
-            const auto ballToPoint =
-                vertex.position - brayns::Vector3f(metaball);
-
-            // get squared distance from ball to point
-            const auto distance = ballToPoint.length();
-            auto squaredDistance = distance * distance;
-
-            if (squaredDistance == 0.f)
-                continue;
-
-            const auto normalScale = squaredRadius / squaredDistance;
-            vertex.value += normalScale;
-
-            if (distance < threshold)
-                vertex.materialId = defaultMaterialId;
+        const auto& metaball = metaballs[i];
+        brayns::Vector3ui first, last;
+        if (!_getVertexRange(brayns::Vector3f(metaball), metaball.w * influence,
+                             first, last))
+            continue;
 
-            vertex.normal += ballToPoint * normalScale;
-        }
+        // A vertex is shared by the cubes on both of its sides
+        const brayns::Vector3ui firstBlock =
+            (glm::max(first, brayns::Vector3ui(1)) - 1u) / BLOCK_SIZE;
+        const brayns::Vector3ui lastBlock =
+            glm::min(last, brayns::Vector3ui(lastCube)) / BLOCK_SIZE;
+
+        const size_t nbBlocks = (_gridSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        for (uint32_t x = firstBlock.x; x <= lastBlock.x; ++x)
+            for (uint32_t y = firstBlock.y; y <= lastBlock.y; ++y)
+                for (uint32_t z = firstBlock.z; z <= lastBlock.z; ++z)
+                {
+                    auto& block = _blocks[(x * nbBlocks + y) * nbBlocks + z];
+                    block.origin = brayns::Vector3ui(x, y, z) * BLOCK_SIZE;
+                    block.metaballs.push_back(i);
+                }
     }
+}
 
-    for (const auto& cube : _cubes)
+void MetaballsGenerator::_buildBlockTriangles(
+    const Block& block, const brayns::Vector4fs& metaballs,
+    const float threshold, brayns::TriangleMesh& mesh) const
+{
+    // Vertices of the block, including the ones shared with the next blocks
+    const brayns::Vector3ui nbCubes =
+        glm::min(brayns::Vector3ui(BLOCK_SIZE),
+                 brayns::Vector3ui(_gridSize) - block.origin);
+    const brayns::Vector3ui nbVertices = nbCubes + 1u;
+    std::vector<GridVertex> vertices(nbVertices.x * nbVertices.y *
+                                     nbVertices.z);
+    const auto vertexIndex = [&](const uint32_t x, const uint32_t y,
+                                 const uint32_t z) {
+        return (x * nbVertices.y + y) * nbVertices.z + z;
+    };
+
+    // Accumulate the scalar field of the metaballs within their radius of
+    // influence only. The field of a ball is shifted down by its value at that
+    // radius so that it smoothly reaches zero there.
+    const float influence = 1.f / std::sqrt(threshold * FIELD_CUTOFF);
+    const brayns::Vector3ui blockLast = block.origin + nbCubes;
+    for (const auto i : block.metaballs)
     {
-        unsigned char cubeIndex = 0;
-
-        if (cube.vertices[0]->value > 0.f &&
-            cube.vertices[0]->value < threshold)
-            cubeIndex |= 1;
-        if (cube.vertices[1]->value > 0.f &&
-            cube.vertices[1]->value < threshold)
-            cubeIndex |= 2;
-        if (cube.vertices[2]->value > 0.f &&
-            cube.vertices[2]->value < threshold)
-            cubeIndex |= 4;
-        if (cube.vertices[3]->value > 0.f &&
-            cube.vertices[3]->value < threshold)
-            cubeIndex |= 8;
-        if (cube.vertices[4]->value > 0.f &&
-            cube.vertices[4]->value < threshold)
-            cubeIndex |= 16;
-        if (cube.vertices[5]->value > 0.f &&
-            cube.vertices[5]->value < threshold)
-            cubeIndex |= 32;
-        if (cube.vertices[6]->value > 0.f &&
-            cube.vertices[6]->value < threshold)
-            cubeIndex |= 64;
-        if (cube.vertices[7]->value > 0.f &&
-            cube.vertices[7]->value < threshold)
-            cubeIndex |= 128;
-
-        int usedEdges = METABALLS_EDGES[cubeIndex];
-
-        if (usedEdges == 0 || usedEdges == 255)
+        const auto& metaball = metaballs[i];
+        const brayns::Vector3f center(metaball);
+        const auto squaredRadius = metaball.w * metaball.w;
+        const auto influenceRadius = metaball.w * influence;
+        const auto squaredInfluence = influenceRadius * influenceRadius;
+        const auto cutoff = squaredRadius / squaredInfluence;
+        // Bounds the field of a ball on vertices that are very close to its
+        // center
+        const auto minSquaredDistance = squaredRadius * 1e-6f;
+
+        brayns::Vector3ui first, last;
+        if (!_getVertexRange(center, influenceRadius, first, last))
             continue;
+        first = glm::max(first, block.origin);
+        last = glm::min(last, blockLast);
+
+        for (uint32_t x = first.x; x <= last.x; ++x)
+            for (uint32_t y = first.y; y <= last.y; ++y)
+                for (uint32_t z = first.z; z <= last.z; ++z)
+                {
+                    const brayns::Vector3ui index(x, y, z);
+                    const auto ballToPoint = _getVertexPosition(index) - center;
+
+                    const auto squaredDistance =
+                        std::max(glm::dot(ballToPoint, ballToPoint),
+                                 minSquaredDistance);
+                    if (squaredDistance >= squaredInfluence)
+                        continue;
+
+                    const brayns::Vector3ui local = index - block.origin;
+                    auto& vertex =
+                        vertices[vertexIndex(local.x, local.y, local.z)];
+                    const auto normalScale = squaredRadius / squaredDistance;
+                    vertex.value += normalScale - cutoff;
+                    vertex.normal += ballToPoint * normalScale;
+                }
+    }
 
-        for (size_t currentEdge = 0; currentEdge < NB_EDGES; ++currentEdge)
-        {
-            // Check usedEdges against 1,2,4,8,16,...,2048
-            if (usedEdges & (1 << currentEdge))
+    // March the cubes of the block
+    brayns::Vector3f edgePositions[NB_EDGES];
+    brayns::Vector3f edgeNormals[NB_EDGES];
+    for (uint32_t x = 0; x < nbCubes.x; ++x)
+        for (uint32_t y = 0; y < nbCubes.y; ++y)
+            for (uint32_t z = 0; z < nbCubes.z; ++z)
             {
-                CubeGridVertex* v1 =
-                    cube.vertices[METABALLS_VERTICES[currentEdge * 2]];
-                CubeGridVertex* v2 =
-                    cube.vertices[METABALLS_VERTICES[currentEdge * 2 + 1]];
-
-                const float denom = (v2->value - v1->value);
-                if (fabs(denom) < 0.00001f)
+                const GridVertex* corners[8];
+                unsigned char cubeIndex = 0;
+                for (size_t c = 0; c < 8; ++c)
+                {
+                    corners[c] = &vertices[vertexIndex(x + CUBE_CORNERS[c][0],
+                                                       y + CUBE_CORNERS[c][1],
+                                                       z + CUBE_CORNERS[c][2])];
+                    if (corners[c]->value < threshold)
+                        cubeIndex |= 1 << c;
+                }
+
+                const int usedEdges = METABALLS_EDGES[cubeIndex];
+                if (usedEdges == 0)
                     continue;
 
-                auto delta = (threshold - v1->value) / denom;
-
-                brayns::Vector3f position;
-                position.x =
-                    v1->position.x + delta * (v2->position.x - v1->position.x);
-                position.y =
-                    v1->position.y + delta * (v2->position.y - v1->position.y);
-                position.z =
-                    v1->position.z + delta * (v2->position.z - v1->position.z);
-
-                brayns::Vector3f normal;
-                normal.x = v1->normal.x + delta * (v2->normal.x - v1->normal.x);
-                normal.y = v1->normal.y + delta * (v2->normal.y - v1->normal.y);
-                normal.z = v1->normal.z + delta * (v2->normal.z - v1->normal.z);
-
-                _edgeVertices[currentEdge].position = position;
-                _edgeVertices[currentEdge].normal = normal;
-                _edgeVertices[currentEdge].materialId = v1->materialId;
+                const brayns::Vector3ui cube =
+                    block.origin + brayns::Vector3ui(x, y, z);
+                for (size_t edge = 0; edge < NB_EDGES; ++edge)
+                {
+                    // Check usedEdges against 1,2,4,8,16,...,2048
+                    if (!(usedEdges & (1 << edge)))
+                        continue;
+
+                    const auto c1 = METABALLS_VERTICES[edge * 2];
+                    const auto c2 = METABALLS_VERTICES[edge * 2 + 1];
+                    const auto v1 = corners[c1];
+                    const auto v2 = corners[c2];
+
+                    const float denom = v2->value - v1->value;
+                    const float delta = std::abs(denom) < 0.00001f
+                                            ? 0.f
+                                            : (threshold - v1->value) / denom;
+
+                    const auto p1 = _getVertexPosition(
+                        cube + brayns::Vector3ui(CUBE_CORNERS[c1][0],
+                                                 CUBE_CORNERS[c1][1],
+                                                 CUBE_CORNERS[c1][2]));
+                    const auto p2 = _getVertexPosition(
+                        cube + brayns::Vector3ui(CUBE_CORNERS[c2][0],
+                                                 CUBE_CORNERS[c2][1],
+                                                 CUBE_CORNERS[c2][2]));
+                    edgePositions[edge] = p1 + delta * (p2 - p1);
+                    edgeNormals[edge] =
+                        v1->normal + delta * (v2->normal - v1->normal);
+                }
+
+                for (auto k = 0; METABALLS_TRIANGLES[cubeIndex][k] != -1;
+                     k += 3)
+                {
+                    const uint32_t verticesIndex = mesh.vertices.size();
+                    for (auto f = 0; f < 3; ++f)
+                    {
+                        const auto edge = METABALLS_TRIANGLES[cubeIndex][k + f];
+                        mesh.vertices.push_back(edgePositions[edge]);
+                        mesh.normals.push_back(normalize(edgeNormals[edge]));
+                    }
+                    mesh.indices.push_back(brayns::Vector3ui(verticesIndex,
+                                                             verticesIndex + 1,
+                                                             verticesIndex +
+                                                                 2));
+                }
             }
-        }
-
-        auto& vertices = triangles[defaultMaterialId].vertices;
-        auto& normals = triangles[defaultMaterialId].normals;
-        auto& indices = triangles[defaultMaterialId].indices;
-
-        for (auto k = 0; METABALLS_TRIANGLES[cubeIndex][k] != -1; k += 3)
-        {
-            const auto verticesIndex = vertices.size();
-
-            // Create triangulated face
-            bool processFace = true;
-            for (auto f = 0; f < 3 && processFace; ++f)
-            {
-                const auto index = METABALLS_TRIANGLES[cubeIndex][k + f];
-                if (size_t(index) >= _edgeVertices.size())
-                    processFace = false;
-            }
-            if (!processFace)
-                continue;
-
-            for (auto f = 0; f < 3; ++f)
-            {
-                const auto index = METABALLS_TRIANGLES[cubeIndex][k + f];
-
-                const auto vertex = _edgeVertices[index].position;
-                vertices.push_back(vertex);
+}
 
-                const auto normal = normalize(_edgeVertices[index].normal);
-                normals.push_back(normal);
-            }
+void MetaballsGenerator::_buildTriangles(const brayns::Vector4fs& metaballs,
+                                         const float threshold,
+                                         const size_t defaultMaterialId,
+                                         brayns::TriangleMeshMap& triangles)
+{
+    std::vector<const Block*> blocks;
+    blocks.reserve(_blocks.size());
+    for (const auto& block : _blocks)
+        blocks.push_back(&block.second);
+
+    // Blocks are independent and meshed in parallel
+    std::vector<brayns::TriangleMesh> meshes(blocks.size());
+#pragma omp parallel for schedule(dynamic)
+    for (uint64_t i = 0; i < blocks.size(); ++i)
+        _buildBlockTriangles(*blocks[i], metaballs, threshold, meshes[i]);
+
+    // Merge the meshes of the blocks, in order, at offsets given by a prefix
+    // sum of their sizes
+    auto& mesh = triangles[defaultMaterialId];
+    std::vector<size_t> vertexOffsets(meshes.size() + 1, mesh.vertices.size());
+    std::vector<size_t> indexOffsets(meshes.size() + 1, mesh.indices.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        vertexOffsets[i + 1] = vertexOffsets[i] + meshes[i].vertices.size();
+        indexOffsets[i + 1] = indexOffsets[i] + meshes[i].indices.size();
+    }
+    mesh.vertices.resize(vertexOffsets.back());
+    mesh.normals.resize(vertexOffsets.back());
+    mesh.indices.resize(indexOffsets.back());
 
-            indices.push_back(brayns::Vector3ui(verticesIndex,
-                                                verticesIndex + 1,
-                                                verticesIndex + 2));
-        }
+#pragma omp parallel for
+    for (uint64_t i = 0; i < meshes.size(); ++i)
+    {
+        const auto& blockMesh = meshes[i];
+        std::copy(blockMesh.vertices.begin(), blockMesh.vertices.end(),
+                  mesh.vertices.begin() + vertexOffsets[i]);
+        std::copy(blockMesh.normals.begin(), blockMesh.normals.end(),
+                  mesh.normals.begin() + vertexOffsets[i]);
+        const brayns::Vector3ui offset(vertexOffsets[i]);
+        for (size_t j = 0; j < blockMesh.indices.size(); ++j)
+            mesh.indices[indexOffsets[i] + j] = blockMesh.indices[j] + offset;
     }
 }
 
 void MetaballsGenerator::_clear()
 {
-    _edgeVertices.resize(NB_EDGES);
-    _vertices.clear();
-    _cubes.clear();
+    _blocks.clear();
 }
 
 void MetaballsGenerator::generateMesh(const brayns::Vector4fs& metaballs,
@@ -574,7 +617,23 @@ void MetaballsGenerator::generateMesh(const brayns::Vector4fs& metaballs,
                                       const size_t defaultMaterialId,
                                       brayns::TriangleMeshMap& triangles)
 {
+    // Vertices with a value below the threshold are outside of the surface,
+    // there is no surface for a non positive threshold.
+    if (metaballs.empty() || gridSize == 0 || threshold <= 0.f)
+        return;
+
+    brayns::Timer chrono;
     _clear();
-    _buildVerticesAndCubes(metaballs, gridSize, defaultMaterialId);
+    _buildGrid(metaballs, gridSize);
+    _binMetaballs(metaballs, threshold);
+    const auto nbBlocks = _blocks.size();
+    const auto nbTriangles = triangles[defaultMaterialId].indices.size();
     _buildTriangles(metaballs, threshold, defaultMaterialId, triangles);
+    _clear();
+    PLUGIN_TIMER(chrono.elapsed(),
+                 "Meshing of " << metaballs.size() << " metaballs in "
+                               << nbBlocks << " blocks: "
+                               << triangles[defaultMaterialId].indices.size() -
+                                      nbTriangles
+                               << " triangles");
 }
@@ -26,6 +26,9 @@
 
 #include <brayns/common/types.h>
 
+#include <map>
+#include <vector>
+
 /**
  * Generated a mesh according to given set of metaballs.
  */
@@ -51,52 +54,45 @@ public:
                       brayns::TriangleMeshMap& triangles);
 
 private:
-    struct SurfaceVertex
-    {
-        SurfaceVertex()
-            : materialId(0)
-        {
-        }
-
-        brayns::Vector3f position;
-        brayns::Vector3f normal;
-        brayns::Vector3f texCoords;
-        size_t materialId;
-    };
-
-    struct CubeGridVertex : public SurfaceVertex
+    struct GridVertex
     {
-        CubeGridVertex()
-            : SurfaceVertex()
-            , value(0)
-        {
-        }
-
-        float value; // Value of the scalar field
+        brayns::Vector3f normal{0.f, 0.f, 0.f};
+        float value{0.f}; // Value of the scalar field
     };
 
-    struct CubeGridCube
+    /** Cubic block of cubes of the grid, with the metaballs influencing it */
+    struct Block
     {
-        CubeGridVertex* vertices[8];
+        brayns::Vector3ui origin; // First cube of the block
+        std::vector<uint32_t> metaballs;
     };
 
-    typedef std::vector<CubeGridVertex> Vertices;
-    typedef std::vector<CubeGridCube> Cubes;
-    typedef std::vector<SurfaceVertex> SurfaceVertices;
-
     void _clear();
 
-    void _buildVerticesAndCubes(const brayns::Vector4fs& metaballs,
-                                const size_t gridSize,
-                                const size_t defaultMaterialId,
-                                const float scale = 5.f);
+    void _buildGrid(const brayns::Vector4fs& metaballs, const size_t gridSize,
+                    const float scale = 5.f);
+
+    void _binMetaballs(const brayns::Vector4fs& metaballs,
+                       const float threshold);
 
     void _buildTriangles(const brayns::Vector4fs& metaballs,
                          const float threshold, const size_t defaultMaterialId,
                          brayns::TriangleMeshMap& triangles);
 
-    SurfaceVertices _edgeVertices;
-    Vertices _vertices;
-    Cubes _cubes;
+    void _buildBlockTriangles(const Block& block,
+                              const brayns::Vector4fs& metaballs,
+                              const float threshold,
+                              brayns::TriangleMesh& mesh) const;
+
+    bool _getVertexRange(const brayns::Vector3f& center, const float radius,
+                         brayns::Vector3ui& first,
+                         brayns::Vector3ui& last) const;
+
+    brayns::Vector3f _getVertexPosition(const brayns::Vector3ui& index) const;
+
+    size_t _gridSize{0};
+    brayns::Vector3f _gridOrigin;
+    brayns::Vector3f _cellSize;
+    std::map<size_t, Block> _blocks;
 };
 #endif // METABALLSGENERATOR_H
@@ -0,0 +1,90 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of the circuit explorer for Brayns
+ * <https://github.com/favreau/Brayns-UC-CircuitExplorer>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include "PointCloudMeshingFunctor.h"
+#include "../../common/log.h"
+
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+
+PointCloudMeshingFunctor::PointCloudMeshingFunctor(
+    brayns::Engine& engine, PointCloud&& pointCloud, const std::string& name,
+    const Shape shape, const size_t gridSize, const float threshold)
+    : _engine(engine)
+    , _pointCloud(std::move(pointCloud))
+    , _name(name)
+    , _shape(shape)
+    , _gridSize(gridSize)
+    , _threshold(threshold)
+{
+}
+
+Result PointCloudMeshingFunctor::operator()()
+{
+    Result result;
+    if (_pointCloud.empty())
+    {
+        result.error = "No points to mesh for " + _name;
+        PLUGIN_INFO << result.error << std::endl;
+        return result;
+    }
+
+    auto& scene = _engine.getScene();
+    auto meshModel = scene.createModel();
+    PointCloudMesher mesher;
+
+    // Mesh one material at a time to report progress and honour cancellation
+    // in between
+    const float increment = 1.f / _pointCloud.size();
+    float amount = 0.f;
+    bool meshed = false;
+    for (auto& points : _pointCloud)
+    {
+        progress("Meshing material " + std::to_string(points.first),
+                 increment, amount);
+
+        PointCloud materialPoints;
+        materialPoints[points.first] = std::move(points.second);
+        if (_shape == Shape::metaballs)
+            meshed |= mesher.toMetaballs(*meshModel, materialPoints, _gridSize,
+                                         _threshold);
+        else
+            meshed |= mesher.toConvexHull(*meshModel, materialPoints);
+        amount += increment;
+    }
+    cancelCheck();
+
+    if (!meshed)
+    {
+        result.error = "No mesh was created for " + _name;
+        PLUGIN_INFO << result.error << std::endl;
+        return result;
+    }
+
+    scene.addModel(
+        std::make_shared<brayns::ModelDescriptor>(std::move(meshModel), _name));
+    _engine.triggerRender();
+    PLUGIN_INFO << "Mesh successfully added to the scene" << std::endl;
+
+    result.success = true;
+    return result;
+}
@@ -0,0 +1,72 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ * All rights reserved. Do not distribute without permission.
+ *
+ * This file is part of the circuit explorer for Brayns
+ * <https://github.com/favreau/Brayns-UC-CircuitExplorer>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#ifndef POINTCLOUDMESHINGFUNCTOR_H
+#define POINTCLOUDMESHINGFUNCTOR_H
+
+#include "PointCloudMesher.h"
+
+#include <api/CircuitExplorerParams.h>
+
+#include <brayns/common/tasks/TaskFunctor.h>
+#include <brayns/common/types.h>
+
+/**
+ * A task functor which meshes a point cloud, either as convex hulls or as
+ * metaballs, and adds the resulting model to the scene. The point cloud is
+ * gathered by the caller so that the functor never touches the source model
+ * while it is running in the background.
+ */
+class PointCloudMeshingFunctor : public brayns::TaskFunctor
+{
+public:
+    enum class Shape
+    {
+        convexHull,
+        metaballs
+    };
+
+    /**
+     * @param engine Engine owning the scene the mesh is added to
+     * @param pointCloud Points to mesh, per material
+     * @param name Name of the model created for the mesh
+     * @param shape Meshing algorithm
+     * @param gridSize Grid size used by the metaballs algorithm
+     * @param threshold Threshold used by the metaballs algorithm
+     */
+    PointCloudMeshingFunctor(brayns::Engine& engine, PointCloud&& pointCloud,
+                             const std::string& name, const Shape shape,
+                             const size_t gridSize = 0,
+                             const float threshold = 0.f);
+    PointCloudMeshingFunctor(PointCloudMeshingFunctor&&) = default;
+
+    Result operator()();
+
+private:
+    brayns::Engine& _engine;
+    PointCloud _pointCloud;
+    std::string _name;
+    Shape _shape;
+    size_t _gridSize;
+    float _threshold;
+};
+
+#endif // POINTCLOUDMESHINGFUNCTOR_H
@@ -31,6 +31,10 @@
 
 #include <brain/brain.h>
 
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <queue>
 #include <regex>
 #include <unordered_set>
 
@@ -56,6 +60,9 @@ const Property PROP_TARGETS = {
     {"Targets", "Circuit targets [comma separated list of int, int-int or label]"}};
 const Property PROP_SYNCHRONOUS_MODE = {
     "synchronousMode", false, {"Synchronous mode"}};
+const Property PROP_PIPELINE_DEPTH = {
+    "pipelineDepth", 2,
+    {"Pipeline depth", "Number of morphology batches loaded or processed ahead [int]"}};
 // clang-format on
 
 constexpr auto LOADER_NAME = "circuit";
@@ -275,6 +282,7 @@ struct CircuitProperties
         setVariable(report, PROP_REPORT.name, "");
         setVariable(targets, PROP_TARGETS.name, "");
         setVariable(synchronousMode, PROP_SYNCHRONOUS_MODE.name, false);
+        setVariable(pipelineDepth, PROP_PIPELINE_DEPTH.name, 2);
 
         targetList = string_utils::split(targets, ',');
     }
@@ -285,6 +293,70 @@ struct CircuitProperties
     std::vector<std::string> targetList;
     std::string targets;
     bool synchronousMode = false;
+    int32_t pipelineDepth = 2;
+};
+
+/**
+ * Bounded queue between two stages of the morphology loading pipeline. Pushing
+ * blocks while the queue is full, popping blocks while it is empty. Closing the
+ * queue releases both ends: the consumer drains the remaining elements and the
+ * producer stops.
+ */
+template <typename T>
+class PipelineQueue
+{
+public:
+    explicit PipelineQueue(const size_t maxSize)
+        : _maxSize(std::max(maxSize, size_t(1)))
+    {
+    }
+
+    /** @return false if the queue has been closed */
+    bool push(T element)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [&] {
+            return _closed || _queue.size() < _maxSize;
+        });
+        if (_closed)
+            return false;
+        _queue.push(std::move(element));
+        _condition.notify_all();
+        return true;
+    }
+
+    /** @return false if the queue has been closed and is empty */
+    bool pop(T& element)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [&] { return _closed || !_queue.empty(); });
+        if (_queue.empty())
+            return false;
+        element = std::move(_queue.front());
+        _queue.pop();
+        _condition.notify_all();
+        return true;
+    }
+
+    void close()
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _closed = true;
+        _condition.notify_all();
+    }
+
+private:
+    std::queue<T> _queue;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    const size_t _maxSize;
+    bool _closed{false};
+};
+
+struct MorphologyBatch
+{
+    size_t index{0};
+    brain::neuron::Morphologies morphologies;
 };
 
 CompartmentReportPtr _openCompartmentReport(const brain::Simulation* simulation,
@@ -668,60 +740,130 @@ private:
         std::stringstream message;
         message << "Loading " << gids.size() << " morphologies...";
 
-        auto next = gids.begin();
-        size_t index = 0;
+        // The loading is a pipeline of three stages connected by bounded
+        // queues, so that reading morphologies, processing them into geometry
+        // and inserting the geometry into the model overlap:
+        // - the reader loads batches of LOAD_BATCH_SIZE morphologies,
+        // - the calling thread processes each batch in parallel,
+        // - the inserter merges the processed batches into the model in order.
+        const size_t depth = std::max(_properties.pipelineDepth, 1);
+        PipelineQueue<MorphologyBatch> loadedBatches(depth);
+        PipelineQueue<std::vector<ModelData>> processedBatches(depth);
+
+        auto reader = std::async(std::launch::async, [&] {
+            try
+            {
+                auto next = gids.begin();
+                size_t index = 0;
+                while (next != gids.end())
+                {
+                    brain::GIDSet batch;
+                    for (; batch.size() < LOAD_BATCH_SIZE && next != gids.end();
+                         ++next)
+                        batch.insert(*next);
+
+                    MorphologyBatch loaded;
+                    loaded.index = index;
+                    loaded.morphologies = circuit.loadMorphologies(
+                        batch, brain::Circuit::Coordinates::global);
+                    index += batch.size();
+                    if (!loadedBatches.push(std::move(loaded)))
+                        break;
+                }
+            }
+            catch (...)
+            {
+                loadedBatches.close();
+                throw;
+            }
+            loadedBatches.close();
+        });
+
+        auto inserter = std::async(std::launch::async, [&] {
+            try
+            {
+                std::vector<ModelData> batchData;
+                while (processedBatches.pop(batchData))
+                    ModelData::addTo(batchData, model);
+            }
+            catch (...)
+            {
+                processedBatches.close();
+                throw;
+            }
+        });
+
         std::atomic_size_t current{0};
         std::exception_ptr cancelException;
-
-        while (next != gids.end() && !cancelException)
+        try
         {
-            brain::GIDSet batch;
-            for (; batch.size() < LOAD_BATCH_SIZE && next != gids.end(); ++next)
-                batch.insert(*next);
-
-            const auto morphologies =
-                circuit.loadMorphologies(batch,
-                                         brain::Circuit::Coordinates::global);
-
-#pragma omp parallel for
-            for (uint64_t j = 0; j < morphologies.size(); ++j)
+            MorphologyBatch batch;
+            while (!cancelException && loadedBatches.pop(batch))
             {
-                if (cancelException)
-                    continue;
-                const auto morphologyIndex = index + j;
-                auto materialFunc = [&](const brain::neuron::SectionType type) {
-                    return _getMaterialId(_morphologyParams.colorScheme,
-                                          morphologyIndex, type,
-                                          perCellMaterialIds);
-                };
-
-                const auto& morphology = morphologies[j];
-
-                auto data = MorphologyLoader::processMorphology(
-                    *morphology, morphologyIndex, materialFunc, reportMapping,
-                    _morphologyParams);
-#pragma omp critical
-                data.addTo(model);
+                const auto& morphologies = batch.morphologies;
 
-                ++current;
-                // Throwing (happens if loading is cancelled) from inside a
-                // parallel-for is not allowed.
-                try
-                {
-                    callback.updateProgress(message.str(),
-                                            current / float(gids.size()));
-                }
-                catch (...)
+                // Each morphology is staged in its own slot and the batch is
+                // merged into the model at once, so that threads never wait on
+                // each other for inserting geometry.
+                std::vector<ModelData> batchData(morphologies.size());
+
+#pragma omp parallel for schedule(dynamic)
+                for (uint64_t j = 0; j < morphologies.size(); ++j)
                 {
+                    if (cancelException)
+                        continue;
+                    const auto morphologyIndex = batch.index + j;
+                    auto materialFunc =
+                        [&](const brain::neuron::SectionType type) {
+                            return _getMaterialId(_morphologyParams.colorScheme,
+                                                  morphologyIndex, type,
+                                                  perCellMaterialIds);
+                        };
+
+                    const auto& morphology = morphologies[j];
+
+                    batchData[j] = MorphologyLoader::processMorphology(
+                        *morphology, morphologyIndex, materialFunc,
+                        reportMapping, _morphologyParams);
+
+                    ++current;
+                    // Throwing (happens if loading is cancelled) from inside a
+                    // parallel-for is not allowed.
+                    try
+                    {
+                        callback.updateProgress(message.str(),
+                                                current / float(gids.size()));
+                    }
+                    catch (...)
+                    {
 #pragma omp critical
-                    cancelException = std::current_exception();
+                        cancelException = std::current_exception();
+                    }
                 }
+
+                if (!cancelException &&
+                    !processedBatches.push(std::move(batchData)))
+                    break;
             }
-            index += batch.size();
         }
+        catch (...)
+        {
+            loadedBatches.close();
+            processedBatches.close();
+            throw;
+        }
+
+        // Stop the reader if processing ended early, and let the inserter
+        // drain the processed batches.
+        loadedBatches.close();
+        processedBatches.close();
+        reader.wait();
+        inserter.wait();
 
         if (cancelException)
             std::rethrow_exception(cancelException);
+        reader.get();
+        inserter.get();
     }
 
 private:
@@ -801,6 +943,7 @@ PropertyMap CircuitLoader::getCLIProperties()
     pm.setProperty(PROP_REPORT);
     pm.setProperty(PROP_TARGETS);
     pm.setProperty(Property::makeReadOnly(PROP_SYNCHRONOUS_MODE));
+    pm.setProperty(PROP_PIPELINE_DEPTH);
     return pm;
 }
 }
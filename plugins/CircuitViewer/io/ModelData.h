@@ -27,6 +27,9 @@
 #include <brayns/common/types.h>
 #include <brayns/engine/Model.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace brayns
 {
 struct ModelData
@@ -45,6 +48,17 @@ struct ModelData
     {
     }
 
+    ModelData& operator=(ModelData&& other) noexcept
+    {
+        spheres = std::move(other.spheres);
+        cylinders = std::move(other.cylinders);
+        cones = std::move(other.cones);
+        sdfGeometries = std::move(other.sdfGeometries);
+        sdfNeighbours = std::move(other.sdfNeighbours);
+        sdfMaterials = std::move(other.sdfMaterials);
+        return *this;
+    }
+
     void addSphere(const size_t materialId, const Sphere& sphere)
     {
         spheres[materialId].push_back(sphere);
@@ -115,11 +129,110 @@ struct ModelData
         }
     }
 
+    /**
+     * Appends the geometry of all the given data to the model, in the order of
+     * the data. The storage of the model is resized once per material, using a
+     * prefix sum of the data sizes, and the geometry is then copied in
+     * parallel without locking.
+     */
+    static void addTo(const std::vector<ModelData>& datas, Model& model)
+    {
+        _addPrimitives(datas, &ModelData::spheres, model.getSpheres());
+        _addPrimitives(datas, &ModelData::cylinders, model.getCylinders());
+        _addPrimitives(datas, &ModelData::cones, model.getCones());
+        const bool hasSDFGeometries =
+            std::any_of(datas.begin(), datas.end(), [](const ModelData& data) {
+                return !data.sdfGeometries.empty();
+            });
+        if (hasSDFGeometries)
+            _addSDFGeometries(datas, model.getSDFGeometryData());
+    }
+
     SpheresMap spheres;
     CylindersMap cylinders;
     ConesMap cones;
     std::vector<SDFGeometry> sdfGeometries;
     std::vector<std::vector<size_t>> sdfNeighbours;
     std::vector<size_t> sdfMaterials;
+
+private:
+    template <typename T>
+    static void _addPrimitives(
+        const std::vector<ModelData>& datas,
+        std::map<size_t, std::vector<T>> ModelData::*member,
+        std::map<size_t, std::vector<T>>& primitives)
+    {
+        struct Copy
+        {
+            const std::vector<T>* source;
+            std::vector<T>* destination;
+            size_t offset;
+        };
+
+        std::vector<Copy> copies;
+        std::map<size_t, size_t> sizes;
+        for (const auto& data : datas)
+        {
+            for (const auto& source : data.*member)
+            {
+                if (source.second.empty())
+                    continue;
+                auto& destination = primitives[source.first];
+                auto& size =
+                    sizes.emplace(source.first, destination.size())
+                        .first->second;
+                copies.push_back({&source.second, &destination, size});
+                size += source.second.size();
+            }
+        }
+
+        for (const auto& size : sizes)
+            primitives[size.first].resize(size.second);
+
+#pragma omp parallel for schedule(dynamic)
+        for (uint64_t i = 0; i < copies.size(); ++i)
+        {
+            const auto& copy = copies[i];
+            std::copy(copy.source->begin(), copy.source->end(),
+                      copy.destination->begin() + copy.offset);
+        }
+    }
+
+    static void _addSDFGeometries(const std::vector<ModelData>& datas,
+                                  SDFGeometryData& sdf)
+    {
+        // Global index of the first geometry of each data
+        std::vector<size_t> offsets(datas.size() + 1,
+                                    sdf.geometries.size());
+        for (size_t i = 0; i < datas.size(); ++i)
+        {
+            offsets[i + 1] = offsets[i] + datas[i].sdfGeometries.size();
+            for (size_t j = 0; j < datas[i].sdfMaterials.size(); ++j)
+                sdf.geometryIndices[datas[i].sdfMaterials[j]].push_back(
+                    offsets[i] + j);
+        }
+
+        sdf.geometries.resize(offsets.back());
+        sdf.neighbours.resize(offsets.back());
+
+#pragma omp parallel for schedule(dynamic)
+        for (uint64_t i = 0; i < datas.size(); ++i)
+        {
+            const auto& data = datas[i];
+            const auto offset = offsets[i];
+            std::copy(data.sdfGeometries.begin(), data.sdfGeometries.end(),
+                      sdf.geometries.begin() + offset);
+
+            // Write the neighbours using global indices
+            for (size_t j = 0; j < data.sdfNeighbours.size(); ++j)
+            {
+                auto& neighbours = sdf.neighbours[offset + j];
+                neighbours.clear();
+                neighbours.reserve(data.sdfNeighbours[j].size());
+                for (const auto localIndex : data.sdfNeighbours[j])
+                    neighbours.push_back(offset + localIndex);
+            }
+        }
+    }
 };
 }
@@ -54,6 +54,21 @@ SimulationHandler::SimulationHandler(const CompartmentReportPtr& report,
     BRAYNS_INFO << "Number of frames : " << _nbFrames << std::endl;
     BRAYNS_INFO << "-----------------------------------------------------------"
                 << std::endl;
+
+    _setFrameLoader([report, startTime = _startTime, endTime = _endTime,
+                     dt = _dt](const uint32_t frame, floats& buffer) {
+        auto timestamp = startTime + frame * dt;
+        timestamp = std::max(startTime, timestamp);
+        timestamp = std::min(endTime, timestamp);
+
+        // brain only loads into its own buffer, which is copied to keep the
+        // preallocated buffer of the prefetch ring
+        const auto loadedFrame = report->load(timestamp).get();
+        if (!loadedFrame.data)
+            throw std::runtime_error("No data for timestamp " +
+                                     std::to_string(timestamp));
+        buffer.assign(loadedFrame.data->begin(), loadedFrame.data->end());
+    });
 }
 
 SimulationHandler::SimulationHandler(const SimulationHandler& rhs)
@@ -97,69 +112,11 @@ bool SimulationHandler::isReady() const
     return _ready;
 }
 
-void SimulationHandler::waitReady() const
-{
-    if (_currentFrameFuture.valid())
-        _currentFrameFuture.wait();
-}
-
 void* SimulationHandler::getFrameData(uint32_t frame)
 {
-    frame = _getBoundedFrame(frame);
-
-    if (!_currentFrameFuture.valid() && _currentFrame != frame)
-        _triggerLoading(frame);
-
-    if (!_makeFrameReady(frame))
-        return nullptr;
-
-    return _frameData.data();
-}
-
-void SimulationHandler::_triggerLoading(const uint32_t frame)
-{
-    auto timestamp = _startTime + frame * _dt;
-    timestamp = std::max(_startTime, timestamp);
-    timestamp = std::min(_endTime, timestamp);
-
-    waitReady();
-
-    _ready = false;
-    _currentFrameFuture = _compartmentReport->load(timestamp);
-}
-
-bool SimulationHandler::_isFrameLoaded() const
-{
-    if (!_currentFrameFuture.valid())
-        return false;
-
-    if (_synchronousMode)
-    {
-        waitReady();
-        return true;
-    }
-
-    return _currentFrameFuture.wait_for(std::chrono::milliseconds(0)) ==
-           std::future_status::ready;
-}
-
-bool SimulationHandler::_makeFrameReady(const uint32_t frame)
-{
-    if (_isFrameLoaded())
-    {
-        try
-        {
-            _frameData = std::move(*_currentFrameFuture.get().data);
-        }
-        catch (const std::exception& e)
-        {
-            BRAYNS_ERROR << "Error loading simulation frame " << frame << ": "
-                         << e.what() << std::endl;
-            return false;
-        }
-        _currentFrame = frame;
-        _ready = true;
-    }
-    return true;
+    auto data =
+        _getPrefetchedFrameData(_getBoundedFrame(frame), _synchronousMode);
+    _ready = data != nullptr;
+    return data;
 }
 }
@@ -56,18 +56,11 @@ public:
     CompartmentReportPtr getCompartmentReport() { return _compartmentReport; }
     bool isReady() const final;
 
-    void waitReady() const final;
-
 private:
-    void _triggerLoading(uint32_t frame);
-    bool _isFrameLoaded() const;
-    bool _makeFrameReady(uint32_t frame);
-
     CompartmentReportPtr _compartmentReport;
     bool _synchronousMode{false};
     double _startTime;
     double _endTime;
-    std::future<brion::Frame> _currentFrameFuture;
     bool _ready{false};
     std::vector<MaterialPtr> _materials;
 };
@@ -21,9 +21,13 @@
 #include "SimulationMaterial.h"
 #include "SimulationMaterial_ispc.h"
 
+#include <engines/ospray/ispc/geometry/CompactCones.h>
+#include <engines/ospray/ispc/geometry/CompactCylinders.h>
+#include <engines/ospray/ispc/geometry/CompactSpheres.h>
 #include <engines/ospray/ispc/geometry/Cones.h>
 #include <engines/ospray/ispc/geometry/SDFGeometries.h>
 
+#include <brayns/common/geometry/CompactGeometry.h>
 #include <brayns/common/geometry/Cone.h>
 #include <brayns/common/geometry/Cylinder.h>
 #include <brayns/common/geometry/SDFGeometry.h>
@@ -51,8 +55,25 @@ int SimulationMaterial_getBytesPerPrimitive(const void* geometry)
         return sizeof(brayns::Cone);
     else if (dynamic_cast<const ospray::SDFGeometries*>(base))
         return sizeof(brayns::SDFGeometry);
+    else if (dynamic_cast<const ospray::CompactSpheres*>(base))
+        return sizeof(brayns::CompactSphere);
+    else if (dynamic_cast<const ospray::CompactCylinders*>(base))
+        return sizeof(brayns::CompactCylinder);
+    else if (dynamic_cast<const ospray::CompactCones*>(base))
+        return sizeof(brayns::CompactCone);
     return 0;
 }
+
+int SimulationMaterial_getBytesPerUserData(const void* geometry)
+{
+    const ospray::Geometry* base =
+        static_cast<const ospray::Geometry*>(geometry);
+    if (dynamic_cast<const ospray::CompactSpheres*>(base) ||
+        dynamic_cast<const ospray::CompactCylinders*>(base) ||
+        dynamic_cast<const ospray::CompactCones*>(base))
+        return sizeof(uint32_t);
+    return sizeof(uint64_t);
+}
 }
 
 namespace brayns
@@ -0,0 +1,104 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/Timer.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+
+#include <BBP/TestDatasets.h>
+#include <brain/circuit.h>
+
+#include <iostream>
+
+#ifdef BRAYNS_USE_OPENMP
+#include <omp.h>
+#endif
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "tests/doctest.h"
+
+namespace
+{
+const std::string TARGET = "allmini50";
+}
+
+TEST_CASE("circuit_loading_benchmark")
+{
+    const char* argv[] = {"circuit_loading", "--plugin",
+                          "braynsCircuitViewer --targets allmini50"};
+    const int argc = sizeof(argv) / sizeof(char*);
+
+    brayns::Brayns brayns(argc, argv);
+    auto& scene = brayns.getEngine().getScene();
+
+    const brain::Circuit circuit{brion::URI(BBP_TEST_BLUECONFIG3)};
+    const auto nbCells = circuit.getGIDs(TARGET).size();
+    REQUIRE(nbCells > 0);
+
+#ifdef BRAYNS_USE_OPENMP
+    const int maxThreads = omp_get_max_threads();
+#else
+    const int maxThreads = 1;
+#endif
+
+    size_t reference = 0;
+    for (int nbThreads = 1;; nbThreads = std::min(nbThreads * 2, maxThreads))
+    {
+#ifdef BRAYNS_USE_OPENMP
+        omp_set_num_threads(nbThreads);
+#endif
+        brayns::Timer timer;
+        timer.start();
+        auto modelDescriptor =
+            scene.loadModel(BBP_TEST_BLUECONFIG3,
+                            brayns::ModelParams("circuit",
+                                                BBP_TEST_BLUECONFIG3),
+                            {});
+        timer.stop();
+
+        const auto& model = modelDescriptor->getModel();
+        size_t nbPrimitives = 0;
+        for (const auto& spheres : model.getSpheres())
+            nbPrimitives += spheres.second.size();
+        for (const auto& cylinders : model.getCylinders())
+            nbPrimitives += cylinders.second.size();
+        for (const auto& cones : model.getCones())
+            nbPrimitives += cones.second.size();
+
+        // All thread counts must produce the same geometry
+        if (nbThreads == 1)
+            reference = nbPrimitives;
+        CHECK_EQ(nbPrimitives, reference);
+
+        std::cout << "[PERF] Loaded " << nbCells << " cells with " << nbThreads
+                  << " threads in " << timer.milliseconds()
+                  << " milliseconds: " << nbCells / timer.seconds()
+                  << " cells/second" << std::endl;
+
+        scene.removeModel(modelDescriptor->getModelID());
+        if (nbThreads == maxThreads)
+            break;
+    }
+
+#ifdef BRAYNS_USE_OPENMP
+    omp_set_num_threads(maxThreads);
+#endif
+}
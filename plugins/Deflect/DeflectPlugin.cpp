@@ -313,8 +313,8 @@ private:
         for (size_t i = 0; i < frameBuffers.size(); ++i)
         {
             auto frameBuffer = frameBuffers[i];
-            frameBuffer->map();
-            if (frameBuffer->getColorBuffer())
+            const auto snapshot = frameBuffer->getSnapshot();
+            if (snapshot->colorBuffer)
             {
                 const deflect::View view =
                     utils::getView(frameBuffer->getName());
@@ -324,25 +324,22 @@ private:
                 if (i <= _lastImages.size())
                     _lastImages.push_back({});
                 auto& image = _lastImages[i];
-                _copyToImage(image, *frameBuffer);
+                _copyToImage(image, *snapshot);
                 _futures.push_back(_sendImage(image, view, channel));
             }
-            frameBuffer->unmap();
         }
         _futures.push_back(
             static_cast<deflect::Stream&>(*_stream).finishFrame());
     }
 
-    void _copyToImage(Image& image, FrameBuffer& frameBuffer)
+    // The image is sent asynchronously, after the snapshot is released
+    void _copyToImage(Image& image, const FrameBufferSnapshot& snapshot)
     {
-        const auto& size = frameBuffer.getSize();
-        const size_t bufferSize = size.x * size.y * frameBuffer.getColorDepth();
-        const auto data = frameBuffer.getColorBuffer();
-
+        const size_t bufferSize = snapshot.getColorBufferSize();
         image.data.resize(bufferSize);
-        memcpy(image.data.data(), data, bufferSize);
-        image.size = size;
-        image.format = frameBuffer.getFrameBufferFormat();
+        memcpy(image.data.data(), snapshot.colorBuffer, bufferSize);
+        image.size = snapshot.size;
+        image.format = snapshot.format;
     }
 
     deflect::Stream::Future _sendImage(const Image& image,
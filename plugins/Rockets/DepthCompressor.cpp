@@ -0,0 +1,213 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "DepthCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace brayns
+{
+namespace
+{
+const float QUANTIZED_RANGE = DepthCompressor::BACKGROUND - 1;
+
+inline uint16_t predict(const uint16_t* row, const uint16_t* up,
+                        const uint32_t x)
+{
+    const int a = x > 0 ? row[x - 1] : (up ? up[x] : 0);
+    const int b = up ? up[x] : a;
+    const int c = x > 0 && up ? up[x - 1] : b;
+
+    // median edge detector of LOCO-I
+    if (c >= std::max(a, b))
+        return std::min(a, b);
+    if (c <= std::min(a, b))
+        return std::max(a, b);
+    return a + b - c;
+}
+
+inline void writeVarint(uint32_t value, uint8_t*& out)
+{
+    while (value >= 0x80)
+    {
+        *out++ = uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    *out++ = uint8_t(value);
+}
+
+inline bool readVarint(const uint8_t*& data, const uint8_t* end,
+                       uint32_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; data < end && shift < 32; shift += 7)
+    {
+        const uint8_t byte = *data++;
+        value |= uint32_t(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+}
+
+constexpr uint16_t DepthCompressor::BACKGROUND;
+
+const DepthCompressor::Depth& DepthCompressor::compress(
+    const float* depth, const uint32_t width, const uint32_t height,
+    const uint32_t downscale)
+{
+    const uint32_t factor = std::max(1u, downscale);
+    const uint32_t outWidth = std::max(1u, width / factor);
+    const uint32_t outHeight = std::max(1u, height / factor);
+
+    // Keep the closest depth of each block
+    if (factor > 1)
+    {
+        _depth.assign(outWidth * outHeight,
+                      std::numeric_limits<float>::infinity());
+        for (uint32_t j = 0; j < std::min(outHeight * factor, height); ++j)
+        {
+            const float* row = depth + size_t(j) * width;
+            float* out = &_depth[j / factor * outWidth];
+            for (uint32_t i = 0; i < outWidth * factor && i < width; ++i)
+                out[i / factor] = std::min(out[i / factor], row[i]);
+        }
+        depth = _depth.data();
+    }
+    // Rows are bottom-up in the frame buffer
+    const auto getRow = [&](const uint32_t y) {
+        return depth + size_t(outHeight - 1 - y) * outWidth;
+    };
+
+    float near = std::numeric_limits<float>::max();
+    float far = std::numeric_limits<float>::lowest();
+    for (uint32_t y = 0; y < outHeight; ++y)
+    {
+        const float* row = getRow(y);
+        for (uint32_t x = 0; x < outWidth; ++x)
+        {
+            if (std::isfinite(row[x]))
+            {
+                near = std::min(near, row[x]);
+                far = std::max(far, row[x]);
+            }
+        }
+    }
+    if (near > far)
+        near = far = 0.f;
+
+    _result.width = outWidth;
+    _result.height = outHeight;
+    _result.near = near;
+    _result.far = far;
+
+    // worst case of 3 bytes per value
+    _values.resize(outWidth * outHeight);
+    _result.data.resize(_values.size() * 3);
+    uint8_t* out = _result.data.data();
+
+    const float scale = far > near ? QUANTIZED_RANGE / (far - near) : 0.f;
+    uint32_t zeros = 0;
+    for (uint32_t y = 0; y < outHeight; ++y)
+    {
+        const float* source = getRow(y);
+        uint16_t* row = &_values[y * outWidth];
+        for (uint32_t x = 0; x < outWidth; ++x)
+        {
+            const float value = source[x];
+            row[x] = std::isfinite(value)
+                         ? uint16_t((value - near) * scale + 0.5f)
+                         : BACKGROUND;
+        }
+
+        const uint16_t* up = y > 0 ? row - outWidth : nullptr;
+        for (uint32_t x = 0; x < outWidth; ++x)
+        {
+            const int16_t residual = int16_t(row[x] - predict(row, up, x));
+            const uint16_t zigzag =
+                residual >= 0 ? 2 * residual : -2 * residual - 1;
+            if (zigzag == 0)
+            {
+                ++zeros;
+                continue;
+            }
+            if (zeros > 0)
+            {
+                *out++ = 0;
+                writeVarint(zeros - 1, out);
+                zeros = 0;
+            }
+            writeVarint(zigzag, out);
+        }
+    }
+    if (zeros > 0)
+    {
+        *out++ = 0;
+        writeVarint(zeros - 1, out);
+    }
+    _result.data.resize(out - _result.data.data());
+    return _result;
+}
+
+bool DepthCompressor::decompress(const uint8_t* data, const size_t size,
+                                 const uint32_t width, const uint32_t height,
+                                 std::vector<uint16_t>& values)
+{
+    values.resize(size_t(width) * height);
+    const uint8_t* end = data + size;
+    uint32_t zeros = 0;
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        uint16_t* row = &values[y * width];
+        const uint16_t* up = y > 0 ? row - width : nullptr;
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            uint32_t zigzag = 0;
+            if (zeros > 0)
+                --zeros;
+            else
+            {
+                if (data == end)
+                    return false;
+                if (*data == 0)
+                {
+                    ++data;
+                    if (!readVarint(data, end, zeros))
+                        return false;
+                }
+                else if (!readVarint(data, end, zigzag))
+                    return false;
+            }
+            const int residual = (zigzag >> 1) ^ -int(zigzag & 1);
+            row[x] = uint16_t(predict(row, up, x) + residual);
+        }
+    }
+    return zeros == 0 && data == end;
+}
+
+float DepthCompressor::toDepth(const uint16_t value, const float near,
+                               const float far)
+{
+    if (value == BACKGROUND)
+        return std::numeric_limits<float>::infinity();
+    return near + value * (far - near) / QUANTIZED_RANGE;
+}
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace brayns
+{
+/**
+ * Lossy compression of depth buffers for streaming.
+ *
+ * The depth is quantized to 16 bits between the closest and farthest finite
+ * depth of the frame, with BACKGROUND for infinite depth. Each value is
+ * predicted from its left, upper and upper-left neighbours like in LOCO-I, and
+ * the residuals are written as varints with runs of zero residuals collapsed
+ * into a zero byte followed by the varint of the run length minus one.
+ */
+class DepthCompressor
+{
+public:
+    static constexpr uint16_t BACKGROUND = 0xFFFF;
+
+    struct Depth
+    {
+        uint32_t width{0};
+        uint32_t height{0};
+        float near{0.f}; // depth of quantized value 0
+        float far{0.f};  // depth of quantized value BACKGROUND - 1
+        std::vector<uint8_t> data;
+    };
+
+    /**
+     * Compress the given depth buffer.
+     *
+     * @param depth width x height depth values with rows stored bottom-up,
+     *              the compressed rows are top-down like JPEG
+     * @param downscale factor to divide the resolution by, keeping the closest
+     *                  depth of each block
+     * @return the compressed depth, valid until the next call
+     */
+    const Depth& compress(const float* depth, uint32_t width, uint32_t height,
+                          uint32_t downscale = 1);
+
+    /**
+     * Decompress the quantized values of a compressed depth buffer.
+     *
+     * @return false if the data does not decode to width x height values
+     */
+    static bool decompress(const uint8_t* data, size_t size, uint32_t width,
+                           uint32_t height, std::vector<uint16_t>& values);
+
+    /** @return the depth of a quantized value, infinity for BACKGROUND */
+    static float toDepth(uint16_t value, float near, float far);
+
+private:
+    Depth _result;
+    std::vector<float> _depth;
+    std::vector<uint16_t> _values;
+};
+}
@@ -25,8 +25,108 @@
 #include <brayns/engine/FrameBuffer.h>
 #include <brayns/parameters/ApplicationParameters.h>
 
+#include <async++.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+const int32_t COLOR_COMPONENTS = 4;
+const int32_t JPEG_SUBSAMPLING = TJSAMP_444;
+const int32_t JPEG_FLAGS = TJFLAG_BOTTOMUP;
+
+const uint32_t MCU_SIZE = 8; // for TJSAMP_444
+const uint32_t MIN_STRIP_HEIGHT = 64;
+const uint32_t MAX_RESTART_INTERVAL = 0xFFFF;
+// Strip layouts kept for delta encoding, i.e. quality and downscale settings
+// streamed at the same time; the least recently used one is dropped beyond
+const size_t MAX_STRIPS_LAYOUTS = 8;
+
+const uint8_t MARKER_SOF0 = 0xC0;
+const uint8_t MARKER_SOF1 = 0xC1;
+const uint8_t MARKER_RST0 = 0xD0;
+const uint8_t MARKER_EOI = 0xD9;
+const uint8_t MARKER_SOS = 0xDA;
+const uint8_t MARKER_DRI = 0xDD;
+const size_t MARKER_SIZE = 2;
+const size_t DRI_SIZE = 6;
+
+// Header of createJPEGWithDepth()
+struct ColorDepthHeader
+{
+    char magic[4];
+    uint32_t jpegSize;
+    uint32_t depthWidth;
+    uint32_t depthHeight;
+    float near;
+    float far;
+    uint32_t depthSize;
+};
+static_assert(sizeof(ColorDepthHeader) == 28, "Unexpected padding");
+
+uint32_t getStripHeight(const uint32_t width, const uint32_t height,
+                        const uint32_t maxStrips)
+{
+    const uint32_t nbStrips = std::min(maxStrips, height / MIN_STRIP_HEIGHT);
+    if (nbStrips <= 1)
+        return height;
+
+    // A strip is a restart interval, which is made of whole MCU rows and
+    // limited to 16 bits
+    const uint32_t mcusPerRow = (width + MCU_SIZE - 1) / MCU_SIZE;
+    const uint32_t maxMcuRows = MAX_RESTART_INTERVAL / mcusPerRow;
+    const uint32_t stripHeight = (height + nbStrips - 1) / nbStrips;
+    const uint32_t mcuRows = (stripHeight + MCU_SIZE - 1) / MCU_SIZE;
+    if (maxMcuRows == 0)
+        return height;
+    return std::min(mcuRows, maxMcuRows) * MCU_SIZE;
+}
+
+bool parseJpeg(const uint8_t* data, const size_t size, size_t& heightOffset,
+               size_t& sosOffset, size_t& scanBegin)
+{
+    if (size < 2 * MARKER_SIZE || data[size - 2] != 0xFF ||
+        data[size - 1] != MARKER_EOI)
+    {
+        return false;
+    }
+
+    heightOffset = 0;
+    size_t pos = MARKER_SIZE; // SOI
+    while (pos + 2 * MARKER_SIZE <= size && data[pos] == 0xFF)
+    {
+        const uint8_t marker = data[pos + 1];
+        const size_t length = (data[pos + 2] << 8) | data[pos + 3];
+        switch (marker)
+        {
+        case MARKER_SOF0:
+        case MARKER_SOF1:
+            // length, precision
+            heightOffset = pos + MARKER_SIZE + 3;
+            break;
+        case MARKER_DRI:
+            return false;
+        case MARKER_SOS:
+            sosOffset = pos;
+            scanBegin = pos + MARKER_SIZE + length;
+            return heightOffset > 0 && scanBegin <= size - MARKER_SIZE;
+        }
+        pos += MARKER_SIZE + length;
+    }
+    return false;
+}
+}
+
 namespace brayns
 {
+ImageGenerator::Strip::~Strip()
+{
+    if (compressor)
+        tjDestroy(compressor);
+}
+
 ImageGenerator::~ImageGenerator()
 {
     if (_compressor)
@@ -68,18 +168,15 @@ ImageGenerator::ImageBase64 ImageGenerator::createImage(
 }
 
 ImageGenerator::ImageJPEG ImageGenerator::createJPEG(
-    FrameBuffer& frameBuffer BRAYNS_UNUSED, const uint8_t quality BRAYNS_UNUSED)
+    FrameBuffer& frameBuffer BRAYNS_UNUSED, const uint8_t quality BRAYNS_UNUSED,
+    const uint32_t downscale)
 {
-    frameBuffer.map();
-    const auto colorBuffer = frameBuffer.getColorBuffer();
-    if (!colorBuffer)
-    {
-        frameBuffer.unmap();
+    const auto snapshot = frameBuffer.getSnapshot();
+    if (!snapshot->colorBuffer)
         return ImageJPEG();
-    }
 
     int32_t pixelFormat = TJPF_RGBX;
-    switch (frameBuffer.getFrameBufferFormat())
+    switch (snapshot->format)
     {
     case FrameBufferFormat::bgra_i8:
         pixelFormat = TJPF_BGRX;
@@ -89,31 +186,126 @@ ImageGenerator::ImageJPEG ImageGenerator::createJPEG(
         pixelFormat = TJPF_RGBX;
     }
 
-    const auto& frameSize = frameBuffer.getSize();
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint32_t width = snapshot->size.x;
+    uint32_t height = snapshot->size.y;
+    const uint8_t* pixels = snapshot->colorBuffer;
+    if (downscale > 1)
+    {
+        // Box filter over blocks of downscale x downscale pixels
+        const auto scaledSize = getImageSize(snapshot->size, downscale);
+        const uint32_t scaledWidth = scaledSize.x;
+        const uint32_t scaledHeight = scaledSize.y;
+        _downscaled.resize(scaledWidth * scaledHeight * COLOR_COMPONENTS);
+        for (uint32_t y = 0; y < scaledHeight; ++y)
+        {
+            const uint32_t y0 = y * downscale;
+            const uint32_t y1 = std::min(y0 + downscale, height);
+            for (uint32_t x = 0; x < scaledWidth; ++x)
+            {
+                const uint32_t x0 = x * downscale;
+                const uint32_t x1 = std::min(x0 + downscale, width);
+                uint32_t sum[COLOR_COMPONENTS] = {0, 0, 0, 0};
+                for (uint32_t j = y0; j < y1; ++j)
+                {
+                    const uint8_t* src =
+                        pixels + (j * width + x0) * COLOR_COMPONENTS;
+                    for (uint32_t i = x0; i < x1; ++i)
+                        for (int32_t c = 0; c < COLOR_COMPONENTS; ++c)
+                            sum[c] += *src++;
+                }
+                const uint32_t count = (y1 - y0) * (x1 - x0);
+                uint8_t* dst = &_downscaled[(y * scaledWidth + x) *
+                                            COLOR_COMPONENTS];
+                for (int32_t c = 0; c < COLOR_COMPONENTS; ++c)
+                    dst[c] = sum[c] / count;
+            }
+        }
+        width = scaledWidth;
+        height = scaledHeight;
+        pixels = _downscaled.data();
+    }
+
     ImageJPEG image;
-    image.data = _encodeJpeg(frameSize.x, frameSize.y, colorBuffer, pixelFormat,
-                             quality, image.size);
-    frameBuffer.unmap();
+    image.data = _encodeJpeg(width, height, pixels, pixelFormat, quality,
+                             image.size);
     return image;
 }
 
+std::vector<uint8_t> ImageGenerator::createJPEGWithDepth(
+    FrameBuffer& frameBuffer, const uint8_t quality, const uint32_t downscale)
+{
+    const auto snapshot = frameBuffer.getSnapshot();
+    const auto image = createJPEG(frameBuffer, quality, downscale);
+    if (image.size == 0)
+        return {};
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    DepthCompressor::Depth noDepth;
+    const auto& depth =
+        snapshot->depthBuffer
+            ? _depthCompressor.compress(snapshot->depthBuffer,
+                                        snapshot->size.x, snapshot->size.y,
+                                        downscale)
+            : noDepth;
+
+    const ColorDepthHeader header{{'B', 'R', 'C', 'D'},
+                                  uint32_t(image.size),
+                                  depth.width,
+                                  depth.height,
+                                  depth.near,
+                                  depth.far,
+                                  uint32_t(depth.data.size())};
+    std::vector<uint8_t> buffer(sizeof(header) + image.size +
+                                depth.data.size());
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    auto out = std::copy(image.data.get(), image.data.get() + image.size,
+                         buffer.begin() + sizeof(header));
+    std::copy(depth.data.begin(), depth.data.end(), out);
+    return buffer;
+}
+
+Vector2ui ImageGenerator::getImageSize(const Vector2ui& frameSize,
+                                       const uint32_t downscale)
+{
+    if (downscale <= 1)
+        return frameSize;
+    return {std::max(1u, frameSize.x / downscale),
+            std::max(1u, frameSize.y / downscale)};
+}
+
+void ImageGenerator::setDeltaEncoding(const bool enabled)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _deltaEncoding = enabled;
+    if (!enabled)
+        for (auto& layout : _strips)
+            for (auto& strip : layout.second.strips)
+                std::vector<uint8_t>().swap(strip->pixels);
+}
+
 ImageGenerator::ImageJPEG::JpegData ImageGenerator::_encodeJpeg(
     const uint32_t width, const uint32_t height, const uint8_t* rawData,
     const int32_t pixelFormat, const uint8_t quality, unsigned long& dataSize)
 {
-    uint8_t* tjSrcBuffer = const_cast<uint8_t*>(rawData);
-    const int32_t color_components = 4; // Color Depth
-    const int32_t tjPitch = width * color_components;
-    const int32_t tjPixelFormat = pixelFormat;
+    // Delta encoding wants small strips regardless of the number of cores
+    const uint32_t maxStrips =
+        _deltaEncoding ? height
+                       : std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t stripHeight = getStripHeight(width, height, maxStrips);
+    if (stripHeight < height)
+    {
+        auto data = _encodeJpegStrips(width, height, stripHeight, rawData,
+                                      pixelFormat, quality, dataSize);
+        if (data)
+            return data;
+    }
 
     uint8_t* tjJpegBuf = 0;
-    const int32_t tjJpegSubsamp = TJSAMP_444;
-    const int32_t tjFlags = TJXOP_ROT180;
-
     const int32_t success =
-        tjCompress2(_compressor, tjSrcBuffer, width, tjPitch, height,
-                    tjPixelFormat, &tjJpegBuf, &dataSize, tjJpegSubsamp,
-                    quality, tjFlags);
+        tjCompress2(_compressor, const_cast<uint8_t*>(rawData), width,
+                    width * COLOR_COMPONENTS, height, pixelFormat, &tjJpegBuf,
+                    &dataSize, JPEG_SUBSAMPLING, quality, JPEG_FLAGS);
 
     if (success != 0)
     {
@@ -122,4 +314,120 @@ ImageGenerator::ImageJPEG::JpegData ImageGenerator::_encodeJpeg(
     }
     return ImageJPEG::JpegData{tjJpegBuf};
 }
+
+ImageGenerator::ImageJPEG::JpegData ImageGenerator::_encodeJpegStrips(
+    const uint32_t width, const uint32_t height, const uint32_t stripHeight,
+    const uint8_t* rawData, const int32_t pixelFormat, const uint8_t quality,
+    unsigned long& dataSize)
+{
+    const auto layout =
+        std::make_tuple(width, height, stripHeight, pixelFormat, quality);
+    auto& layoutStrips = _strips[layout];
+    layoutStrips.lastUse = ++_stripsUses;
+    if (_strips.size() > MAX_STRIPS_LAYOUTS)
+    {
+        const auto oldest =
+            std::min_element(_strips.begin(), _strips.end(),
+                             [](const auto& a, const auto& b) {
+                                 return a.second.lastUse < b.second.lastUse;
+                             });
+        _strips.erase(oldest);
+    }
+
+    auto& strips = layoutStrips.strips;
+    const uint32_t nbStrips = (height + stripHeight - 1) / stripHeight;
+    while (strips.size() < nbStrips)
+        strips.emplace_back(new Strip);
+
+    const size_t pitch = width * COLOR_COMPONENTS;
+    async::parallel_for(async::irange(0u, nbStrips), [&](const uint32_t i) {
+        auto& strip = *strips[i];
+
+        // Rows are bottom-up, so the top strip is at the end of the buffer
+        const uint32_t top = i * stripHeight;
+        const uint32_t rows = std::min(stripHeight, height - top);
+        const uint8_t* pixels = rawData + (height - top - rows) * pitch;
+        const size_t size = rows * pitch;
+        if (_deltaEncoding)
+        {
+            if (strip.jpeg.size > 0 && strip.pixels.size() == size &&
+                std::memcmp(strip.pixels.data(), pixels, size) == 0)
+            {
+                return;
+            }
+            strip.pixels.assign(pixels, pixels + size);
+        }
+
+        uint8_t* buffer = nullptr;
+        unsigned long bufferSize = 0;
+        if (tjCompress2(strip.compressor, const_cast<uint8_t*>(pixels), width,
+                        pitch, rows, pixelFormat, &buffer, &bufferSize,
+                        JPEG_SUBSAMPLING, quality, JPEG_FLAGS) != 0 ||
+            !parseJpeg(buffer, bufferSize, strip.heightOffset, strip.sosOffset,
+                       strip.scanBegin))
+        {
+            tjFree(buffer);
+            buffer = nullptr;
+            bufferSize = 0;
+            strip.pixels.clear();
+        }
+        strip.jpeg.data.reset(buffer);
+        strip.jpeg.size = bufferSize;
+    });
+
+    // Strips can only be joined if they share the same tables, i.e. they have
+    // the same headers apart from the image height
+    const auto& first = *strips[0];
+    const uint8_t* header = first.jpeg.data.get();
+    size_t size = first.scanBegin + DRI_SIZE + MARKER_SIZE;
+    for (const auto& strip : strips)
+    {
+        const uint8_t* data = strip->jpeg.data.get();
+        const size_t tail = strip->heightOffset + 2;
+        if (strip->jpeg.size == 0 || strip->scanBegin != first.scanBegin ||
+            strip->heightOffset != first.heightOffset ||
+            std::memcmp(data, header, strip->heightOffset) != 0 ||
+            std::memcmp(data + tail, header + tail,
+                        strip->scanBegin - tail) != 0)
+        {
+            return ImageJPEG::JpegData();
+        }
+        size += strip->jpeg.size - MARKER_SIZE - strip->scanBegin;
+    }
+    size += (nbStrips - 1) * MARKER_SIZE;
+
+    uint8_t* output = tjAlloc(static_cast<int>(size));
+    if (!output)
+        return ImageJPEG::JpegData();
+
+    uint8_t* out = std::copy(header, header + first.sosOffset, output);
+    output[first.heightOffset] = height >> 8;
+    output[first.heightOffset + 1] = height & 0xFF;
+
+    const uint32_t interval =
+        (width + MCU_SIZE - 1) / MCU_SIZE * (stripHeight / MCU_SIZE);
+    const uint8_t dri[DRI_SIZE] = {0xFF, MARKER_DRI, 0, 4,
+                                   uint8_t(interval >> 8),
+                                   uint8_t(interval & 0xFF)};
+    out = std::copy(dri, dri + DRI_SIZE, out);
+    out = std::copy(header + first.sosOffset, header + first.scanBegin, out);
+
+    for (uint32_t i = 0; i < nbStrips; ++i)
+    {
+        if (i > 0)
+        {
+            *out++ = 0xFF;
+            *out++ = MARKER_RST0 + (i - 1) % 8;
+        }
+        const auto& strip = *strips[i];
+        const uint8_t* data = strip.jpeg.data.get();
+        out = std::copy(data + strip.scanBegin,
+                        data + strip.jpeg.size - MARKER_SIZE, out);
+    }
+    *out++ = 0xFF;
+    *out++ = MARKER_EOI;
+
+    dataSize = size;
+    return ImageJPEG::JpegData{output};
+}
 } // namespace brayns
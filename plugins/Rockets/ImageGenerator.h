@@ -22,8 +22,14 @@
 
 #include <brayns/common/types.h>
 
+#include "DepthCompressor.h"
+
 #include <turbojpeg.h>
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
 namespace brayns
 {
 /**
@@ -70,18 +76,94 @@ public:
 
     /**
      * Create a JPEG image from the given framebuffer in a specified quality.
+     * Large images are encoded as horizontal strips in parallel, which are
+     * joined into one baseline JPEG using restart markers.
      *
      * @param frameBuffer the framebuffer to use for getting the pixels
      * @param quality 1..100 JPEG quality
+     * @param downscale factor to divide the resolution of the image by
      * @return JPEG image with a size > 0 if valid, size == 0 on error.
      */
-    ImageJPEG createJPEG(FrameBuffer& frameBuffer, uint8_t quality);
+    ImageJPEG createJPEG(FrameBuffer& frameBuffer, uint8_t quality,
+                         uint32_t downscale = 1);
+
+    /**
+     * Create a JPEG image and the compressed depth of the given framebuffer,
+     * packed in one buffer for compositing on the client. The buffer starts
+     * with a header of 4 byte fields in host byte order, i.e. little endian
+     * on x86:
+     * - the magic "BRCD"
+     * - the size of the JPEG image in bytes
+     * - the width and height of the depth
+     * - the near and far depth as floats, see DepthCompressor
+     * - the size of the compressed depth in bytes
+     * followed by the JPEG image and the compressed depth. The depth has a
+     * size of 0 if the framebuffer has no depth.
+     *
+     * @param frameBuffer the framebuffer to use for getting the pixels
+     * @param quality 1..100 JPEG quality
+     * @param downscale factor to divide the resolution of the image by
+     * @return the packed image, empty on error
+     */
+    std::vector<uint8_t> createJPEGWithDepth(FrameBuffer& frameBuffer,
+                                             uint8_t quality,
+                                             uint32_t downscale = 1);
+
+    /**
+     * @param frameSize the size of the framebuffer
+     * @param downscale factor to divide the resolution of the image by
+     * @return the size of the images created with the given downscale
+     */
+    static Vector2ui getImageSize(const Vector2ui& frameSize,
+                                  uint32_t downscale);
+
+    /**
+     * Only re-encode the strips whose pixels changed since the previous call
+     * of createJPEG() with the same quality and downscale, at the cost of
+     * keeping a copy of the previous frame per quality and downscale.
+     */
+    void setDeltaEncoding(bool enabled);
 
 private:
     tjhandle _compressor{tjInitCompress()};
 
+    struct Strip
+    {
+        Strip() = default;
+        ~Strip();
+        Strip(const Strip&) = delete;
+        Strip& operator=(const Strip&) = delete;
+
+        tjhandle compressor{tjInitCompress()};
+        ImageJPEG jpeg;
+        size_t heightOffset{0}; // image height in the SOF segment
+        size_t sosOffset{0};    // start of scan segment
+        size_t scanBegin{0};    // entropy-coded data up to the EOI marker
+        std::vector<uint8_t> pixels; // input of jpeg for delta encoding
+    };
+    using StripsLayout =
+        std::tuple<uint32_t, uint32_t, uint32_t, int32_t, uint8_t>;
+    // Strips are kept per layout, so that clients streaming with different
+    // quality or downscale do not invalidate each other's delta encoding
+    struct Strips
+    {
+        std::vector<std::unique_ptr<Strip>> strips;
+        uint64_t lastUse{0};
+    };
+    std::map<StripsLayout, Strips> _strips;
+    uint64_t _stripsUses{0};
+    bool _deltaEncoding{false};
+    std::vector<uint8_t> _downscaled;
+    DepthCompressor _depthCompressor;
+    std::mutex _mutex;
+
     ImageJPEG::JpegData _encodeJpeg(uint32_t width, uint32_t height,
                                     const uint8_t* rawData, int32_t pixelFormat,
                                     uint8_t quality, unsigned long& dataSize);
+    ImageJPEG::JpegData _encodeJpegStrips(uint32_t width, uint32_t height,
+                                          uint32_t stripHeight,
+                                          const uint8_t* rawData,
+                                          int32_t pixelFormat, uint8_t quality,
+                                          unsigned long& dataSize);
 };
 }
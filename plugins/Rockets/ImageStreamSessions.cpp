@@ -0,0 +1,273 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ImageStreamSessions.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace brayns
+{
+namespace
+{
+struct Level
+{
+    uint8_t qualityDrop;
+    uint32_t downscale;
+    uint32_t fpsDivisor;
+};
+
+// Degrade quality first, then resolution, then frame rate
+const Level LEVELS[] = {{0, 1, 1},  {15, 1, 1}, {30, 1, 1}, {30, 2, 1},
+                        {30, 2, 2}, {30, 4, 2}, {30, 4, 4}};
+const size_t NB_LEVELS = sizeof(LEVELS) / sizeof(LEVELS[0]);
+
+const uint8_t MIN_QUALITY = 30;
+const size_t MIN_IN_FLIGHT = 2;
+const size_t MAX_IN_FLIGHT = 8;
+const double IMAGE_TIMEOUT = 2.0;
+const double DEGRADE_PERIOD = 1.0;
+const double UPGRADE_PERIOD = 3.0;
+const double RTT_SMOOTHING = 0.8;
+const double MIN_RTT_DRIFT = 0.01;
+}
+
+void ImageStreamSessions::addClient(const uintptr_t clientID)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sessions[clientID].stale = true;
+}
+
+void ImageStreamSessions::removeClient(const uintptr_t clientID)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sessions.erase(clientID);
+}
+
+void ImageStreamSessions::setDepth(const uintptr_t clientID,
+                                   const bool enabled)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto i = _sessions.find(clientID);
+    if (i == _sessions.end() || i->second.depth == enabled)
+        return;
+
+    i->second.depth = enabled;
+    i->second.stale = true;
+}
+
+void ImageStreamSessions::acknowledge(const uintptr_t clientID,
+                                      const double now)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto i = _sessions.find(clientID);
+    if (i == _sessions.end())
+        return;
+
+    auto& session = i->second;
+    session.adaptive = true;
+
+    // acknowledgment of an image which timed out already
+    if (session.inFlight.empty())
+        return;
+
+    const double rtt = now - session.inFlight.front();
+    session.inFlight.pop_front();
+    if (session.rtt == 0)
+        session.rtt = session.minRtt = rtt;
+    else
+    {
+        session.rtt = RTT_SMOOTHING * session.rtt + (1 - RTT_SMOOTHING) * rtt;
+        // follow a slower route eventually
+        session.minRtt =
+            std::min(rtt, session.minRtt + (rtt - session.minRtt) *
+                                               MIN_RTT_DRIFT);
+    }
+    _adapt(session, now, false);
+}
+
+std::map<ImageStreamSessions::Settings, ImageStreamSessions::ClientIDs>
+    ImageStreamSessions::schedule(const double now, const bool newFrame,
+                                  const uint8_t quality, const double fps)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _quality = quality;
+    _fps = fps;
+
+    std::map<Settings, ClientIDs> clients;
+    if (_fps <= 0)
+        return clients;
+
+    for (auto& i : _sessions)
+    {
+        auto& session = i.second;
+        if (newFrame)
+            session.stale = true;
+
+        bool lost = false;
+        while (!session.inFlight.empty() &&
+               now - session.inFlight.front() > IMAGE_TIMEOUT)
+        {
+            session.inFlight.pop_front();
+            lost = true;
+        }
+        if (lost)
+            _adapt(session, now, true);
+
+        if (!session.stale || now < session.nextFrame)
+            continue;
+
+        // drop the frame, the client gets a newer one once it caught up
+        if (session.adaptive &&
+            session.inFlight.size() >= _getMaxInFlight(session))
+        {
+            continue;
+        }
+
+        clients[_getSettings(session)].insert(i.first);
+    }
+    return clients;
+}
+
+void ImageStreamSessions::sent(const ClientIDs& clientIDs, const double now)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto clientID : clientIDs)
+    {
+        auto i = _sessions.find(clientID);
+        if (i == _sessions.end())
+            continue;
+
+        auto& session = i->second;
+        const double interval = _getInterval(session);
+        session.stale = false;
+        session.nextFrame = std::max(session.nextFrame, now - interval) +
+                            interval;
+        if (session.adaptive)
+            session.inFlight.push_back(now);
+    }
+}
+
+ImageStreamSessions::ClientIDs ImageStreamSessions::resized(
+    const ClientIDs& clientIDs, const uint32_t width, const uint32_t height)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ClientIDs changed;
+    for (const auto clientID : clientIDs)
+    {
+        auto i = _sessions.find(clientID);
+        if (i == _sessions.end())
+            continue;
+
+        auto& session = i->second;
+        if (session.width == width && session.height == height)
+            continue;
+
+        session.width = width;
+        session.height = height;
+        changed.insert(clientID);
+    }
+    return changed;
+}
+
+bool ImageStreamSessions::hasStaleClients() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& i : _sessions)
+        if (i.second.stale)
+            return true;
+    return false;
+}
+
+ImageStreamSessions::ClientIDs ImageStreamSessions::getOtherClients(
+    const ClientIDs& clientIDs) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ClientIDs others;
+    for (const auto& i : _sessions)
+        if (clientIDs.count(i.first) == 0)
+            others.insert(i.first);
+    return others;
+}
+
+ImageStreamSessions::Settings ImageStreamSessions::getSettings(
+    const uintptr_t clientID) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto i = _sessions.find(clientID);
+    return i == _sessions.end() ? Settings{_quality, 1, false}
+                                : _getSettings(i->second);
+}
+
+double ImageStreamSessions::getFPS(const uintptr_t clientID) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto i = _sessions.find(clientID);
+    return i == _sessions.end() ? _fps : 1.0 / _getInterval(i->second);
+}
+
+ImageStreamSessions::Settings ImageStreamSessions::_getSettings(
+    const Session& session) const
+{
+    const auto& level = LEVELS[session.level];
+    const uint8_t minQuality = std::min(_quality, MIN_QUALITY);
+    const uint8_t quality =
+        _quality > minQuality + level.qualityDrop
+            ? uint8_t(_quality - level.qualityDrop)
+            : minQuality;
+    return {quality, level.downscale, session.depth};
+}
+
+double ImageStreamSessions::_getInterval(const Session& session) const
+{
+    return LEVELS[session.level].fpsDivisor / _fps;
+}
+
+size_t ImageStreamSessions::_getMaxInFlight(const Session& session) const
+{
+    // enough images to cover the latency of the connection, the others would
+    // only queue up
+    const size_t latencyFrames =
+        std::ceil(session.minRtt / _getInterval(session)) + 1;
+    return std::min(std::max(latencyFrames, MIN_IN_FLIGHT), MAX_IN_FLIGHT);
+}
+
+void ImageStreamSessions::_adapt(Session& session, const double now,
+                                 const bool lost)
+{
+    // time that images wait in a queue on top of the connection latency
+    const double queueing = session.rtt - session.minRtt;
+    const double interval = _getInterval(session);
+    const double sinceChange = now - session.lastChange;
+
+    if ((lost || queueing > interval) && session.level + 1 < NB_LEVELS)
+    {
+        if (sinceChange >= DEGRADE_PERIOD)
+        {
+            ++session.level;
+            session.lastChange = now;
+        }
+    }
+    else if (!lost && queueing < interval / 4 && session.level > 0 &&
+             sinceChange >= UPGRADE_PERIOD)
+    {
+        --session.level;
+        session.lastChange = now;
+    }
+}
+}
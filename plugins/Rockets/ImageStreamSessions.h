@@ -0,0 +1,132 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+
+namespace brayns
+{
+/**
+ * Schedules the image stream for each connected client.
+ *
+ * Clients which acknowledge the images they receive get their own stream: an
+ * image is dropped instead of queued while the client has more images in
+ * flight than its latency explains, and its JPEG quality, resolution and frame
+ * rate are lowered while images queue up on its connection, and raised again
+ * once it keeps up. Other clients get the images at the application settings.
+ *
+ * Times are in seconds and only need to share the same origin.
+ */
+class ImageStreamSessions
+{
+public:
+    using ClientIDs = std::set<uintptr_t>;
+
+    /** Encoding settings shared by the clients of one image. */
+    struct Settings
+    {
+        uint8_t quality;
+        uint32_t downscale;
+        bool depth;
+
+        bool operator<(const Settings& rhs) const
+        {
+            return std::tie(quality, downscale, depth) <
+                   std::tie(rhs.quality, rhs.downscale, rhs.depth);
+        }
+    };
+
+    void addClient(uintptr_t clientID);
+    void removeClient(uintptr_t clientID);
+
+    /** Send the depth along with the color images to the given client. */
+    void setDepth(uintptr_t clientID, bool enabled);
+
+    /** Acknowledge the oldest image in flight, enables adaption for client */
+    void acknowledge(uintptr_t clientID, double now);
+
+    /**
+     * @param now current time
+     * @param newFrame true if a frame was rendered since the last call
+     * @param quality JPEG quality of the application
+     * @param fps image stream FPS of the application
+     * @return the clients to send the current frame to, grouped by settings
+     */
+    std::map<Settings, ClientIDs> schedule(double now, bool newFrame,
+                                           uint8_t quality, double fps);
+
+    /** Record that the current frame was sent to the given clients. */
+    void sent(const ClientIDs& clientIDs, double now);
+
+    /**
+     * Record the size of the image sent to the given clients.
+     *
+     * @return the clients for which the size changed since their last image
+     */
+    ClientIDs resized(const ClientIDs& clientIDs, uint32_t width,
+                      uint32_t height);
+
+    /**
+     * @return true if a client did not get the current frame yet, e.g.
+     *         because it was dropped or the stream FPS delayed it; schedule()
+     *         has to be called again even if no new frame is rendered.
+     */
+    bool hasStaleClients() const;
+
+    /** @return the connected clients which are not in the given ones */
+    ClientIDs getOtherClients(const ClientIDs& clientIDs) const;
+
+    /** @return the current settings of the given client */
+    Settings getSettings(uintptr_t clientID) const;
+
+    /** @return the current frame rate of the given client */
+    double getFPS(uintptr_t clientID) const;
+
+private:
+    struct Session
+    {
+        bool adaptive{false};
+        bool stale{false}; // has not received the latest frame yet
+        bool depth{false};
+        size_t level{0};
+        double nextFrame{0};
+        double lastChange{0};
+        double rtt{0}; // smoothed round-trip time
+        double minRtt{0};
+        uint32_t width{0}; // of the last image sent
+        uint32_t height{0};
+        std::deque<double> inFlight; // send times of unacknowledged images
+    };
+
+    std::map<uintptr_t, Session> _sessions;
+    uint8_t _quality{90};
+    double _fps{60};
+    mutable std::mutex _mutex;
+
+    Settings _getSettings(const Session& session) const;
+    double _getInterval(const Session& session) const;
+    size_t _getMaxInFlight(const Session& session) const;
+    void _adapt(Session& session, double now, bool lost);
+};
+}
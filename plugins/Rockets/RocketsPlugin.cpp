@@ -43,6 +43,7 @@
 
 #include "BinaryRequests.h"
 #include "ImageGenerator.h"
+#include "ImageStreamSessions.h"
 #include "Throttle.h"
 
 #ifdef BRAYNS_USE_FFMPEG
@@ -99,6 +100,7 @@ const std::string METHOD_REMOVE_CLIP_PLANES = "remove-clip-planes";
 const std::string METHOD_REMOVE_MODEL = "remove-model";
 const std::string METHOD_SCHEMA = "schema";
 const std::string METHOD_SET_ENVIRONMENT_MAP = "set-environment-map";
+const std::string METHOD_SET_IMAGE_STREAM_DEPTH = "set-image-stream-depth";
 const std::string METHOD_SET_MODEL_PROPERTIES = "set-model-properties";
 const std::string METHOD_SET_MODEL_TRANSFER_FUNCTION =
     "set-model-transfer-function";
@@ -116,7 +118,9 @@ const std::string METHOD_REMOVE_LIGHTS = "remove-lights";
 const std::string METHOD_CLEAR_LIGHTS = "clear-lights";
 
 // JSONRPC notifications
+const std::string METHOD_ACK_IMAGE_JPEG = "ack-image-jpeg";
 const std::string METHOD_CHUNK = "chunk";
+const std::string METHOD_IMAGE_JPEG_SIZE = "image-jpeg-size";
 const std::string METHOD_QUIT = "quit";
 const std::string METHOD_RESET_CAMERA = "reset-camera";
 
@@ -163,8 +167,21 @@ const Response::Error VIDEOSTREAM_NOT_ENABLED_ERROR{
 const Response::Error VIDEOSTREAM_NOT_SUPPORTED_ERROR{
     "Brayns was not build with videostream support",
     VIDEOSTREAMING_NOT_SUPPORTED};
+
+/** Parameters of tasks registered by plugins, deserialized by the plugins. */
+struct RawJSON
+{
+    std::string json;
+};
 } // namespace
 
+template <>
+inline bool from_json(RawJSON& obj, const std::string& json)
+{
+    obj.json = json;
+    return true;
+}
+
 namespace brayns
 {
 template <class T, class PRE>
@@ -226,6 +243,11 @@ public:
                 uvw::Loop::getDefault()->resource<uvw::AsyncHandle>();
             _processDelayedNotifies->on<uvw::AsyncEvent>(
                 [&](const auto&, auto&) { this->processDelayedNotifies(); });
+
+            _resendImageJpeg =
+                uvw::Loop::getDefault()->resource<uvw::TimerHandle>();
+            _resendImageJpeg->on<uvw::TimerEvent>(
+                [&](const auto&, auto&) { this->_resendStaleImageJpeg(); });
         }
 #endif
     }
@@ -248,6 +270,8 @@ public:
 #ifdef BRAYNS_USE_LIBUV
         if (_processDelayedNotifies)
             _processDelayedNotifies->close();
+        if (_resendImageJpeg)
+            _resendImageJpeg->close();
 #endif
 
         if (_rocketsServer)
@@ -268,6 +292,7 @@ public:
         {
             processDelayedNotifies();
             _rocketsServer->process(0);
+            _resendStaleImageJpeg();
         }
         catch (const std::exception& exc)
         {
@@ -282,7 +307,7 @@ public:
             return;
 
         if (!_parametersManager.getApplicationParameters().useVideoStreaming())
-            _broadcastImageJpeg();
+            _broadcastImageJpeg(_engine.getFrameBuffer().isModified());
 #ifdef BRAYNS_USE_FFMPEG
         else
             _broadcastVideo();
@@ -384,6 +409,22 @@ public:
         });
     }
 
+    void _registerTask(const RpcParameterDescription& desc,
+                       const PropertyMap& input, const PropertyMap& output,
+                       const TaskFunc& createTask)
+    {
+        _jsonrpcServer->bindAsync<RawJSON>(
+            desc.methodName,
+            _createTaskAction<RawJSON, std::string>(
+                [createTask](const RawJSON& params, const auto) {
+                    return createTask(params.json);
+                }));
+
+        _handleSchema(desc.methodName,
+                      buildJsonRpcSchemaRequestPropertyMap(desc, input,
+                                                           output));
+    }
+
     void processDelayedNotifies()
     {
         // call pending notifies from delayed throttle threads here as
@@ -437,8 +478,14 @@ public:
 
     void _setupWebsocket()
     {
+        _rocketsServer->handleOpen([this](const uintptr_t clientID) {
+            _streamSessions.addClient(clientID);
+            return std::vector<rockets::ws::Response>{};
+        });
+
         _rocketsServer->handleClose([this](const uintptr_t clientID) {
             _binaryRequests.removeRequest(clientID);
+            _streamSessions.removeClient(clientID);
             return std::vector<rockets::ws::Response>{};
         });
 
@@ -791,6 +838,30 @@ public:
     void _handleTask(
         const RpcParameterDescription& desc,
         std::function<std::shared_ptr<Task<R>>(P, uintptr_t)> createTask)
+    {
+        _handleAsyncRPC<P, R>(desc, _createTaskAction<P, R>(createTask));
+    }
+
+    template <class R>
+    static std::string _resultToJSON(const R& result)
+    {
+        return to_json(result);
+    }
+
+    // Results of tasks registered by plugins are already serialized
+    static std::string _resultToJSON(const std::string& result)
+    {
+        return result;
+    }
+
+    template <class P>
+    using AsyncAction = std::function<rockets::jsonrpc::CancelRequestCallback(
+        P, uintptr_t, rockets::jsonrpc::AsyncResponse,
+        rockets::jsonrpc::ProgressUpdateCallback)>;
+
+    template <class P, class R>
+    AsyncAction<P> _createTaskAction(
+        std::function<std::shared_ptr<Task<R>>(P, uintptr_t)> createTask)
     {
         // define the action that is executed on every incoming request from the
         // client:
@@ -815,8 +886,9 @@ public:
                 auto readyCallback = [&, respond](const R& result) {
                     try
                     {
-                        this->_delayedNotify(
-                            [respond, result] { respond({to_json(result)}); });
+                        this->_delayedNotify([respond, result] {
+                            respond({Impl::_resultToJSON(result)});
+                        });
                     }
                     catch (const std::runtime_error& e)
                     {
@@ -920,7 +992,7 @@ public:
             }
             return rockets::jsonrpc::CancelRequestCallback();
         };
-        _handleAsyncRPC<P, R>(desc, action);
+        return action;
     }
 
     template <class T>
@@ -954,6 +1026,8 @@ public:
         _handleAnimationParams();
         _handleCamera();
         _handleImageJPEG();
+        _handleAckImageJPEG();
+        _handleSetImageStreamDepth();
         _handleRenderer();
         _handleVersion();
 
@@ -1032,36 +1106,120 @@ public:
                  "Get the current state of " + METHOD_IMAGE_JPEG}));
     }
 
-    void _broadcastImageJpeg()
+    /**
+     * Send the current frame to the clients which did not get it yet, i.e.
+     * the ones which fell behind or were delayed by the stream FPS. Nothing
+     * is rendered anymore once the image converged, so this runs from the
+     * Rockets processing loop or a timer rather than after rendering. The
+     * timer runs on the network thread, which must not wait for a frame being
+     * rendered; the resend is then left to the next tick or to postRender().
+     */
+    void _resendStaleImageJpeg()
     {
-        auto& frameBuffer = _engine.getFrameBuffer();
-        if (frameBuffer.getFrameBufferFormat() == FrameBufferFormat::none ||
-            !frameBuffer.isModified())
+        if (!_rocketsServer || _rocketsServer->getConnectionCount() == 0 ||
+            _parametersManager.getApplicationParameters().useVideoStreaming() ||
+            !_streamSessions.hasStaleClients())
         {
+#ifdef BRAYNS_USE_LIBUV
+            if (_resendImageJpeg)
+                _resendImageJpeg->stop();
+#endif
+            return;
+        }
+
+        // Held until the images are sent, which then share this mapping
+        const auto snapshot = _engine.getFrameBuffer().tryGetSnapshot();
+        if (!snapshot)
+            return;
+        _broadcastImageJpeg(false);
+    }
+
+    void _broadcastImageJpeg(const bool newFrame)
+    {
+        _sendImageJpeg(newFrame);
+
+#ifdef BRAYNS_USE_LIBUV
+        if (!_resendImageJpeg)
             return;
+
+        const auto fps =
+            _parametersManager.getApplicationParameters().getImageStreamFPS();
+        if (fps == 0 || !_streamSessions.hasStaleClients())
+            _resendImageJpeg->stop();
+        else if (!_resendImageJpeg->active())
+        {
+            const std::chrono::milliseconds interval(
+                std::max<int64_t>(1, 1000 / fps));
+            _resendImageJpeg->start(interval, interval);
         }
+#endif
+    }
+
+    void _sendImageJpeg(const bool newFrame)
+    {
+        auto& frameBuffer = _engine.getFrameBuffer();
+        if (frameBuffer.getFrameBufferFormat() == FrameBufferFormat::none)
+            return;
 
         const auto& params = _parametersManager.getApplicationParameters();
         const auto fps = params.getImageStreamFPS();
         if (fps == 0)
             return;
 
-        const auto elapsed = _timer.elapsed() + _leftover;
-        const auto duration = 1.0 / fps;
-        if (elapsed < duration)
-            return;
+        const auto now = _timer.elapsed();
+        const auto clientsPerSettings =
+            _streamSessions.schedule(now, newFrame,
+                                     params.getJpegCompression(), fps);
 
-        _leftover = elapsed - duration;
-        for (; _leftover > duration;)
-            _leftover -= duration;
-        _timer.start();
+        _imageGenerator.setDeltaEncoding(params.useJpegDeltaEncoding());
+        for (const auto& i : clientsPerSettings)
+        {
+            const auto& settings = i.first;
+            const auto& clients = i.second;
+
+            // Tell the clients about the image size before an image of
+            // another size, it changes with the downscale of their settings
+            const auto size =
+                ImageGenerator::getImageSize(frameBuffer.getSize(),
+                                             settings.downscale);
+            const auto resized =
+                _streamSessions.resized(clients, size.x, size.y);
+            if (!resized.empty())
+            {
+                const auto& msg = rockets::jsonrpc::makeNotification(
+                    METHOD_IMAGE_JPEG_SIZE,
+                    to_json(ImageStreamSize{size.x, size.y}));
+                _rocketsServer->broadcastText(
+                    msg, _streamSessions.getOtherClients(resized));
+            }
 
-        const auto image =
-            _imageGenerator.createJPEG(frameBuffer,
-                                       params.getJpegCompression());
-        if (image.size > 0)
-            _rocketsServer->broadcastBinary((const char*)image.data.get(),
-                                            image.size);
+            if (settings.depth)
+            {
+                const auto image =
+                    _imageGenerator.createJPEGWithDepth(frameBuffer,
+                                                        settings.quality,
+                                                        settings.downscale);
+                if (image.empty())
+                    continue;
+
+                _rocketsServer->broadcastBinary(
+                    (const char*)image.data(), image.size(),
+                    _streamSessions.getOtherClients(clients));
+            }
+            else
+            {
+                const auto image =
+                    _imageGenerator.createJPEG(frameBuffer, settings.quality,
+                                               settings.downscale);
+                if (image.size == 0)
+                    continue;
+
+                _rocketsServer->broadcastBinary(
+                    (const char*)image.data.get(), image.size,
+                    _streamSessions.getOtherClients(clients));
+            }
+            _streamSessions.sent(clients, now);
+        }
     }
 
 #ifdef BRAYNS_USE_FFMPEG
@@ -1081,8 +1239,12 @@ public:
         if (fps == 0)
             return;
 
-        if (_encoder && _encoder->kbps != _videoParams.kbps)
+        if (_encoder && (_encoder->kbps != _videoParams.kbps ||
+                         _encoder->gop != int(_videoParams.gop) ||
+                         _encoder->intraRefresh != _videoParams.intraRefresh))
+        {
             _encoder.reset();
+        }
 
         auto& frameBuffer = _engine.getFrameBuffer();
         if (!_encoder)
@@ -1094,12 +1256,12 @@ public:
             if (height % 2 != 0)
                 height += 1;
 
-            _encoder =
-                std::make_unique<Encoder>(width, height, fps, _videoParams.kbps,
-                                          [& rs = _rocketsServer](auto a,
-                                                                  auto b) {
-                                              rs->broadcastBinary(a, b);
-                                          });
+            _encoder = std::make_unique<Encoder>(
+                width, height, fps, _videoParams.kbps, _videoParams.gop,
+                _videoParams.intraRefresh,
+                [& rs = _rocketsServer](auto a, auto b) {
+                    rs->broadcastBinary(a, b);
+                });
         }
 
         if (_videoUpdatedResponse)
@@ -1230,6 +1392,37 @@ public:
                    });
     }
 
+    void _handleAckImageJPEG()
+    {
+        _jsonrpcServer->connect(METHOD_ACK_IMAGE_JPEG,
+                                [this](const rockets::jsonrpc::Request& req) {
+                                    _streamSessions.acknowledge(
+                                        req.clientID, _timer.elapsed());
+                                });
+        const std::string description =
+            "Acknowledge the receipt of a streamed image to adapt the image "
+            "stream to the connection. Adapted images may be downscaled, the "
+            "size of the streamed images is sent with the '" +
+            METHOD_IMAGE_JPEG_SIZE + "' notification whenever it changes";
+        _handleSchema(METHOD_ACK_IMAGE_JPEG,
+                      buildJsonRpcSchemaNotify(
+                          {METHOD_ACK_IMAGE_JPEG, description}));
+    }
+
+    void _handleSetImageStreamDepth()
+    {
+        const RpcParameterDescription desc{
+            METHOD_SET_IMAGE_STREAM_DEPTH,
+            "Stream the compressed depth along with the color of each image to "
+            "the calling client",
+            "param", "whether to stream the depth"};
+
+        _handleRPC<ImageStreamDepthParam>(
+            desc, [&](const ImageStreamDepthParam& param) {
+                _streamSessions.setDepth(_currentClientID, param.enabled);
+            });
+    }
+
     void _handleResetCamera()
     {
         _handleRPC({METHOD_RESET_CAMERA,
@@ -1625,6 +1818,8 @@ public:
                           if (auto model = scene.getModel(newDesc.getModelID()))
                           {
                               ::from_json(*model, request.message);
+                              // from_json does not mark the model modified
+                              model->markModified();
                               scene.markModified();
                               engine.triggerRender();
                               return Response{to_json(true)};
@@ -1761,6 +1956,7 @@ public:
                                                            INSTANCE_NOT_FOUND);
 
                 ::from_json(*instance, request.message);
+                instance->markModified();
                 model->getModel().markInstancesDirty();
                 scene.markModified(false);
 
@@ -1925,7 +2121,13 @@ public:
                      .useVideoStreaming())
                 throw rockets::jsonrpc::response_error(
                     VIDEOSTREAM_NOT_ENABLED_ERROR);
-            return _videoParams;
+            auto params = _videoParams;
+            if (_encoder)
+            {
+                params.framesEncoded = _encoder->getFramesEncoded();
+                params.framesDropped = _encoder->getFramesDropped();
+            }
+            return params;
 #else
             throw rockets::jsonrpc::response_error(VIDEOSTREAM_NOT_SUPPORTED_ERROR);
 #endif
@@ -1942,6 +2144,7 @@ public:
 
 #ifdef BRAYNS_USE_LIBUV
     std::shared_ptr<uvw::AsyncHandle> _processDelayedNotifies;
+    std::shared_ptr<uvw::TimerHandle> _resendImageJpeg;
 #endif
 
     std::unordered_map<std::string, std::string> _schemas;
@@ -1957,7 +2160,7 @@ public:
     ImageGenerator _imageGenerator;
 
     Timer _timer;
-    float _leftover{0.f};
+    ImageStreamSessions _streamSessions;
 
     std::map<TaskPtr, std::shared_ptr<async::task<void>>> _tasks;
     std::mutex _tasksMutex;
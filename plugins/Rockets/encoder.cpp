@@ -22,6 +22,119 @@
 #include <brayns/common/log.h>
 #include <brayns/engine/FrameBuffer.h>
 
+#include <async++.h>
+
+#include <algorithm>
+
+namespace
+{
+// Rows of the color conversion per task
+const int ROWS_PER_TASK = 32;
+// Slices of x264 do not scale beyond that for typical frame sizes
+const unsigned MAX_ENCODER_THREADS = 8;
+
+// BT.601 limited range, like libswscale
+inline uint8_t toY(const int r, const int g, const int b)
+{
+    return ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+}
+
+inline uint8_t toU(const int r, const int g, const int b)
+{
+    return ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+}
+
+inline uint8_t toV(const int r, const int g, const int b)
+{
+    return ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+}
+
+/**
+ * Convert a row of 4 byte per pixel to luma. Channels are read at constant
+ * offsets of contiguous pixels, so the loop is vectorized.
+ */
+template <int redOffset>
+void toYRow(const uint8_t *const src, uint8_t *const dst, const int width)
+{
+    const int blueOffset = 2 - redOffset;
+    for (int x = 0; x < width; ++x)
+    {
+        const uint8_t *pixel = src + 4 * x;
+        dst[x] = toY(pixel[redOffset], pixel[1], pixel[blueOffset]);
+    }
+}
+
+/**
+ * Convert two rows of 4 byte per pixel to one row of chroma, each sample
+ * being the average of a 2x2 block. Only full blocks are converted.
+ */
+template <int redOffset>
+void toUVRow(const uint8_t *const src0, const uint8_t *const src1,
+             uint8_t *const dstU, uint8_t *const dstV, const int pairs)
+{
+    const int blueOffset = 2 - redOffset;
+    for (int x = 0; x < pairs; ++x)
+    {
+        const int i = 8 * x;
+        const int r = (src0[i + redOffset] + src0[i + 4 + redOffset] +
+                       src1[i + redOffset] + src1[i + 4 + redOffset] + 2) >>
+                      2;
+        const int g =
+            (src0[i + 1] + src0[i + 5] + src1[i + 1] + src1[i + 5] + 2) >> 2;
+        const int b = (src0[i + blueOffset] + src0[i + 4 + blueOffset] +
+                       src1[i + blueOffset] + src1[i + 4 + blueOffset] + 2) >>
+                      2;
+        dstU[x] = toU(r, g, b);
+        dstV[x] = toV(r, g, b);
+    }
+}
+
+/**
+ * Convert the rows [begin, end) of a 4 byte per pixel image to the YUV420
+ * frame. The frame may be one pixel larger than the image, in which case the
+ * last column and row are repeated. The channel order is a template parameter
+ * for the row loops to be vectorized.
+ */
+template <int redOffset>
+void toYUV420(const uint8_t *const data, const int width, const int height,
+              AVFrame *frame, const int begin, const int end)
+{
+    const int blueOffset = 2 - redOffset;
+    const int pairs = std::min(frame->width, width) / 2;
+    const bool padColumn = frame->width > width;
+    for (int y = begin; y < end; y += 2)
+    {
+        const uint8_t *src0 = data + std::min(y, height - 1) * width * 4;
+        const uint8_t *src1 = data + std::min(y + 1, height - 1) * width * 4;
+        uint8_t *dstY0 = frame->data[0] + y * frame->linesize[0];
+        uint8_t *dstY1 = dstY0 + frame->linesize[0];
+        uint8_t *dstU = frame->data[1] + y / 2 * frame->linesize[1];
+        uint8_t *dstV = frame->data[2] + y / 2 * frame->linesize[2];
+
+        toYRow<redOffset>(src0, dstY0, width);
+        toYRow<redOffset>(src1, dstY1, width);
+        toUVRow<redOffset>(src0, src1, dstU, dstV, pairs);
+
+        if (padColumn)
+        {
+            dstY0[width] = dstY0[width - 1];
+            dstY1[width] = dstY1[width - 1];
+        }
+        if (2 * pairs < frame->width)
+        {
+            // The last column is odd: its block repeats the last pixel
+            const uint8_t *last0 = src0 + (width - 1) * 4;
+            const uint8_t *last1 = src1 + (width - 1) * 4;
+            const int r = (last0[redOffset] + last1[redOffset] + 1) >> 1;
+            const int g = (last0[1] + last1[1] + 1) >> 1;
+            const int b = (last0[blueOffset] + last1[blueOffset] + 1) >> 1;
+            dstU[pairs] = toU(r, g, b);
+            dstV[pairs] = toV(r, g, b);
+        }
+    }
+}
+}
+
 int custom_io_write(void *opaque, uint8_t *buffer, int32_t buffer_size)
 {
     auto encoder = (brayns::Encoder *)opaque;
@@ -32,11 +145,14 @@ int custom_io_write(void *opaque, uint8_t *buffer, int32_t buffer_size)
 namespace brayns
 {
 Encoder::Encoder(const int width_, const int height_, const int fps,
-                 const int64_t kbps_, const DataFunc &dataFunc)
+                 const int64_t kbps_, const int gop_, const bool intraRefresh_,
+                 const DataFunc &dataFunc)
     : _dataFunc(dataFunc)
     , width(width_)
     , height(height_)
     , kbps(kbps_)
+    , gop(gop_)
+    , intraRefresh(intraRefresh_)
     , _fps(fps)
 {
 #ifndef FF_API_NEXT
@@ -69,12 +185,21 @@ Encoder::Encoder(const int width_, const int height_, const int fps,
     codecContext->codec_type = AVMEDIA_TYPE_VIDEO;
     codecContext->width = width;
     codecContext->height = height;
-    codecContext->gop_size = 0;
+    // intra refresh needs a period to refresh the image over
+    codecContext->gop_size = intraRefresh && gop == 0 ? fps : gop;
     codecContext->pix_fmt = AV_PIX_FMT_YUV420P;
     codecContext->framerate = avFPS;
     codecContext->time_base = av_inv_q(avFPS);
     codecContext->bit_rate = kbps * 1000;
+    // crf picks the quality, the VBV caps the bitrate of the stream
+    codecContext->rc_max_rate = codecContext->bit_rate;
+    codecContext->rc_buffer_size = codecContext->bit_rate / 2;
     codecContext->max_b_frames = 0;
+    codecContext->thread_count =
+        std::max(1u, std::min(std::thread::hardware_concurrency(),
+                              MAX_ENCODER_THREADS));
+    // frame threading adds a frame of latency per thread
+    codecContext->thread_type = FF_THREAD_SLICE;
     codecContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 
     codecContext->profile = 100;
@@ -84,6 +209,8 @@ Encoder::Encoder(const int width_, const int height_, const int fps,
     av_opt_set(codecContext->priv_data, "preset", "ultrafast", 0);
     // av_opt_set(codecContext->priv_data, "profile", "main", 0);
     av_opt_set(codecContext->priv_data, "tune", "zerolatency", 0);
+    if (intraRefresh)
+        av_opt_set(codecContext->priv_data, "intra-refresh", "1", 0);
 
     if (avcodec_open2(codecContext, codec, NULL) < 0)
         BRAYNS_THROW(std::runtime_error("Could not open video encoder!"));
@@ -99,13 +226,20 @@ Encoder::Encoder(const int width_, const int height_, const int fps,
 
     AVDictionary *fmt_opts = NULL;
     av_dict_set(&fmt_opts, "brand", "mp42", 0);
-    av_dict_set(&fmt_opts, "movflags", "faststart+frag_keyframe+empty_moov", 0);
+    // fragments are flushed after each frame in _encode(), fragmenting on
+    // keyframes would delay the stream by a whole GOP
+    av_dict_set(&fmt_opts, "movflags", "faststart+frag_custom+empty_moov", 0);
     av_dict_set(&fmt_opts, "live", "1", 0);
     if (avformat_write_header(formatContext, &fmt_opts) < 0)
         BRAYNS_THROW(std::runtime_error("Could not write header!"));
 
     picture.init(codecContext->pix_fmt, width, height);
 
+    BRAYNS_INFO << "Video stream: " << width << "x" << height << "@" << fps
+                << ", " << kbps << " kbps, GOP " << codecContext->gop_size
+                << (intraRefresh ? " with intra refresh" : "") << ", "
+                << codecContext->thread_count << " threads" << std::endl;
+
     if (_async)
         _thread = std::thread(std::bind(&Encoder::_runAsync, this));
 
@@ -122,6 +256,9 @@ Encoder::~Encoder()
         _thread.join();
     }
 
+    BRAYNS_INFO << "Video stream: " << _framesEncoded << " frames encoded, "
+                << _framesDropped << " dropped" << std::endl;
+
     if (formatContext)
     {
         av_write_trailer(formatContext);
@@ -133,63 +270,70 @@ Encoder::~Encoder()
 
 void Encoder::encode(FrameBuffer &fb)
 {
+    // Limit to the stream FPS before copying and converting the frame
+    const auto elapsed = _timer.elapsed() + _leftover;
+    const auto duration = 1.0 / _fps;
+    if (elapsed < duration)
+        return;
+
+    _leftover = elapsed - duration;
+    for (; _leftover > duration;)
+        _leftover -= duration;
+    _timer.start();
+
     if (_async && _queue.size() == 2)
+    {
+        ++_framesDropped;
         return;
+    }
 
-    fb.map();
-    auto cdata = reinterpret_cast<const uint8_t *const>(fb.getColorBuffer());
+    const auto snapshot = fb.getSnapshot();
+    const auto cdata = snapshot->colorBuffer;
     if (_async)
     {
         auto &image = _image[_currentImage];
-        image.width = fb.getSize().x;
-        image.height = fb.getSize().y;
-        const auto bufferSize = image.width * image.height * fb.getColorDepth();
+        image.width = snapshot->size.x;
+        image.height = snapshot->size.y;
+        image.format = snapshot->format;
+        const auto bufferSize = snapshot->getColorBufferSize();
 
         if (image.data.size() < bufferSize)
             image.data.resize(bufferSize);
         memcpy(image.data.data(), cdata, bufferSize);
         _queue.push(_currentImage);
-        _currentImage = _currentImage == 0 ? 1 : 0;
-        fb.unmap();
+        _currentImage = (_currentImage + 1) % 3;
         return;
     }
 
-    _toPicture(cdata, fb.getSize().x, fb.getSize().y);
-    fb.unmap();
-
+    _toPicture(cdata, snapshot->size.x, snapshot->size.y, snapshot->format);
     _encode();
 }
 
 void Encoder::_encode()
 {
-    const auto elapsed = _timer.elapsed() + _leftover;
-    const auto duration = 1.0 / _fps;
-    if (elapsed < duration)
-        return;
-
-    _leftover = elapsed - duration;
-    for (; _leftover > duration;)
-        _leftover -= duration;
-
     picture.frame->pts = _frameNumber++;
 
     if (avcodec_send_frame(codecContext, picture.frame) < 0)
         return;
+    ++_framesEncoded;
 
-    AVPacket pkt;
-    av_init_packet(&pkt);
-    const auto ret = avcodec_receive_packet(codecContext, &pkt);
-    if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+    for (;;)
     {
+        AVPacket pkt;
+        av_init_packet(&pkt);
+        pkt.data = nullptr;
+        pkt.size = 0;
+        if (avcodec_receive_packet(codecContext, &pkt) < 0)
+            break;
+
+        av_packet_rescale_ts(&pkt, codecContext->time_base, stream->time_base);
+        pkt.stream_index = stream->index;
+        av_write_frame(formatContext, &pkt);
         av_packet_unref(&pkt);
-        return;
     }
 
-    av_packet_rescale_ts(&pkt, codecContext->time_base, stream->time_base);
-    pkt.stream_index = stream->index;
-    av_interleaved_write_frame(formatContext, &pkt);
-
-    _timer.start();
+    // flush the fragment of this frame
+    av_write_frame(formatContext, nullptr);
 }
 
 void Encoder::_runAsync()
@@ -202,18 +346,41 @@ void Encoder::_runAsync()
 
         auto &image = _image[idx];
 
-        _toPicture(image.data.data(), image.width, image.height);
+        _toPicture(image.data.data(), image.width, image.height, image.format);
         _encode();
     }
 }
 
 void Encoder::_toPicture(const uint8_t *const data, const int width_,
-                         const int height_)
+                         const int height_, const FrameBufferFormat format)
 {
+    // The frame is at most one pixel larger than the image to be even-sized,
+    // which the conversion handles without scaling.
+    const bool sameSize = width - width_ >= 0 && width - width_ <= 1 &&
+                          height - height_ >= 0 && height - height_ <= 1;
+    if (sameSize && av_frame_make_writable(picture.frame) >= 0)
+    {
+        const bool isBGRA = format == FrameBufferFormat::bgra_i8;
+        auto frame = picture.frame;
+        const int tasks = (height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+        async::parallel_for(async::irange(0, tasks), [&](const int task) {
+            const int begin = task * ROWS_PER_TASK;
+            const int end = std::min(begin + ROWS_PER_TASK, height);
+            if (isBGRA)
+                toYUV420<2>(data, width_, height_, frame, begin, end);
+            else
+                toYUV420<0>(data, width_, height_, frame, begin, end);
+        });
+        return;
+    }
+
+    const auto pixelFormat = format == FrameBufferFormat::bgra_i8
+                                 ? AV_PIX_FMT_BGRA
+                                 : AV_PIX_FMT_RGBA;
     sws_context =
-        sws_getCachedContext(sws_context, width_, height_, AV_PIX_FMT_RGBA,
-                             width, height, AV_PIX_FMT_YUV420P,
-                             SWS_FAST_BILINEAR, 0, 0, 0);
+        sws_getCachedContext(sws_context, width_, height_, pixelFormat, width,
+                             height, AV_PIX_FMT_YUV420P, SWS_FAST_BILINEAR, 0,
+                             0, 0);
     const int stride[] = {4 * (int)width_};
     sws_scale(sws_context, &data, stride, 0, height_, picture.frame->data,
               picture.frame->linesize);
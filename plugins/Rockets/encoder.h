@@ -111,16 +111,30 @@ class Encoder
 public:
     using DataFunc = std::function<void(const char *data, size_t size)>;
 
+    /**
+     * @param gop number of frames between keyframes, 0 for intra frames only
+     * @param intraRefresh replace keyframes by a moving column of intra blocks
+     *                     refreshing the image over gop frames, which avoids
+     *                     bitrate peaks
+     */
     Encoder(const int width, const int height, const int fps,
-            const int64_t kbps, const DataFunc &dataFunc);
+            const int64_t kbps, const int gop, const bool intraRefresh,
+            const DataFunc &dataFunc);
     ~Encoder();
 
     void encode(FrameBuffer &fb);
 
+    /** Number of frames that were encoded so far. */
+    size_t getFramesEncoded() const { return _framesEncoded; }
+    /** Number of frames dropped so far as the encoder was still busy. */
+    size_t getFramesDropped() const { return _framesDropped; }
+
     DataFunc _dataFunc;
     const int width;
     const int height;
     const int64_t kbps;
+    const int gop;
+    const bool intraRefresh;
 
 private:
     const int _fps;
@@ -143,18 +157,24 @@ private:
     {
         int width{0};
         int height{0};
+        FrameBufferFormat format{FrameBufferFormat::rgba_i8};
         std::vector<uint8_t> data;
         bool empty() const { return width == 0 || height == 0; }
         void clear() { width = height = 0; }
-    } _image[2];
+    };
 
+    // one image per queue entry plus the one being encoded
+    Image _image[3];
     MTQueue<int> _queue;
     int _currentImage{0};
 
+    std::atomic<size_t> _framesEncoded{0};
+    std::atomic<size_t> _framesDropped{0};
+
     void _runAsync();
     void _encode();
     void _toPicture(const uint8_t *const data, const int width,
-                    const int height);
+                    const int height, const FrameBufferFormat format);
 
     Timer _timer;
     float _leftover{0.f};
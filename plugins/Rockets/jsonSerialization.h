@@ -69,10 +69,17 @@ struct VideoStreamParam
 {
     bool enabled{false};
     uint32_t kbps{5000};
+    uint32_t gop{60};
+    bool intraRefresh{false};
+
+    // statistics of the current stream
+    size_t framesEncoded{0};
+    size_t framesDropped{0};
 
     bool operator==(const VideoStreamParam& rhs) const
     {
-        return enabled == rhs.enabled && kbps == rhs.kbps;
+        return enabled == rhs.enabled && kbps == rhs.kbps && gop == rhs.gop &&
+               intraRefresh == rhs.intraRefresh;
     }
 
     bool operator!=(const VideoStreamParam& rhs) const
@@ -81,6 +88,17 @@ struct VideoStreamParam
     }
 };
 
+struct ImageStreamDepthParam
+{
+    bool enabled{false};
+};
+
+struct ImageStreamSize
+{
+    uint32_t width{0};
+    uint32_t height{0};
+};
+
 struct ObjectID
 {
     size_t id;
@@ -122,7 +140,8 @@ STATICJSON_DECLARE_ENUM(brayns::ColorScheme,
 
 STATICJSON_DECLARE_ENUM(brayns::MemoryMode,
                         {"shared", brayns::MemoryMode::shared},
-                        {"replicated", brayns::MemoryMode::replicated});
+                        {"replicated", brayns::MemoryMode::replicated},
+                        {"compact", brayns::MemoryMode::compact});
 
 STATICJSON_DECLARE_ENUM(brayns::TextureType,
                         {"diffuse", brayns::TextureType::diffuse},
@@ -209,6 +228,25 @@ inline void init(brayns::VideoStreamParam* s, ObjectHandler* h)
 {
     h->add_property("enabled", &s->enabled, Flags::Optional);
     h->add_property("kbps", &s->kbps, Flags::Optional);
+    h->add_property("gop", &s->gop, Flags::Optional);
+    h->add_property("intra_refresh", &s->intraRefresh, Flags::Optional);
+    h->add_property("frames_encoded", &s->framesEncoded,
+                    Flags::IgnoreRead | Flags::Optional);
+    h->add_property("frames_dropped", &s->framesDropped,
+                    Flags::IgnoreRead | Flags::Optional);
+    h->set_flags(Flags::DisallowUnknownKey);
+}
+
+inline void init(brayns::ImageStreamDepthParam* s, ObjectHandler* h)
+{
+    h->add_property("enabled", &s->enabled);
+    h->set_flags(Flags::DisallowUnknownKey);
+}
+
+inline void init(brayns::ImageStreamSize* s, ObjectHandler* h)
+{
+    h->add_property("width", &s->width);
+    h->add_property("height", &s->height);
     h->set_flags(Flags::DisallowUnknownKey);
 }
 
@@ -251,6 +289,11 @@ inline void init(brayns::Statistics* s, ObjectHandler* h)
 {
     h->add_property("fps", &s->_fps);
     h->add_property("scene_size_in_bytes", &s->_sceneSizeInBytes);
+    h->add_property("simulation_prefetch_hits", &s->_simulationPrefetchHits);
+    h->add_property("simulation_prefetch_misses",
+                    &s->_simulationPrefetchMisses);
+    h->add_property("variance", &s->_variance);
+    h->add_property("converged", &s->_converged);
     h->set_flags(Flags::DisallowUnknownKey);
 }
 
@@ -385,6 +428,8 @@ inline void init(brayns::ApplicationParameters* a, ObjectHandler* h)
 {
     h->add_property("engine", &a->_engine, Flags::IgnoreRead | Flags::Optional);
     h->add_property("jpeg_compression", &a->_jpegCompression, Flags::Optional);
+    h->add_property("jpeg_delta_encoding", &a->_jpegDeltaEncoding,
+                    Flags::Optional);
     h->add_property("image_stream_fps", &a->_imageStreamFPS, Flags::Optional);
     h->add_property("viewport", toArray<2, double>(a->_windowSize),
                     Flags::Optional);
@@ -394,6 +439,8 @@ inline void init(brayns::ApplicationParameters* a, ObjectHandler* h)
 inline void init(brayns::RenderingParameters* r, ObjectHandler* h)
 {
     h->add_property("accumulation", &r->_accumulation, Flags::Optional);
+    h->add_property("adaptive_subsampling", &r->_adaptiveSubsampling,
+                    Flags::Optional);
     h->add_property("background_color", toArray<3, double>(r->_backgroundColor),
                     Flags::Optional);
     h->add_property("current", &r->_renderer, Flags::Optional);
@@ -438,6 +485,7 @@ inline void init(brayns::AnimationParameters* a, ObjectHandler* h)
     h->add_property("delta", &a->_delta, Flags::Optional);
     h->add_property("dt", &a->_dt, Flags::Optional);
     h->add_property("playing", &a->_playing, Flags::Optional);
+    h->add_property("prefetch_frames", &a->_prefetchFrames, Flags::Optional);
     h->add_property("unit", &a->_unit, Flags::Optional);
     h->set_flags(Flags::DisallowUnknownKey);
 }
@@ -0,0 +1,89 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/AdaptiveSubsampling.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+TEST_CASE("fast_frames_are_not_subsampled")
+{
+    brayns::AdaptiveSubsampling subsampling;
+    subsampling.setTargetTime(40.);
+    subsampling.setMaxFactor(8);
+    for (size_t i = 0; i < 10; ++i)
+        subsampling.update(10., 1.);
+    CHECK_EQ(subsampling.getFactor(), 1);
+}
+
+TEST_CASE("slow_frame_raises_factor_immediately")
+{
+    brayns::AdaptiveSubsampling subsampling;
+    subsampling.setTargetTime(10.);
+    subsampling.setMaxFactor(8);
+    subsampling.update(150., 1.);
+    CHECK_EQ(subsampling.getFactor(), 4);
+
+    // The same frame rendered with a factor of 4 costs the same
+    subsampling.update(150. / 16., 16.);
+    CHECK_EQ(subsampling.getFactor(), 4);
+}
+
+TEST_CASE("factor_is_bounded")
+{
+    brayns::AdaptiveSubsampling subsampling;
+    subsampling.setTargetTime(10.);
+    subsampling.setMaxFactor(2);
+    subsampling.update(1000., 1.);
+    CHECK_EQ(subsampling.getFactor(), 2);
+
+    subsampling.setMaxFactor(1);
+    CHECK_EQ(subsampling.getFactor(), 1);
+}
+
+TEST_CASE("factor_drops_back_gradually")
+{
+    brayns::AdaptiveSubsampling subsampling;
+    subsampling.setTargetTime(10.);
+    subsampling.setMaxFactor(8);
+    subsampling.update(250., 1.);
+    CHECK_EQ(subsampling.getFactor(), 5);
+
+    // Cheaper scene, e.g. after removing a model
+    subsampling.update(1., 25.);
+    CHECK_GT(subsampling.getFactor(), 1);
+    for (size_t i = 0; i < 50; ++i)
+        subsampling.update(1., subsampling.getFactor() *
+                                   subsampling.getFactor());
+    CHECK_EQ(subsampling.getFactor(), 1);
+}
+
+TEST_CASE("factor_is_stable_close_to_target")
+{
+    brayns::AdaptiveSubsampling subsampling;
+    subsampling.setTargetTime(10.);
+    subsampling.setMaxFactor(8);
+    subsampling.update(35., 1.);
+    REQUIRE_EQ(subsampling.getFactor(), 2);
+
+    // A factor of 1 would take 35ms, a factor of 2 is kept even though the
+    // subsampled frames are well within the target time
+    for (size_t i = 0; i < 50; ++i)
+        subsampling.update(35. / 4., 4.);
+    CHECK_EQ(subsampling.getFactor(), 2);
+}
@@ -31,6 +31,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <future>
+#include <thread>
+
 TEST_CASE("simple_construction")
 {
     const char* argv[] = {"brayns"};
@@ -109,3 +112,76 @@ TEST_CASE("bvh_type")
     CHECK(bvhFlags.count(brayns::BVHFlag::robust) > 0);
     CHECK(bvhFlags.count(brayns::BVHFlag::compact) > 0);
 }
+
+TEST_CASE("variance_threshold_stops_accumulation")
+{
+    const char* argv[] = {"brayns", "demo", "--variance-threshold", "1000"};
+    const int argc = sizeof(argv) / sizeof(char*);
+    brayns::Brayns brayns(argc, argv);
+
+    auto& engine = brayns.getEngine();
+    const auto maxAccumFrames = brayns.getParametersManager()
+                                    .getRenderingParameters()
+                                    .getMaxAccumFrames();
+    size_t frames = 0;
+    do
+    {
+        brayns.commitAndRender();
+        ++frames;
+    } while (engine.continueRendering() && frames < maxAccumFrames);
+
+    CHECK_LT(frames, maxAccumFrames);
+    CHECK(engine.isConverged());
+    CHECK(engine.getStatistics().getConverged());
+}
+
+TEST_CASE("frame_buffer_snapshot")
+{
+    const char* argv[] = {"brayns", "demo"};
+    const int argc = sizeof(argv) / sizeof(char*);
+    brayns::Brayns brayns(argc, argv);
+    brayns.commitAndRender();
+
+    auto& fb = brayns.getEngine().getFrameBuffer();
+    {
+        const auto snapshot = fb.getSnapshot();
+        CHECK(snapshot->colorBuffer);
+        CHECK(snapshot->depthBuffer);
+        CHECK_EQ(snapshot->size, fb.getSize());
+        CHECK_EQ(snapshot->getColorBufferSize(),
+                 fb.getSize().x * fb.getSize().y * fb.getColorDepth());
+
+        // Mapped once for all consumers
+        CHECK_EQ(fb.getSnapshot(), snapshot);
+    }
+    CHECK(!fb.getColorBuffer());
+}
+
+TEST_CASE("frame_buffer_snapshot_without_waiting")
+{
+    const char* argv[] = {"brayns", "demo"};
+    const int argc = sizeof(argv) / sizeof(char*);
+    brayns::Brayns brayns(argc, argv);
+    brayns.commitAndRender();
+
+    auto& fb = brayns.getEngine().getFrameBuffer();
+
+    // Mapped by another thread, like the render thread does for a frame
+    std::promise<void> mapped;
+    std::promise<void> done;
+    std::thread renderer([&] {
+        fb.map();
+        mapped.set_value();
+        done.get_future().wait();
+        fb.unmap();
+    });
+    mapped.get_future().wait();
+    CHECK(!fb.tryGetSnapshot());
+    done.set_value();
+    renderer.join();
+
+    const auto snapshot = fb.tryGetSnapshot();
+    REQUIRE(snapshot);
+    CHECK(snapshot->colorBuffer);
+    CHECK_EQ(fb.getSnapshot(), snapshot);
+}
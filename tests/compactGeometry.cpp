@@ -0,0 +1,179 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/geometry/CompactGeometry.h>
+#include <brayns/engine/Model.h>
+#include <brayns/parameters/AnimationParameters.h>
+#include <brayns/parameters/VolumeParameters.h>
+
+#include <cmath>
+#include <limits>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+namespace
+{
+const brayns::Spheres SPHERES = {{{0.f, 0.f, 0.f}, 1.f, 1},
+                                 {{100.f, 50.f, -20.f}, 0.5f, 2},
+                                 {{-40.f, 10.f, 30.f}, 2.f, 3}};
+
+// Compacts the spheres of all materials on commit, like the OSPRay engine in
+// the compact memory mode
+class TestModel : public brayns::Model
+{
+public:
+    TestModel(brayns::AnimationParameters& animationParameters,
+              brayns::VolumeParameters& volumeParameters)
+        : Model(animationParameters, volumeParameters)
+    {
+    }
+
+    void commitGeometry() final
+    {
+        for (const auto materialId : getSphereMaterialIds())
+            _compactSpheres(materialId);
+    }
+
+    brayns::SharedDataVolumePtr createSharedDataVolume(
+        const brayns::Vector3ui&, const brayns::Vector3f&,
+        const brayns::DataType) const final
+    {
+        return nullptr;
+    }
+
+    brayns::BrickedVolumePtr createBrickedVolume(
+        const brayns::Vector3ui&, const brayns::Vector3f&,
+        const brayns::DataType) const final
+    {
+        return nullptr;
+    }
+
+    void buildBoundingBox() final {}
+
+protected:
+    brayns::MaterialPtr createMaterialImpl(const brayns::PropertyMap&) final
+    {
+        return nullptr;
+    }
+
+private:
+    void _commitTransferFunctionImpl(const brayns::Vector3fs&,
+                                     const brayns::floats&,
+                                     const brayns::Vector2d) final
+    {
+    }
+
+    void _commitSimulationDataImpl(const float*, const size_t) final {}
+};
+}
+
+TEST_CASE("compact_sizes")
+{
+    CHECK_EQ(sizeof(brayns::CompactSphere) * 2, sizeof(brayns::Sphere));
+    CHECK_LT(sizeof(brayns::CompactCylinder), sizeof(brayns::Cylinder));
+    CHECK_EQ(sizeof(brayns::CompactCone) * 2, sizeof(brayns::Cone));
+}
+
+TEST_CASE("compact_spheres")
+{
+    const auto compact = brayns::compactSpheres(SPHERES);
+    REQUIRE_EQ(compact.primitives.size(), SPHERES.size());
+
+    const auto expanded = brayns::expandSpheres(compact);
+    REQUIRE_EQ(expanded.size(), SPHERES.size());
+
+    // one quantization step of the largest extent, plus float rounding
+    const float epsilon = compact.scale;
+    for (size_t i = 0; i < SPHERES.size(); ++i)
+    {
+        CHECK_EQ(expanded[i].userData, SPHERES[i].userData);
+        for (size_t j = 0; j < 3; ++j)
+            CHECK(std::abs(expanded[i].center[j] - SPHERES[i].center[j]) <
+                  epsilon);
+        CHECK_EQ(expanded[i].radius, doctest::Approx(SPHERES[i].radius));
+    }
+}
+
+TEST_CASE("compact_cones")
+{
+    const brayns::Cones cones = {{{0.f, 0.f, 0.f}, {0.f, 10.f, 0.f}, 1.f,
+                                  0.5f, 42},
+                                 {{5.f, 5.f, 5.f}, {6.f, 7.f, 8.f}, 0.25f,
+                                  0.125f, 43}};
+    const auto compact = brayns::compactCones(cones);
+    CHECK_EQ(compact.bounds.getMin(), brayns::Vector3d(0., 0., 0.));
+    CHECK_EQ(compact.bounds.getMax(), brayns::Vector3d(6., 10., 8.));
+
+    const auto expanded = brayns::expandCones(compact);
+    REQUIRE_EQ(expanded.size(), cones.size());
+    for (size_t i = 0; i < cones.size(); ++i)
+    {
+        CHECK_EQ(expanded[i].userData, cones[i].userData);
+        for (size_t j = 0; j < 3; ++j)
+        {
+            CHECK(std::abs(expanded[i].center[j] - cones[i].center[j]) <
+                  compact.scale);
+            CHECK(std::abs(expanded[i].up[j] - cones[i].up[j]) <
+                  compact.scale);
+        }
+        CHECK_EQ(expanded[i].centerRadius, cones[i].centerRadius);
+        CHECK_EQ(expanded[i].upRadius, cones[i].upRadius);
+    }
+}
+
+TEST_CASE("compact_user_data_overflow")
+{
+    const uint64_t userData = uint64_t(std::numeric_limits<uint32_t>::max());
+    const brayns::Spheres spheres = {{{0.f, 0.f, 0.f}, 1.f, userData}};
+    CHECK_EQ(brayns::compactSpheres(spheres).primitives[0].userData,
+             userData);
+
+    const brayns::Spheres overflow = {{{0.f, 0.f, 0.f}, 1.f, userData + 1}};
+    CHECK_THROWS_AS(brayns::compactSpheres(overflow), std::runtime_error);
+
+    const brayns::Cones cones = {
+        {{0.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, 1.f, 0.5f, userData + 1}};
+    CHECK_THROWS_AS(brayns::compactCones(cones), std::runtime_error);
+}
+
+TEST_CASE("compact_model_spheres")
+{
+    brayns::AnimationParameters animationParameters;
+    brayns::VolumeParameters volumeParameters;
+    TestModel model(animationParameters, volumeParameters);
+    const auto& constModel = model;
+    for (const auto& sphere : SPHERES)
+        model.addSphere(0, sphere);
+    CHECK_EQ(constModel.getSpheres().at(0).size(), SPHERES.size());
+
+    // Compact spheres are only readable through the views
+    model.commitGeometry();
+    CHECK_THROWS_AS(constModel.getSpheres(), std::runtime_error);
+    CHECK_EQ(constModel.getSphereMaterialIds(), std::vector<size_t>{0});
+    CHECK_EQ(constModel.getSpheresView(0).size, SPHERES.size());
+
+    // and are expanded again for modification
+    CHECK_EQ(model.getSpheres(0).size(), SPHERES.size());
+    CHECK_EQ(constModel.getSpheres().at(0).size(), SPHERES.size());
+
+    // A material that can not be compacted keeps its full precision spheres
+    model.addSphere(1, {{0.f, 0.f, 0.f}, 1.f, uint64_t(1) << 32});
+    CHECK_THROWS_AS(model.commitGeometry(), std::runtime_error);
+    CHECK_EQ(constModel.getSpheresView(1).size, 1);
+}
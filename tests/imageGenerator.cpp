@@ -0,0 +1,210 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#include <brayns/engine/FrameBuffer.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "../plugins/Rockets/ImageGenerator.h"
+
+#include <algorithm>
+
+namespace
+{
+const uint32_t WIDTH = 300;
+const uint8_t QUALITY = 90;
+
+class TestFrameBuffer : public brayns::FrameBuffer
+{
+public:
+    explicit TestFrameBuffer(const brayns::Vector2ui& size)
+        : brayns::FrameBuffer("test", size, brayns::FrameBufferFormat::rgba_i8)
+    {
+        resize(size);
+    }
+
+    void map() final {}
+    void unmap() final {}
+    const uint8_t* getColorBuffer() const final { return pixels.data(); }
+    const float* getDepthBuffer() const final { return nullptr; }
+    void resize(const brayns::Vector2ui& size) final
+    {
+        _frameSize = size;
+        pixels.resize(size_t(size.x) * size.y * 4);
+        fill(0);
+    }
+
+    // Blocks of 2x2 identical pixels, so that downscaling by 2 only picks
+    // every other pixel
+    void fill(const uint32_t seed)
+    {
+        for (uint32_t y = 0; y < _frameSize.y; ++y)
+            for (uint32_t x = 0; x < _frameSize.x; ++x)
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    const uint32_t bx = x / 2 + seed;
+                    const uint32_t by = y / 2;
+                    pixels[(size_t(y) * _frameSize.x + x) * 4 + c] =
+                        (bx * 7 + by * 13 + c * 50 + (bx * by) % 31) & 0xFF;
+                }
+    }
+
+    std::vector<uint8_t> pixels;
+};
+
+struct Image
+{
+    int width{0};
+    int height{0};
+    std::vector<uint8_t> pixels;
+};
+
+Image decode(const uint8_t* data, const unsigned long size)
+{
+    Image image;
+    tjhandle decompressor = tjInitDecompress();
+    int subsampling = 0;
+    int colorspace = 0;
+    if (tjDecompressHeader3(decompressor, data, size, &image.width,
+                            &image.height, &subsampling, &colorspace) == 0)
+    {
+        image.pixels.resize(size_t(image.width) * image.height * 4);
+        if (tjDecompress2(decompressor, data, size, image.pixels.data(),
+                          image.width, 0, image.height, TJPF_RGBX,
+                          TJFLAG_BOTTOMUP) != 0)
+        {
+            image.pixels.clear();
+        }
+    }
+    tjDestroy(decompressor);
+    return image;
+}
+
+// The frame encoded in one go, with the settings of the image generator
+Image encodeOnce(const std::vector<uint8_t>& pixels, const uint32_t width,
+                 const uint32_t height, const uint8_t quality)
+{
+    tjhandle compressor = tjInitCompress();
+    uint8_t* buffer = nullptr;
+    unsigned long size = 0;
+    REQUIRE_EQ(tjCompress2(compressor, const_cast<uint8_t*>(pixels.data()),
+                           width, width * 4, height, TJPF_RGBX, &buffer, &size,
+                           TJSAMP_444, quality, TJFLAG_BOTTOMUP),
+               0);
+    const auto image = decode(buffer, size);
+    tjFree(buffer);
+    tjDestroy(compressor);
+    return image;
+}
+
+// Only the joined strips have a restart interval
+bool hasRestartInterval(const brayns::ImageGenerator::ImageJPEG& jpeg)
+{
+    const uint8_t dri[] = {0xFF, 0xDD};
+    const auto begin = jpeg.data.get();
+    const auto end = begin + jpeg.size;
+    return std::search(begin, end, dri, dri + 2) != end;
+}
+
+void checkSingleShot(brayns::ImageGenerator& generator,
+                     TestFrameBuffer& frameBuffer, const uint8_t quality)
+{
+    const auto jpeg = generator.createJPEG(frameBuffer, quality);
+    REQUIRE(jpeg.size > 0);
+    CHECK(hasRestartInterval(jpeg));
+
+    const auto image = decode(jpeg.data.get(), jpeg.size);
+    const auto& size = frameBuffer.getSize();
+    const auto expected =
+        encodeOnce(frameBuffer.pixels, size.x, size.y, quality);
+    CHECK_EQ(image.width, expected.width);
+    CHECK_EQ(image.height, expected.height);
+    CHECK(image.pixels == expected.pixels);
+}
+}
+
+TEST_CASE("strips_decode_like_a_single_image")
+{
+    // Heights of whole strips and of a shorter last strip
+    for (const uint32_t height : {128u, 203u, 256u, 301u})
+    {
+        CAPTURE(height);
+        brayns::ImageGenerator generator;
+        // Delta encoding splits the image in strips whatever the cores
+        generator.setDeltaEncoding(true);
+        TestFrameBuffer frameBuffer({WIDTH, height});
+        checkSingleShot(generator, frameBuffer, QUALITY);
+    }
+}
+
+TEST_CASE("downscaled_strips_decode_like_a_single_image")
+{
+    brayns::ImageGenerator generator;
+    generator.setDeltaEncoding(true);
+    TestFrameBuffer frameBuffer({WIDTH, 406});
+
+    const uint32_t downscale = 2;
+    const auto size =
+        brayns::ImageGenerator::getImageSize(frameBuffer.getSize(), downscale);
+    REQUIRE(size == brayns::Vector2ui(WIDTH / 2, 203));
+
+    const auto jpeg = generator.createJPEG(frameBuffer, QUALITY, downscale);
+    REQUIRE(jpeg.size > 0);
+    CHECK(hasRestartInterval(jpeg));
+
+    std::vector<uint8_t> downscaled;
+    for (uint32_t y = 0; y < size.y; ++y)
+        for (uint32_t x = 0; x < size.x; ++x)
+        {
+            const auto pixel =
+                frameBuffer.pixels.begin() + (2 * y * WIDTH + 2 * x) * 4;
+            downscaled.insert(downscaled.end(), pixel, pixel + 4);
+        }
+    const auto expected = encodeOnce(downscaled, size.x, size.y, QUALITY);
+    const auto image = decode(jpeg.data.get(), jpeg.size);
+    CHECK_EQ(image.width, expected.width);
+    CHECK_EQ(image.height, expected.height);
+    CHECK(image.pixels == expected.pixels);
+}
+
+TEST_CASE("delta_strips_follow_frame_changes")
+{
+    brayns::ImageGenerator generator;
+    generator.setDeltaEncoding(true);
+    TestFrameBuffer frameBuffer({WIDTH, 203});
+
+    // An unchanged frame reuses all strips
+    checkSingleShot(generator, frameBuffer, QUALITY);
+    checkSingleShot(generator, frameBuffer, QUALITY);
+
+    // Only the strip of the changed rows is encoded again
+    std::fill(frameBuffer.pixels.begin() + 100 * WIDTH * 4,
+              frameBuffer.pixels.begin() + 110 * WIDTH * 4, 255);
+    checkSingleShot(generator, frameBuffer, QUALITY);
+
+    // Strips of other qualities are kept apart, and the least recently used
+    // are dropped once more qualities than kept are streamed
+    for (uint32_t seed = 1; seed <= 10; ++seed)
+    {
+        CAPTURE(seed);
+        frameBuffer.fill(seed);
+        for (uint8_t quality = 50; quality < 100; quality += 5)
+            checkSingleShot(generator, frameBuffer, quality);
+        checkSingleShot(generator, frameBuffer, QUALITY);
+    }
+}
@@ -0,0 +1,188 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "../plugins/Rockets/ImageStreamSessions.h"
+
+using brayns::ImageStreamSessions;
+
+namespace
+{
+const uint8_t QUALITY = 90;
+const double FPS = 50;
+const double INTERVAL = 1. / FPS;
+
+// Sends every frame that is scheduled and returns the clients which got one
+ImageStreamSessions::ClientIDs sendFrame(ImageStreamSessions& sessions,
+                                         const double now)
+{
+    ImageStreamSessions::ClientIDs all;
+    for (const auto& i : sessions.schedule(now, true, QUALITY, FPS))
+    {
+        sessions.sent(i.second, now);
+        all.insert(i.second.begin(), i.second.end());
+    }
+    return all;
+}
+}
+
+TEST_CASE("clients_without_acknowledgment_use_application_settings")
+{
+    ImageStreamSessions sessions;
+    sessions.addClient(1);
+
+    const auto clients = sessions.schedule(0, true, QUALITY, FPS);
+    REQUIRE_EQ(clients.size(), 1);
+    CHECK_EQ(clients.begin()->first.quality, QUALITY);
+    CHECK_EQ(clients.begin()->first.downscale, 1);
+    sessions.sent(clients.begin()->second, 0);
+
+    // only for new frames, and limited to the stream FPS
+    CHECK(sessions.schedule(INTERVAL, false, QUALITY, FPS).empty());
+    CHECK(sendFrame(sessions, INTERVAL / 2).empty());
+    CHECK_EQ(sendFrame(sessions, INTERVAL).count(1), 1);
+}
+
+TEST_CASE("stale_frames_are_dropped_and_latest_is_sent_later")
+{
+    ImageStreamSessions sessions;
+    sessions.addClient(1);
+    sessions.acknowledge(1, 0);
+
+    double now = 0;
+    CHECK_EQ(sendFrame(sessions, now).size(), 1);
+    now += INTERVAL;
+    CHECK_EQ(sendFrame(sessions, now).size(), 1);
+
+    // two images in flight, no new ones until the client catches up
+    now += INTERVAL;
+    CHECK(sendFrame(sessions, now).empty());
+
+    sessions.acknowledge(1, now);
+    CHECK_EQ(sessions.schedule(now, false, QUALITY, FPS).size(), 1);
+}
+
+TEST_CASE("dropped_frame_is_sent_once_rendering_stopped")
+{
+    ImageStreamSessions sessions;
+    sessions.addClient(1);
+    sessions.addClient(2);
+    sessions.acknowledge(1, 0);
+
+    // the last frames before convergence: one is dropped for client 1, the
+    // stream FPS delays the last one for client 2
+    double now = 0;
+    sendFrame(sessions, now);
+    now += INTERVAL;
+    sendFrame(sessions, now);
+    now += INTERVAL / 2;
+    CHECK(sendFrame(sessions, now).empty());
+    CHECK(sessions.hasStaleClients());
+
+    // no frame is rendered anymore
+    now += INTERVAL;
+    auto clients = sessions.schedule(now, false, QUALITY, FPS);
+    REQUIRE_EQ(clients.size(), 1);
+    CHECK_EQ(clients.begin()->second, ImageStreamSessions::ClientIDs{2});
+    sessions.sent(clients.begin()->second, now);
+    CHECK(sessions.hasStaleClients());
+
+    // client 1 never acknowledges, its images time out eventually
+    now += 3;
+    clients = sessions.schedule(now, false, QUALITY, FPS);
+    REQUIRE_EQ(clients.size(), 1);
+    CHECK_EQ(clients.begin()->second, ImageStreamSessions::ClientIDs{1});
+    sessions.sent(clients.begin()->second, now);
+    CHECK_FALSE(sessions.hasStaleClients());
+    CHECK(sessions.schedule(now + 1, false, QUALITY, FPS).empty());
+}
+
+TEST_CASE("image_size_is_reported_when_it_changes")
+{
+    ImageStreamSessions sessions;
+    sessions.addClient(1);
+    sessions.addClient(2);
+
+    const ImageStreamSessions::ClientIDs both{1, 2};
+    CHECK_EQ(sessions.resized(both, 800, 600), both);
+    CHECK(sessions.resized(both, 800, 600).empty());
+    CHECK_EQ(sessions.resized({2}, 400, 300),
+             ImageStreamSessions::ClientIDs{2});
+    CHECK(sessions.resized({1}, 800, 600).empty());
+}
+
+TEST_CASE("slow_client_does_not_slow_down_others")
+{
+    ImageStreamSessions sessions;
+    sessions.addClient(1);
+    sessions.addClient(2);
+    sessions.acknowledge(1, 0);
+    sessions.acknowledge(2, 0);
+
+    // client 1 acknowledges immediately, client 2 queues up images
+    double now = 0;
+    double slowAck = 0;
+    for (size_t frame = 0; frame < 1000; ++frame, now += INTERVAL)
+    {
+        const auto clients = sendFrame(sessions, now);
+        if (clients.count(1))
+            sessions.acknowledge(1, now + 0.001);
+        if (clients.count(2))
+        {
+            slowAck = std::max(slowAck, now) + 0.2;
+            sessions.acknowledge(2, slowAck);
+        }
+    }
+
+    CHECK_EQ(sessions.getSettings(1).quality, QUALITY);
+    CHECK_EQ(sessions.getSettings(1).downscale, 1);
+    CHECK_EQ(sessions.getFPS(1), doctest::Approx(FPS));
+
+    const auto slow = sessions.getSettings(2);
+    CHECK_LT(slow.quality, QUALITY);
+    CHECK_GT(slow.downscale, 1);
+    CHECK_LT(sessions.getFPS(2), FPS);
+}
+
+TEST_CASE("client_recovers_when_connection_improves")
+{
+    ImageStreamSessions sessions;
+    sessions.addClient(1);
+    sessions.acknowledge(1, 0);
+
+    double now = 0;
+    double ack = 0;
+    for (size_t frame = 0; frame < 500; ++frame, now += INTERVAL)
+    {
+        if (!sendFrame(sessions, now).empty())
+        {
+            ack = std::max(ack, now) + 0.2;
+            sessions.acknowledge(1, ack);
+        }
+    }
+    CHECK_LT(sessions.getSettings(1).quality, QUALITY);
+
+    for (size_t frame = 0; frame < 5000; ++frame, now += INTERVAL)
+        if (!sendFrame(sessions, now).empty())
+            sessions.acknowledge(1, now + 0.001);
+
+    CHECK_EQ(sessions.getSettings(1).quality, QUALITY);
+    CHECK_EQ(sessions.getSettings(1).downscale, 1);
+}
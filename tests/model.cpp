@@ -25,6 +25,10 @@
 
 #include "ClientServer.h"
 
+#include <brayns/engine/FrameBuffer.h>
+
+#include <algorithm>
+
 const std::string GET_INSTANCES("get-instances");
 const std::string REMOVE_MODEL("remove-model");
 const std::string UPDATE_INSTANCE("update-instance");
@@ -33,6 +37,21 @@ const std::string SET_PROPERTIES("set-model-properties");
 const std::string GET_PROPERTIES("get-model-properties");
 const std::string MODEL_PROPERTIES_SCHEMA("model-properties-schema");
 
+namespace
+{
+bool isBackgroundOnly(brayns::FrameBuffer& frameBuffer)
+{
+    const auto snapshot = frameBuffer.getSnapshot();
+    const auto pixels =
+        reinterpret_cast<const uint32_t*>(snapshot->colorBuffer);
+    const size_t nbPixels = size_t(snapshot->size.x) * snapshot->size.y;
+    return std::all_of(pixels, pixels + nbPixels,
+                       [background = pixels[0]](const uint32_t pixel) {
+                           return pixel == background;
+                       });
+}
+}
+
 TEST_CASE_FIXTURE(ClientServer, "set_properties")
 {
     auto model = getScene().getModel(0);
@@ -95,6 +114,40 @@ TEST_CASE_FIXTURE(ClientServer, "update_model")
     CHECK(model->getBoundingBox()); // shall remain untouched
 }
 
+TEST_CASE_FIXTURE(ClientServer, "update_model_is_rendered")
+{
+    auto model = getScene().getModel(0);
+    commitAndRender();
+    REQUIRE(!isBackgroundOnly(getFrameBuffer()));
+
+    using namespace rapidjson;
+    Document json(kObjectType);
+    json.AddMember("id", uint32_t(model->getModelID()), json.GetAllocator());
+    json.AddMember("visible", false, json.GetAllocator());
+    StringBuffer buffer;
+    PrettyWriter<StringBuffer> writer(buffer);
+    json.Accept(writer);
+
+    CHECK((makeRequest<bool>(UPDATE_MODEL, buffer.GetString())));
+
+    commitAndRender();
+    CHECK(isBackgroundOnly(getFrameBuffer()));
+}
+
+TEST_CASE_FIXTURE(ClientServer, "update_instance_is_rendered")
+{
+    auto model = getScene().getModel(0);
+    commitAndRender();
+    REQUIRE(!isBackgroundOnly(getFrameBuffer()));
+
+    auto instance = model->getInstances()[0];
+    instance.setVisible(false);
+    CHECK(makeRequest<brayns::ModelInstance, bool>(UPDATE_INSTANCE, instance));
+
+    commitAndRender();
+    CHECK(isBackgroundOnly(getFrameBuffer()));
+}
+
 TEST_CASE_FIXTURE(ClientServer, "instances")
 {
     auto model = getScene().getModel(0);
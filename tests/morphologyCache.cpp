@@ -0,0 +1,219 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <plugin/io/MorphologyCache.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+const std::string PARAMETERS = "parameters";
+
+// A cache folder and a morphology file, removed at the end of the test
+struct CacheFolder
+{
+    CacheFolder()
+        : folder(fs::temp_directory_path() /
+                 fs::unique_path("brayns-morphology-cache-%%%%-%%%%"))
+        , morphology((folder / "morphology.h5").string())
+    {
+        fs::create_directories(folder);
+        std::ofstream file(morphology);
+        file << "morphology";
+    }
+
+    ~CacheFolder()
+    {
+        boost::system::error_code error;
+        fs::remove_all(folder, error);
+    }
+
+    std::string cacheFolder() const { return (folder / "cache").string(); }
+
+    std::string cacheFile(const std::string& key) const
+    {
+        return (folder / "cache" / (key + ".morphology")).string();
+    }
+
+    const fs::path folder;
+    const std::string morphology;
+};
+
+ParallelModelContainer createContainer()
+{
+    ParallelModelContainer container;
+    container.morphologyInfo.somaPosition = {1., 2., 3.};
+    container.morphologyInfo.bounds =
+        brayns::Boxd(brayns::Vector3d(-1., -2., -3.),
+                     brayns::Vector3d(4., 5., 6.));
+    container.morphologyInfo.maxDistanceToSoma = 42.f;
+    container.addSphere(0, {{1.f, 2.f, 3.f}, 0.5f, 7});
+    container.addSphere(2, {{4.f, 5.f, 6.f}, 1.5f, 8});
+    container.addCylinder(1, {{0.f, 0.f, 0.f}, {0.f, 1.f, 0.f}, 0.25f, 9});
+    container.addCone(3, {{0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}, 0.5f, 0.1f, 10});
+    container.addSDFGeometry(4,
+                             brayns::createSDFSphere({1.f, 1.f, 1.f}, 2.f, 11),
+                             {});
+    container.addSDFGeometry(4,
+                             brayns::createSDFPill({0.f, 0.f, 0.f},
+                                                   {0.f, 0.f, 1.f}, 0.5f, 12),
+                             {0});
+    return container;
+}
+
+void checkContainer(const ParallelModelContainer& container)
+{
+    const auto expected = createContainer();
+    const auto& info = container.morphologyInfo;
+    CHECK_EQ(info.somaPosition, expected.morphologyInfo.somaPosition);
+    CHECK_EQ(info.bounds.getMin(), expected.morphologyInfo.bounds.getMin());
+    CHECK_EQ(info.bounds.getMax(), expected.morphologyInfo.bounds.getMax());
+    CHECK_EQ(info.maxDistanceToSoma,
+             expected.morphologyInfo.maxDistanceToSoma);
+
+    REQUIRE_EQ(container.spheres.size(), expected.spheres.size());
+    for (const auto& spheres : expected.spheres)
+    {
+        const auto& actual = container.spheres.at(spheres.first);
+        REQUIRE_EQ(actual.size(), spheres.second.size());
+        for (size_t i = 0; i < actual.size(); ++i)
+        {
+            CHECK_EQ(actual[i].center, spheres.second[i].center);
+            CHECK_EQ(actual[i].radius, spheres.second[i].radius);
+            CHECK_EQ(actual[i].userData, spheres.second[i].userData);
+        }
+    }
+
+    REQUIRE_EQ(container.cylinders.size(), 1u);
+    const auto& cylinder = container.cylinders.at(1).at(0);
+    CHECK_EQ(cylinder.up, brayns::Vector3f(0.f, 1.f, 0.f));
+    CHECK_EQ(cylinder.radius, 0.25f);
+    CHECK_EQ(cylinder.userData, 9u);
+
+    REQUIRE_EQ(container.cones.size(), 1u);
+    const auto& cone = container.cones.at(3).at(0);
+    CHECK_EQ(cone.up, brayns::Vector3f(1.f, 0.f, 0.f));
+    CHECK_EQ(cone.centerRadius, 0.5f);
+    CHECK_EQ(cone.upRadius, 0.1f);
+    CHECK_EQ(cone.userData, 10u);
+
+    CHECK_EQ(container.sdfMaterials, expected.sdfMaterials);
+    CHECK_EQ(container.sdfNeighbours, expected.sdfNeighbours);
+    REQUIRE_EQ(container.sdfGeometries.size(), 2u);
+    for (size_t i = 0; i < 2; ++i)
+    {
+        const auto& actual = container.sdfGeometries[i];
+        const auto& geometry = expected.sdfGeometries[i];
+        CHECK_EQ(actual.center, geometry.center);
+        CHECK_EQ(actual.p0, geometry.p0);
+        CHECK_EQ(actual.p1, geometry.p1);
+        CHECK_EQ(actual.radius, geometry.radius);
+        CHECK_EQ(actual.userData, geometry.userData);
+        CHECK(actual.type == geometry.type);
+    }
+}
+}
+
+TEST_CASE("cached_morphology_is_read_back_from_disk")
+{
+    CacheFolder folder;
+    const auto key = MorphologyCache::getKey(folder.morphology, PARAMETERS);
+
+    MorphologyCache(folder.cacheFolder()).put(key, createContainer());
+    CHECK(fs::exists(folder.cacheFile(key)));
+
+    // A new cache has nothing in memory and reads the entry from disk
+    MorphologyCache cache(folder.cacheFolder());
+    ParallelModelContainer container;
+    REQUIRE(cache.get(key, container));
+    checkContainer(container);
+}
+
+TEST_CASE("modified_morphology_misses_the_cache")
+{
+    CacheFolder folder;
+    const auto key = MorphologyCache::getKey(folder.morphology, PARAMETERS);
+    MorphologyCache(folder.cacheFolder()).put(key, createContainer());
+
+    SUBCASE("modification time")
+    {
+        const auto time = fs::last_write_time(folder.morphology);
+        fs::last_write_time(folder.morphology, time - 60);
+    }
+    SUBCASE("size")
+    {
+        std::ofstream file(folder.morphology, std::ios::app);
+        file << "modified";
+    }
+
+    const auto newKey = MorphologyCache::getKey(folder.morphology, PARAMETERS);
+    CHECK_NE(newKey, key);
+
+    MorphologyCache cache(folder.cacheFolder());
+    ParallelModelContainer container;
+    CHECK_FALSE(cache.get(newKey, container));
+}
+
+TEST_CASE("other_parameters_miss_the_cache")
+{
+    CacheFolder folder;
+    CHECK_NE(MorphologyCache::getKey(folder.morphology, PARAMETERS),
+             MorphologyCache::getKey(folder.morphology, PARAMETERS + ";1"));
+}
+
+TEST_CASE("cache_file_of_another_version_is_ignored")
+{
+    CacheFolder folder;
+    const auto key = MorphologyCache::getKey(folder.morphology, PARAMETERS);
+    MorphologyCache(folder.cacheFolder()).put(key, createContainer());
+
+    {
+        std::fstream file(folder.cacheFile(key),
+                          std::ios::in | std::ios::out | std::ios::binary);
+        const size_t version = 0;
+        file.write((const char*)&version, sizeof(version));
+    }
+
+    MorphologyCache cache(folder.cacheFolder());
+    ParallelModelContainer container;
+    CHECK_FALSE(cache.get(key, container));
+}
+
+TEST_CASE("least_recently_used_entries_leave_memory")
+{
+    // Without a folder, entries only live in memory
+    MorphologyCache cache("", 2);
+    cache.put("a", createContainer());
+    cache.put("b", createContainer());
+
+    ParallelModelContainer container;
+    CHECK(cache.get("a", container));
+    cache.put("c", createContainer());
+
+    CHECK(cache.get("a", container));
+    CHECK_FALSE(cache.get("b", container));
+    CHECK(cache.get("c", container));
+    checkContainer(container);
+}
@@ -0,0 +1,98 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/Timer.h>
+#include <brayns/engine/Camera.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Renderer.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+#include <iostream>
+
+namespace
+{
+const size_t GRID_SIZE = 20;
+const size_t NB_FRAMES = 10;
+
+void addSphereGrid(brayns::Scene& scene)
+{
+    auto model = scene.createModel();
+    model->createMaterial(0, "Spheres");
+    for (size_t z = 0; z < GRID_SIZE; ++z)
+        for (size_t y = 0; y < GRID_SIZE; ++y)
+            for (size_t x = 0; x < GRID_SIZE; ++x)
+                model->addSphere(0, {{float(x), float(y), float(z)}, 0.4f});
+    scene.addModel(
+        std::make_shared<brayns::ModelDescriptor>(std::move(model), "Grid"));
+}
+
+int64_t timeFrames(brayns::Brayns& brayns)
+{
+    brayns.commit();
+    brayns::Timer timer;
+    timer.start();
+    for (size_t i = 0; i < NB_FRAMES; ++i)
+        brayns.render();
+    timer.stop();
+    return timer.milliseconds() / NB_FRAMES;
+}
+} // namespace
+
+TEST_CASE("advanced_simulation_shadows_and_gi_benchmark")
+{
+    const char* argv[] = {"advancedSimulationShading", "--window-size", "800",
+                          "600", "--disable-accumulation", "--plugin",
+                          "braynsCircuitExplorer"};
+    brayns::Brayns brayns(7, argv);
+    brayns.getParametersManager().getRenderingParameters().setCurrentRenderer(
+        "advanced_simulation");
+    addSphereGrid(brayns.getEngine().getScene());
+
+    auto& camera = brayns.getEngine().getCamera();
+    camera.setPosition({0.5 * GRID_SIZE, 0.5 * GRID_SIZE, 2.5 * GRID_SIZE});
+
+    auto& renderer = brayns.getEngine().getRenderer();
+    const auto reference = timeFrames(brayns);
+
+    renderer.updateProperty("shadows", 1.);
+    const auto shadows = timeFrames(brayns);
+
+    renderer.updateProperty("softShadows", 1.);
+    const auto softShadows = timeFrames(brayns);
+
+    renderer.updateProperty("shadows", 0.);
+    renderer.updateProperty("softShadows", 0.);
+    renderer.updateProperty("giSamples", 4);
+    const auto globalIllumination = timeFrames(brayns);
+
+    renderer.updateProperty("shadows", 1.);
+    renderer.updateProperty("softShadows", 1.);
+    const auto allOptions = timeFrames(brayns);
+
+    std::cout << "advanced_simulation per frame: reference " << reference
+              << " ms, shadows " << shadows << " ms, soft shadows "
+              << softShadows << " ms, gi " << globalIllumination
+              << " ms, all " << allOptions << " ms" << std::endl;
+}
@@ -0,0 +1,117 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/Timer.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+#include "../../plugins/Rockets/DepthCompressor.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+// Overlapping spheres in front of an infinite background, in the bottom-up row
+// order of the frame buffers
+std::vector<float> createDepth(const uint32_t width, const uint32_t height)
+{
+    std::vector<float> depth(width * height,
+                             std::numeric_limits<float>::infinity());
+    const size_t numSpheres = 50;
+    for (size_t i = 0; i < numSpheres; ++i)
+    {
+        const float cx = (i * 397) % width;
+        const float cy = (i * 211) % height;
+        const float radius = height * (0.05f + 0.1f * (i % 5) / 4);
+        const float distance = 10.f + i;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const float dx = x - cx;
+                const float dy = y - cy;
+                const float h = radius * radius - dx * dx - dy * dy;
+                if (h <= 0)
+                    continue;
+                auto& value = depth[y * width + x];
+                value = std::min(value, distance - std::sqrt(h) / radius);
+            }
+        }
+    }
+    return depth;
+}
+} // namespace
+
+TEST_CASE("depth_compression_size_and_time")
+{
+    const size_t numFrames = 10;
+    brayns::DepthCompressor compressor;
+    for (const auto& size : {std::make_pair(640u, 480u),
+                            std::make_pair(1920u, 1080u),
+                            std::make_pair(3840u, 2160u)})
+    {
+        const auto width = size.first;
+        const auto height = size.second;
+        const auto depth = createDepth(width, height);
+
+        brayns::Timer timer;
+        timer.start();
+        for (size_t i = 0; i < numFrames; ++i)
+            compressor.compress(depth.data(), width, height);
+        timer.stop();
+
+        const auto& compressed = compressor.compress(depth.data(), width,
+                                                     height);
+        std::vector<uint16_t> values;
+        REQUIRE(brayns::DepthCompressor::decompress(compressed.data.data(),
+                                                    compressed.data.size(),
+                                                    width, height, values));
+
+        // the quantization step bounds the error of the decompressed depth
+        const float step = (compressed.far - compressed.near) /
+                           (brayns::DepthCompressor::BACKGROUND - 1);
+        size_t errors = 0;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const float expected = depth[(height - 1 - y) * width + x];
+                const float actual = brayns::DepthCompressor::toDepth(
+                    values[y * width + x], compressed.near, compressed.far);
+                if (std::isinf(expected) ? !std::isinf(actual)
+                                         : std::abs(actual - expected) > step)
+                {
+                    ++errors;
+                }
+            }
+        }
+        CHECK_EQ(errors, 0);
+
+        const size_t rawSize = width * height * sizeof(float);
+        std::cout << width << "x" << height << ": "
+                  << compressed.data.size() << " bytes/frame ("
+                  << float(rawSize) / compressed.data.size()
+                  << "x smaller), "
+                  << timer.milliseconds() / float(numFrames) << " ms/frame"
+                  << std::endl;
+        CHECK_LT(compressed.data.size(), rawSize / 4);
+    }
+}
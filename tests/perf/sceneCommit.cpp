@@ -0,0 +1,96 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/Timer.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+#include <iostream>
+
+namespace
+{
+brayns::size_ts addSphereModels(brayns::Scene& scene, const size_t numModels)
+{
+    brayns::size_ts ids;
+    for (size_t i = 0; i < numModels; ++i)
+    {
+        auto model = scene.createModel();
+        model->createMaterial(0, "sphere");
+        model->addSphere(0, {{float(i), 0.f, 0.f}, 0.5f});
+        ids.push_back(scene.addModel(std::make_shared<brayns::ModelDescriptor>(
+            std::move(model), "sphere" + std::to_string(i))));
+    }
+    return ids;
+}
+
+int64_t timeCommit(brayns::Scene& scene)
+{
+    brayns::Timer timer;
+    timer.start();
+    scene.commit();
+    timer.stop();
+    scene.resetModified();
+    return timer.microseconds();
+}
+} // namespace
+
+TEST_CASE("commit_latency_versus_number_of_models")
+{
+    for (const size_t numModels : {10, 100, 1000, 5000})
+    {
+        const char* argv[] = {"sceneCommit"};
+        brayns::Brayns brayns(1, argv);
+        auto& scene = brayns.getEngine().getScene();
+        const auto ids = addSphereModels(scene, numModels);
+
+        const auto initialCommit = timeCommit(scene);
+
+        // toggle visibility of one model
+        auto hiddenModel = scene.getModel(ids[numModels / 2]);
+        hiddenModel->setVisible(false);
+        scene.markModified();
+        const auto visibilityCommit = timeCommit(scene);
+        CHECK(!hiddenModel->isModified());
+
+        // move one instance of another model
+        auto movedModel = scene.getModel(ids.front());
+        movedModel->addInstance({true, false, {}});
+        timeCommit(scene);
+        brayns::Transformation transformation;
+        transformation.setTranslation({0, 1, 0});
+        movedModel->getInstance(1)->setTransformation(transformation);
+        movedModel->getModel().markInstancesDirty();
+        scene.markModified(false);
+        const auto instanceCommit = timeCommit(scene);
+        CHECK(!movedModel->areInstancesModified());
+
+        // nothing changed
+        const auto noopCommit = timeCommit(scene);
+
+        std::cout << numModels << " models: initial " << initialCommit
+                  << " us, visibility " << visibilityCommit
+                  << " us, instance " << instanceCommit << " us, no-op "
+                  << noopCommit << " us" << std::endl;
+    }
+}
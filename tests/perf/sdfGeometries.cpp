@@ -0,0 +1,157 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/Timer.h>
+#include <brayns/common/geometry/SDFGeometry.h>
+#include <brayns/engine/Camera.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+const size_t NB_CELLS = 8; // per side of the circuit
+const size_t NB_DENDRITES = 6;
+const size_t NB_SEGMENTS = 20;
+const float CELL_SPACING = 60.f;
+const float SEGMENT_LENGTH = 2.f;
+const float SOMA_RADIUS = 5.f;
+const float DENDRITE_RADIUS = 1.5f;
+const size_t NB_FRAMES = 10;
+
+/**
+ * Adds a circuit of cells made of a soma and wiggling dendrites of
+ * NB_SEGMENTS tapered segments, either as blended SDF geometries like the
+ * circuit loaders produce them or as spheres and cones.
+ */
+void addCircuit(brayns::Scene& scene, const bool useSDF)
+{
+    auto model = scene.createModel();
+    model->createMaterial(0, "Circuit");
+
+    std::vector<std::vector<size_t>> neighbours;
+    const auto addGeometry = [&](const brayns::SDFGeometry& geometry,
+                                 const size_t parent) {
+        const auto index = model->addSDFGeometry(0, geometry, {});
+        neighbours.push_back({parent});
+        neighbours[parent].push_back(index);
+        return index;
+    };
+
+    for (size_t cell = 0; cell < NB_CELLS * NB_CELLS; ++cell)
+    {
+        const brayns::Vector3f soma(CELL_SPACING * (cell % NB_CELLS),
+                                    CELL_SPACING * (cell / NB_CELLS), 0.f);
+        size_t somaIndex = 0;
+        if (useSDF)
+        {
+            somaIndex = model->addSDFGeometry(
+                0, brayns::createSDFSphere(soma, SOMA_RADIUS), {});
+            neighbours.push_back({});
+        }
+        else
+            model->addSphere(0, {soma, SOMA_RADIUS});
+
+        for (size_t dendrite = 0; dendrite < NB_DENDRITES; ++dendrite)
+        {
+            const float phi = 2.f * M_PI * (dendrite + 0.1f * cell) /
+                              NB_DENDRITES;
+            brayns::Vector3f direction(std::cos(phi), std::sin(phi),
+                                       0.5f - (dendrite % 2));
+            brayns::Vector3f p0 =
+                soma + glm::normalize(direction) * SOMA_RADIUS * 0.8f;
+            float r0 = DENDRITE_RADIUS;
+            size_t parent = somaIndex;
+
+            for (size_t segment = 0; segment < NB_SEGMENTS; ++segment)
+            {
+                const float angle = phi + 0.7f * segment;
+                direction = glm::normalize(
+                    direction +
+                    0.4f * brayns::Vector3f(std::sin(angle), std::cos(angle),
+                                            std::sin(1.3f * angle)));
+                const brayns::Vector3f p1 = p0 + direction * SEGMENT_LENGTH;
+                const float r1 = r0 * 0.95f;
+
+                if (useSDF)
+                    parent = addGeometry(brayns::createSDFConePillSigmoid(
+                                             p0, p1, r0, r1),
+                                         parent);
+                else
+                {
+                    model->addCone(0, {p0, p1, r0, r1});
+                    model->addSphere(0, {p1, r1});
+                }
+                p0 = p1;
+                r0 = r1;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < neighbours.size(); ++i)
+        model->updateSDFGeometryNeighbours(i, neighbours[i]);
+
+    scene.addModel(
+        std::make_shared<brayns::ModelDescriptor>(std::move(model),
+                                                  "Circuit"));
+}
+
+int64_t timeCircuit(const bool useSDF, const char* maxSteps)
+{
+    const char* argv[] = {"sdfGeometries",
+                          "--window-size",
+                          "800",
+                          "600",
+                          "--disable-accumulation",
+                          "--sdf-max-steps",
+                          maxSteps};
+    brayns::Brayns brayns(7, argv);
+    addCircuit(brayns.getEngine().getScene(), useSDF);
+
+    auto& camera = brayns.getEngine().getCamera();
+    const double center = 0.5 * CELL_SPACING * NB_CELLS;
+    camera.setPosition({center, center, 2.5 * center});
+
+    brayns.commit();
+    brayns::Timer timer;
+    timer.start();
+    for (size_t i = 0; i < NB_FRAMES; ++i)
+        brayns.render();
+    timer.stop();
+    return timer.milliseconds() / NB_FRAMES;
+}
+} // namespace
+
+TEST_CASE("sdf_circuit_benchmark")
+{
+    const auto cones = timeCircuit(false, "100");
+    const auto sdf = timeCircuit(true, "100");
+    const auto sdfLowBudget = timeCircuit(true, "32");
+
+    std::cout << "Circuit per frame: cones " << cones << " ms, sdf " << sdf
+              << " ms, sdf with 32 steps " << sdfLowBudget << " ms"
+              << std::endl;
+}
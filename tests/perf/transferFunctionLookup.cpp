@@ -0,0 +1,150 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/Timer.h>
+#include <brayns/common/transferFunction/TransferFunction.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../doctest.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+
+namespace
+{
+const size_t NB_SAMPLES = 10000000;
+const size_t LOOKUP_SIZE = 1024;
+const brayns::Vector2f VALUE_RANGE{-80.f, -10.f};
+
+// The two paths of getSimulationValue() are timed through C++ stand-ins, not
+// through the ISPC renderer: the numbers only compare these proxies. The
+// compiler may also devirtualize the evaluator below, which the ISPC function
+// pointers of the transfer function cannot be.
+
+// Per-sample evaluation behind a virtual interface, as done by the OSPRay
+// piecewise linear transfer function
+class Evaluator
+{
+public:
+    virtual ~Evaluator() = default;
+    virtual brayns::Vector3f getColorForValue(float value) const = 0;
+    virtual float getOpacityForValue(float value) const = 0;
+};
+
+class LinearEvaluator : public Evaluator
+{
+public:
+    LinearEvaluator(const brayns::Vector3fs& colors,
+                    const brayns::floats& opacities)
+        : _colors(colors)
+        , _opacities(opacities)
+    {
+    }
+
+    brayns::Vector3f getColorForValue(const float value) const final
+    {
+        return _interpolate(_colors, value);
+    }
+
+    float getOpacityForValue(const float value) const final
+    {
+        return _interpolate(_opacities, value);
+    }
+
+private:
+    template <typename T>
+    static T _interpolate(const std::vector<T>& values, const float value)
+    {
+        const float x =
+            std::min(std::max((value - VALUE_RANGE.x) /
+                                  (VALUE_RANGE.y - VALUE_RANGE.x),
+                              0.f),
+                     1.f);
+        const float position = x * (values.size() - 1);
+        const size_t index = std::min(size_t(position), values.size() - 2);
+        const float t = position - index;
+        return values[index] * (1.f - t) + values[index + 1] * t;
+    }
+
+    const brayns::Vector3fs _colors;
+    const brayns::floats _opacities;
+};
+} // namespace
+
+TEST_CASE("baked_transfer_function_versus_evaluation")
+{
+    brayns::TransferFunction transferFunction;
+    transferFunction.setColorMap(
+        {"test", {{0, 0, 1}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}}});
+    transferFunction.setControlPoints({{0, 0}, {0.4, 0.1}, {1, 1}});
+    const auto& colors = transferFunction.getColors();
+    const auto opacities = transferFunction.calculateInterpolatedOpacities();
+
+    const std::unique_ptr<Evaluator> evaluator(
+        new LinearEvaluator(colors, opacities));
+    const auto lookupTable = brayns::TransferFunction::calculateLookupTable(
+        colors, opacities, LOOKUP_SIZE);
+    REQUIRE_EQ(lookupTable.size(), LOOKUP_SIZE);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<float> distribution(-90.f, 0.f);
+    brayns::floats values(NB_SAMPLES);
+    for (auto& value : values)
+        value = distribution(generator);
+
+    brayns::Vector4fs evaluated(NB_SAMPLES);
+    brayns::Timer timer;
+    timer.start();
+    for (size_t i = 0; i < NB_SAMPLES; ++i)
+        evaluated[i] = {evaluator->getColorForValue(values[i]),
+                        evaluator->getOpacityForValue(values[i])};
+    timer.stop();
+    const auto evaluation = timer.microseconds();
+
+    brayns::Vector4fs looked(NB_SAMPLES);
+    const float scale = (LOOKUP_SIZE - 1) / (VALUE_RANGE.y - VALUE_RANGE.x);
+    const float offset = -VALUE_RANGE.x * scale;
+    timer.start();
+    for (size_t i = 0; i < NB_SAMPLES; ++i)
+    {
+        const float position =
+            std::min(std::max(values[i] * scale + offset, 0.f),
+                     float(LOOKUP_SIZE - 1));
+        looked[i] = lookupTable[size_t(position + 0.5f)];
+    }
+    timer.stop();
+    const auto lookup = timer.microseconds();
+
+    // Nearest entry of the table is within half an entry of the exact value
+    float maxError = 0.f;
+    for (size_t i = 0; i < NB_SAMPLES; ++i)
+    {
+        const auto difference = glm::abs(evaluated[i] - looked[i]);
+        maxError = std::max(maxError, glm::compMax(difference));
+    }
+    CHECK(maxError < 0.01f);
+
+    // Samples per microsecond, i.e. millions of samples per second
+    std::cout << "Transfer function (C++ proxies): evaluation "
+              << NB_SAMPLES / double(std::max(evaluation, int64_t(1)))
+              << " M samples/s, lookup table "
+              << NB_SAMPLES / double(std::max(lookup, int64_t(1)))
+              << " M samples/s" << std::endl;
+}
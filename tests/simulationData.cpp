@@ -0,0 +1,92 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/Brayns.h>
+
+#include <brayns/common/simulation/AbstractSimulationHandler.h>
+#include <brayns/engine/Engine.h>
+#include <brayns/engine/Model.h>
+#include <brayns/engine/Scene.h>
+#include <brayns/parameters/AnimationParameters.h>
+#include <brayns/parameters/ParametersManager.h>
+
+#include <engines/ospray/OSPRayModel.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <algorithm>
+
+namespace
+{
+const uint32_t NB_FRAMES = 10;
+const uint64_t FRAME_SIZE = 3;
+
+class TestSimulationHandler : public brayns::AbstractSimulationHandler
+{
+public:
+    TestSimulationHandler()
+    {
+        _nbFrames = NB_FRAMES;
+        _frameSize = FRAME_SIZE;
+        _setFrameLoader([](const uint32_t frame, brayns::floats& buffer) {
+            std::fill(buffer.begin(), buffer.end(), float(frame));
+        });
+    }
+
+    brayns::AbstractSimulationHandlerPtr clone() const final
+    {
+        return std::make_shared<TestSimulationHandler>(*this);
+    }
+
+    void* getFrameData(const uint32_t frame) final
+    {
+        return _getPrefetchedFrameData(_getBoundedFrame(frame), true);
+    }
+};
+} // namespace
+
+TEST_CASE("simulation_data_is_reused_across_frames")
+{
+    const char* argv[] = {"simulationData"};
+    brayns::Brayns brayns(1, argv);
+    auto& scene = brayns.getEngine().getScene();
+
+    auto model = scene.createModel();
+    model->createMaterial(0, "sphere");
+    model->addSphere(0, {{0.f, 0.f, 0.f}, 1.f});
+    auto handler = std::make_shared<TestSimulationHandler>();
+    model->setSimulationHandler(handler);
+    const auto& ospModel = static_cast<const brayns::OSPRayModel&>(*model);
+    scene.addModel(std::make_shared<brayns::ModelDescriptor>(std::move(model),
+                                                             "simulation"));
+    scene.commit();
+
+    auto& animation = brayns.getParametersManager().getAnimationParameters();
+    for (uint32_t frame = 1; frame <= 3 * NB_FRAMES; ++frame)
+    {
+        animation.setFrame(frame % NB_FRAMES);
+        scene.commit();
+        CHECK_EQ(handler->getCurrentFrame(), frame % NB_FRAMES);
+    }
+
+    // Without playback, the handler alternates between its current frame and
+    // a single load buffer, which get one data each
+    CHECK(ospModel.simulationData());
+    CHECK_EQ(ospModel.getSimulationDataCount(), 2);
+}
@@ -0,0 +1,127 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/common/simulation/AbstractSimulationHandler.h>
+
+#include <set>
+#include <thread>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+namespace
+{
+const uint32_t NB_FRAMES = 10;
+const uint64_t FRAME_SIZE = 3;
+
+class TestSimulationHandler : public brayns::AbstractSimulationHandler
+{
+public:
+    TestSimulationHandler(const std::chrono::milliseconds loadTime = {})
+    {
+        _nbFrames = NB_FRAMES;
+        _frameSize = FRAME_SIZE;
+        _setFrameLoader([loadTime](const uint32_t frame,
+                                   brayns::floats& buffer) {
+            std::this_thread::sleep_for(loadTime);
+            CHECK_EQ(buffer.size(), FRAME_SIZE);
+            std::fill(buffer.begin(), buffer.end(), float(frame));
+        });
+    }
+
+    brayns::AbstractSimulationHandlerPtr clone() const final
+    {
+        return std::make_shared<TestSimulationHandler>(*this);
+    }
+
+    void* getFrameData(const uint32_t frame) final
+    {
+        return _getPrefetchedFrameData(_getBoundedFrame(frame), true);
+    }
+
+    void waitPrefetchedFrames() const { _waitPrefetchedFrames(); }
+};
+
+float firstValue(void* data)
+{
+    return static_cast<float*>(data)[0];
+}
+}
+
+TEST_CASE("load_without_prefetching")
+{
+    TestSimulationHandler handler;
+    for (uint32_t frame = 0; frame < 3; ++frame)
+        CHECK_EQ(firstValue(handler.getFrameData(frame)), float(frame));
+    CHECK_EQ(handler.getPrefetchHits(), 0);
+    CHECK_EQ(handler.getPrefetchMisses(), 3);
+}
+
+TEST_CASE("prefetch_forward")
+{
+    TestSimulationHandler handler;
+    handler.setPrefetchWindow(3, 1);
+    for (uint32_t frame = 0; frame < 2 * NB_FRAMES; ++frame)
+    {
+        CHECK_EQ(firstValue(handler.getFrameData(frame)),
+                 float(frame % NB_FRAMES));
+        handler.waitPrefetchedFrames();
+    }
+    CHECK_EQ(handler.getPrefetchMisses(), 1);
+    CHECK_EQ(handler.getPrefetchHits(), 2 * NB_FRAMES - 1);
+}
+
+TEST_CASE("prefetch_backward")
+{
+    TestSimulationHandler handler;
+    handler.setPrefetchWindow(2, -2);
+    for (uint32_t frame = 8;; frame -= 2)
+    {
+        CHECK_EQ(firstValue(handler.getFrameData(frame)), float(frame));
+        if (frame == 0)
+            break;
+        handler.waitPrefetchedFrames();
+    }
+    CHECK_EQ(handler.getPrefetchMisses(), 1);
+    CHECK_EQ(handler.getPrefetchHits(), 4);
+}
+
+TEST_CASE("prefetch_reuses_buffers")
+{
+    const uint32_t window = 3;
+    TestSimulationHandler handler;
+    handler.setPrefetchWindow(window, 1);
+    std::set<void*> buffers;
+    for (uint32_t frame = 0; frame < 3 * NB_FRAMES; ++frame)
+    {
+        buffers.insert(handler.getFrameData(frame));
+        handler.waitPrefetchedFrames();
+    }
+    // The current frame and the prefetch ring
+    CHECK_LE(buffers.size(), window + 2);
+}
+
+TEST_CASE("destroy_while_prefetching")
+{
+    TestSimulationHandler handler(std::chrono::milliseconds(50));
+    handler.setPrefetchWindow(4, 1);
+    CHECK_EQ(firstValue(handler.getFrameData(0)), 0.f);
+    auto clone = handler.clone();
+    CHECK_EQ(firstValue(clone->getFrameData(5)), 5.f);
+    // the pending loads of both handlers are waited for on destruction
+}
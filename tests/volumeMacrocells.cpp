@@ -0,0 +1,95 @@
+/* Copyright (c) 2019, EPFL/Blue Brain Project
+ *
+ * This file is part of Brayns <https://github.com/BlueBrain/Brayns>
+ *
+ * This library is free software; you can redistribute it and/or modify it under
+ * the terms of the GNU Lesser General Public License version 3.0 as published
+ * by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <brayns/engine/Volume.h>
+
+#include <algorithm>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+namespace
+{
+class TestVolume : public brayns::Volume
+{
+public:
+    TestVolume(const brayns::Vector3ui& dimensions)
+        : Volume(dimensions, {1.f, 1.f, 1.f}, brayns::DataType::UINT8)
+    {
+    }
+
+    void setDataRange(const brayns::Vector2f&) final {}
+    void commit() final {}
+
+    void setBrick(const brayns::uint8_ts& voxels,
+                  const brayns::Vector3ui& position,
+                  const brayns::Vector3ui& size)
+    {
+        _updateMacrocellRanges(voxels.data(), position, size);
+    }
+};
+
+// Transparent below 128, opaque from 128
+brayns::floats stepOpacities()
+{
+    brayns::floats opacities(256, 0.f);
+    std::fill(opacities.begin() + 128, opacities.end(), 1.f);
+    return opacities;
+}
+
+const brayns::Vector2d VALUE_RANGE{0., 255.};
+} // namespace
+
+TEST_CASE("macrocell_opacities")
+{
+    // Three macrocells along x, only the last one has opaque values
+    TestVolume volume({48, 16, 16});
+    CHECK(volume.getMacrocellDimensions() == brayns::Vector3ui(3, 1, 1));
+    CHECK(volume.getMacrocellSize() == brayns::Vector3f(16.f, 16.f, 16.f));
+
+    volume.updateMacrocellOpacities(stepOpacities(), VALUE_RANGE);
+    CHECK(volume.getMacrocellOpacities().empty());
+
+    volume.setBrick(brayns::uint8_ts(32 * 16 * 16, 10), {0, 0, 0},
+                    {32, 16, 16});
+    CHECK(volume.hasNewMacrocellRanges());
+    volume.updateMacrocellOpacities(stepOpacities(), VALUE_RANGE);
+    CHECK(!volume.hasNewMacrocellRanges());
+
+    // The last macrocell has no voxels yet, so its neighbour stays opaque
+    auto opacities = volume.getMacrocellOpacities();
+    REQUIRE_EQ(opacities.size(), 3);
+    CHECK_EQ(opacities[0], 0.f);
+    CHECK_EQ(opacities[1], 1.f);
+    CHECK_EQ(opacities[2], 1.f);
+
+    volume.setBrick(brayns::uint8_ts(16 * 16 * 16, 200), {32, 0, 0},
+                    {16, 16, 16});
+    volume.updateMacrocellOpacities(stepOpacities(), VALUE_RANGE);
+    opacities = volume.getMacrocellOpacities();
+    CHECK_EQ(opacities[0], 0.f);
+    CHECK_EQ(opacities[1], 1.f);
+    CHECK_EQ(opacities[2], 1.f);
+
+    // Fully transparent transfer function
+    volume.updateMacrocellOpacities(brayns::floats(256, 0.f), VALUE_RANGE);
+    opacities = volume.getMacrocellOpacities();
+    CHECK_EQ(opacities[0], 0.f);
+    CHECK_EQ(opacities[1], 0.f);
+    CHECK_EQ(opacities[2], 0.f);
+}